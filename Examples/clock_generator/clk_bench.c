@@ -0,0 +1,84 @@
+/*!
+  \brief clock_generator 在 CPU 上執行的部分的週期數 (common/bench)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  - ssc_build_table：每次 clk_sys 改變都要重新建展頻的週期表 (三角波、虛擬亂數)
+  - clock_notify_retune：指令列 set clk 的路徑 (等 TX FIFO、停狀態機、重設分頻、恢復)
+  - clock_notify_set_sys_khz：同一個頻率重新鎖定 PLL，並呼叫 PIO 狀態機、PWM slice、UART 的通知
+
+  pio_blink 與 hello_pwm 執行時 CPU 不做事 (閃爍與 PWM 都是硬體)，
+  唯一在 CPU 上的是系統主頻改變時的 clock_notify，跟這裡的 PIO / PWM 項目是同一段程式，所以不另外做 bench。
+
+  \note 變更 clk_sys 的期間 CPU 暫時跑在 clk_ref，這一項的週期數只適合前後版本比較，不能直接換算成時間
+ */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+#include "bench.h"
+#include "clock_notify.h"
+#include "clk_gen.pio.h"
+#include "ssc_table.h"
+
+#define CLK_FREQ        4000000
+#define SYS_KHZ         150000
+#define TABLE_LEN       1024
+#define ITERS           101
+#define CLOCK_ITERS     11      //<! PLL 每次重新鎖定大約 1 ms
+
+static uint32_t table[TABLE_LEN];
+static int clk_notify_id = -1;
+
+static const ssc_config_t ssc_triangle = {.carrier_hz = CLK_FREQ, .depth = 0.02f, .rate_hz = 8000, .profile = SSC_TRIANGLE};
+static const ssc_config_t ssc_random = {.carrier_hz = CLK_FREQ, .depth = 0.02f, .rate_hz = 8000, .profile = SSC_RANDOM};
+
+static void bench_ssc_table(void *ctx)
+{
+    ssc_build_table(table, TABLE_LEN, ctx, SYS_KHZ * 1000.0, NULL);
+}
+
+static void bench_retune(void *ctx)
+{
+    clock_notify_retune(clk_notify_id, CLK_FREQ * 2.f);
+}
+
+static void bench_set_sys(void *ctx)
+{
+    clock_notify_set_sys_khz(SYS_KHZ);
+}
+
+static const bench_case_t cases[] = {
+        BENCH_CASE("ssc_build_table_triangle", bench_ssc_table, (void *) &ssc_triangle),
+        BENCH_CASE("ssc_build_table_random", bench_ssc_table, (void *) &ssc_random),
+        BENCH_CASE("clock_notify_retune_pio", bench_retune, NULL),
+        BENCH_CASE_IRQS_ON("clock_notify_set_sys_khz", bench_set_sys, NULL, CLOCK_ITERS),
+};
+
+int main()
+{
+    stdio_init_all();
+    set_sys_clock_khz(SYS_KHZ, true);
+    sleep_ms(2000);     // 等 USB 序列埠連上
+
+    // 跟 clock_generator 一樣的狀態機 (不接腳位)，加上一個 PWM slice (hello_pwm 的路徑)
+    PIO pio = pio0;
+    uint sm = pio_claim_unused_sm(pio, true);
+    uint offset = pio_add_program(pio, &clk_gen_program);
+    pio_sm_config c = clk_gen_program_get_default_config(offset);
+    pio_sm_init(pio, sm, offset, &c);
+    pio_sm_set_enabled(pio, sm, true);
+    clk_notify_id = clock_notify_pio_sm(pio, sm, CLK_FREQ * 2.f);
+    hard_assert(clk_notify_id >= 0);
+
+    pwm_config pc = pwm_get_default_config();
+    pwm_init(0, &pc, true);
+    clock_notify_pwm_slice(0, 1000000.f);
+    clock_notify_uart(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+
+    while (1) {
+        bench_run_all("clock_generator", cases, count_of(cases), ITERS);
+        sleep_ms(5000);
+    }
+}
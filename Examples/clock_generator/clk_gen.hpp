@@ -0,0 +1,57 @@
+/*!
+  \brief clk_gen.pio 的 C++ 包裝：輸出腳位與頻率是模板參數，分頻在編譯時算好
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+    clk_gen<PIN_CLK, CLK_FREQ> gen;     // 跟 main.c 的 init_pio() 一樣
+    gen.init(pio, sm, offset);
+
+  每個輸出週期是 2 個狀態機週期 (nop side 0 / nop side 1)，所以狀態機要跑在 2 倍頻率。
+  Exact 為 true 時，分頻不是整數會編譯失敗 (小數分頻的輸出會有 1 個 clk_sys 的抖動)。
+
+  \note 系統主頻預設是 SYS_CLK_HZ；main.c 會輪流改主頻並由 clock_notify 重算分頻，所以仍用 C 的版本
+ */
+#pragma once
+
+#include "pio_clkdiv.hpp"
+#include "hardware/pio.h"
+#include "clk_gen.pio.h"
+
+template <uint Pin, uint32_t OutHz, bool Exact = false, uint32_t SysHz = SYS_CLK_HZ>
+class clk_gen {
+    static_assert(Pin < NUM_BANK0_GPIOS, "no such GPIO");
+    static_assert((uint64_t) OutHz * 2 <= SysHz, "output cannot exceed clk_sys / 2");
+
+public:
+    using div = pio_clkdiv<SysHz, (uint64_t) OutHz * 2>;
+    static_assert(!Exact || SysHz % (OutHz * 2) == 0, "clk_sys / (2 * OutHz) is not an integer divider");
+
+    //! 實際輸出頻率
+    static constexpr double actual_hz = div::actual_hz / 2;
+
+    //! 設定並啟動狀態機 (程式已經用 pio_add_program() 載入到 offset，狀態機已經 claim)
+    void init(PIO p, uint state_machine, uint offset)
+    {
+        pio_assert_sys_hz<SysHz>();
+        pio = p;
+        sm = state_machine;
+
+        pio_gpio_init(pio, Pin);
+        pio_sm_config c = clk_gen_program_get_default_config(offset);
+        sm_config_set_sideset_pins(&c, Pin);
+        sm_config_set_clkdiv_int_frac8(&c, div::int_part, div::frac_part);
+        pio_sm_set_consecutive_pindirs(pio, sm, Pin, 1, true);
+        pio_sm_init(pio, sm, offset, &c);
+        pio_sm_set_enabled(pio, sm, true);
+    }
+
+    //! 暫停 / 恢復輸出 (腳位停在目前的電位)
+    void enable(bool on) const
+    {
+        pio_sm_set_enabled(pio, sm, on);
+    }
+
+private:
+    PIO pio = nullptr;
+    uint sm = 0;
+};
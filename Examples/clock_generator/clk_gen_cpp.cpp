@@ -0,0 +1,34 @@
+/*!
+  \brief main.c 的 C++ 版本：用 clk_gen.hpp 在編譯時決定輸出腳位與頻率
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  只輸出固定頻率 (不含指令列、展頻與自我測試)。
+  CLK_FREQ 改成 150 MHz / 2 以上，或 Exact 為 true 時改成 40 MHz，編譯時就會失敗。
+ */
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "clk_gen.hpp"
+
+#define PIN_CLK     18              //<! 時脈輸出，跟 main.c 一樣
+#define CLK_FREQ    25000000        //<! 150 MHz / 6，整數分頻，沒有抖動
+
+static clk_gen<PIN_CLK, CLK_FREQ, true> gen;
+
+int main()
+{
+    stdio_init_all();
+
+    PIO pio = pio0;
+    uint sm = pio_claim_unused_sm(pio, true);
+    uint offset = pio_add_program(pio, &clk_gen_program);
+    gpio_set_slew_rate(PIN_CLK, GPIO_SLEW_RATE_FAST);
+    gen.init(pio, sm, offset);
+
+    printf("輸出 %.0f Hz，分頻 %u\n", decltype(gen)::actual_hz, (uint) decltype(gen)::div::int_part);
+
+    while (true) tight_loop_contents();
+}
@@ -0,0 +1,123 @@
+/*!
+  \brief 頻率、責任週期與週期抖動量測
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <math.h>
+
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "freq_counter.h"
+#include "freq_counter.pio.h"
+
+static PIO pio;
+static uint sm;
+static uint offset;
+static int dma_chan = -1;
+
+//! 上升緣、下降緣交錯的時間戳，最後多一個上升緣
+static uint32_t stamps[2 * FREQ_COUNTER_MAX_PERIODS + 1];
+
+bool freq_counter_init(void)
+{
+    if (!pio_claim_free_sm_and_add_program(&freq_counter_program, &pio, &sm, &offset)) return false;
+    dma_chan = dma_claim_unused_channel(false);
+    return dma_chan >= 0;
+}
+
+bool freq_counter_measure(uint pin, uint periods, uint32_t timeout_us, freq_measure_t *m)
+{
+    if (dma_chan < 0 || periods < 1) return false;
+    if (periods > FREQ_COUNTER_MAX_PERIODS) periods = FREQ_COUNTER_MAX_PERIODS;
+    uint words = 2 * periods + 1;
+
+    // 只讀取腳位，不改變腳位的功能，所以也能量別的周邊正在輸出的腳位
+    pio_sm_config c = freq_counter_program_get_default_config(offset);
+    sm_config_set_in_pins(&c, pin);
+    sm_config_set_jmp_pin(&c, pin);
+    sm_config_set_in_shift(&c, false, true, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+    sm_config_set_clkdiv(&c, 1.f);
+    pio_sm_init(pio, sm, offset, &c);
+    pio_sm_exec(pio, sm, pio_encode_mov_not(pio_x, pio_null));
+
+    dma_channel_config dc = dma_channel_get_default_config(dma_chan);
+    channel_config_set_read_increment(&dc, false);
+    channel_config_set_write_increment(&dc, true);
+    channel_config_set_dreq(&dc, pio_get_dreq(pio, sm, false));
+    dma_channel_configure(dma_chan, &dc, stamps, &pio->rxf[sm], words, true);
+    pio_sm_set_enabled(pio, sm, true);
+
+    absolute_time_t until = make_timeout_time_us(timeout_us);
+    while (dma_channel_is_busy(dma_chan) && !time_reached(until)) {
+        tight_loop_contents();
+    }
+    pio_sm_set_enabled(pio, sm, false);
+    if (dma_channel_is_busy(dma_chan)) {
+        dma_channel_abort(dma_chan);
+        return false;
+    }
+
+    // x 往下數，時間戳越後面越小；每格 2 個週期，每個邊緣佔一格但 x 不變
+    double cycle_ns = 1e9 / clock_get_hz(clk_sys);
+    uint64_t total = 0, high = 0;
+    uint32_t min = UINT32_MAX, max = 0;
+    double sum_sq = 0;
+    for (uint k = 0; k < periods; k++) {
+        uint32_t rise = stamps[2 * k], fall = stamps[2 * k + 1], next = stamps[2 * k + 2];
+        uint32_t period = 2 * (rise - next + 2);
+        high += 2 * (rise - fall + 1);
+        total += period;
+        if (period < min) min = period;
+        if (period > max) max = period;
+        sum_sq += (double) period * period;
+    }
+
+    double mean = (double) total / periods;
+    m->periods = periods;
+    m->freq_hz = 1e9 / (mean * cycle_ns);
+    m->duty = (double) high / total;
+    m->period_ns_min = min * cycle_ns;
+    m->period_ns_max = max * cycle_ns;
+    double var = sum_sq / periods - mean * mean;
+    m->jitter_ns_rms = var > 0 ? sqrt(var) * cycle_ns : 0;
+    m->resolution_ns = 2 * cycle_ns;
+    return true;
+}
+
+bool freq_gate_measure(uint pin, uint32_t gate_us, double *hz)
+{
+    if (pwm_gpio_to_channel(pin) != PWM_CHAN_B) return false;
+    uint slice = pwm_gpio_to_slice_num(pin);
+
+    // B 腳位的上升緣當作計數器的時鐘
+    pwm_config c = pwm_get_default_config();
+    pwm_config_set_clkdiv_mode(&c, PWM_DIV_B_RISING);
+    pwm_config_set_clkdiv(&c, 1.f);
+    pwm_init(slice, &c, false);
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    pwm_set_counter(slice, 0);
+
+    // 計數器只有 16 bits，閘門期間一直讀取並累加差值；關中斷讓閘門的開始與結束時間一致
+    uint32_t saved = save_and_disable_interrupts();
+    uint64_t t0 = time_us_64();
+    while (time_us_64() == t0) {
+    }
+    t0++;
+    pwm_set_enabled(slice, true);
+    uint64_t count = 0;
+    uint16_t last = 0;
+    while (time_us_64() - t0 < gate_us) {
+        uint16_t now = (uint16_t) pwm_get_counter(slice);
+        count += (uint16_t) (now - last);
+        last = now;
+    }
+    pwm_set_enabled(slice, false);
+    count += (uint16_t) ((uint16_t) pwm_get_counter(slice) - last);
+    restore_interrupts(saved);
+
+    *hz = count * 1e6 / gate_us;
+    return true;
+}
@@ -0,0 +1,45 @@
+/*!
+  \brief 頻率、責任週期與週期抖動量測
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  兩種方法：
+  - freq_counter_measure()：PIO 倒數計數法 (reciprocal counting)，
+    記錄每個上升緣與下降緣的時間 (解析度 2 個 clk_sys 週期)，可以量任何 GPIO，
+    包含 PIO 自己正在輸出的腳位，不需要跳線。頻率以 clk_sys 為基準。
+  - freq_gate_measure()：PWM slice 閘門計數法，在 gate_us 內數上升緣，
+    只能用 PWM B 通道的腳位 (奇數 GPIO)，以 timer (XOSC) 為基準。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#define FREQ_COUNTER_MAX_PERIODS    1024    //<! 一次最多量幾個週期
+
+//! 量測結果
+typedef struct {
+    uint32_t periods;           //<! 量到的完整週期數
+    double freq_hz;             //<! 平均頻率
+    double duty;                //<! 高準位比例 0 ~ 1
+    double period_ns_min;
+    double period_ns_max;
+    double jitter_ns_rms;       //<! 週期的標準差
+    double resolution_ns;       //<! 單一週期的解析度 (2 個 clk_sys 週期)
+} freq_measure_t;
+
+//! 載入 PIO 程式，取得一個狀態機與一個 DMA 通道
+bool freq_counter_init(void);
+
+/*! 用 PIO 量測 pin 上 periods 個完整週期
+  \param timeout_us 訊號太慢或沒有訊號時最多等多久
+  \return 逾時回傳 false
+  \note 每個半週期至少要 2 個 clk_sys 週期 (150 MHz 時 50% duty 最高約 37 MHz)
+ */
+bool freq_counter_measure(uint pin, uint periods, uint32_t timeout_us, freq_measure_t *m);
+
+/*! 用 PWM slice 在 gate_us 內數上升緣
+  \param pin 必須是 PWM B 通道 (奇數 GPIO)，會被設定成 PWM 功能
+  \return pin 不是 B 通道時回傳 false
+ */
+bool freq_gate_measure(uint pin, uint32_t gate_us, double *hz);
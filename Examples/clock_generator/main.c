@@ -3,18 +3,44 @@
   \author kalvinchiang@gmail.com
   \date 2026-01-31
  */
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "clk_gen.pio.h"
+#include "clock_notify.h"
+#include "freq_counter.h"
+#include "shell.h"
+#include "ssc_gen.h"
 
 #define PIN_CLK     18
+#define PIN_LOOP    19          //<! PWM 閘門計數的輸入 (PWM 1B)，用跳線接到 PIN_CLK
 #define CLK_FREQ    4000000
+#define TEST_PERIODS    512     //<! 每次自我測試量幾個週期
+#define TEST_GATE_US    10000   //<! PWM 閘門時間，解析度 100 Hz
+#define TEST_TOLERANCE_PPM  1000
+
+// 展頻輸出 (降低 EMI 尖峰)，1 的時候改用 ssc_gen，自我測試的抖動就是展頻的效果
+#ifndef CLK_MODE_SSC
+#define CLK_MODE_SSC    0
+#endif
+#define SSC_DEPTH       0.02f           //<! 峰對峰 2% (±1%)
+#define SSC_RATE_HZ     8000            //<! 調變頻率，4 MHz 的載波要比 40 kHz 的偏移量低很多才有效
+#define SSC_PROFILE     SSC_TRIANGLE
+
+//! 輪流切換的系統主頻 (kHz)，輸出的頻率應該一直維持 CLK_FREQ
+//! 144 MHz 的分頻是整數 (18)，週期抖動應該是 0
+static const uint32_t sys_khz[] = {150000, 144000, 96000, 48000};
 
 PIO pio = pio0;     //<! PIO 模組 0
 uint clk_sm = 0;    //<! PIO CLK 狀態機
 
+// 指令列可以調整的參數，開機時是上面的 #define
+static uint clk_freq = CLK_FREQ;
+static uint cycle_s = 0;    //<! 幾秒切換一次系統主頻，0 表示不切換 (用 set cycle 開始)
+
 void init_gpio()
 {
     // -----------------------------------------------------------------------------
@@ -41,6 +67,9 @@ void init_pio(uint pin_clk, float div)
 {
     pio_gpio_init(pio, pin_clk);
 
+    // 宣告使用這個狀態機，頻率計數器才不會拿到同一個
+    pio_sm_claim(pio, clk_sm);
+
     // 載入 PIO 程式
     uint offset = pio_add_program(pio, &clk_gen_program);
 
@@ -63,12 +92,128 @@ void init_pio(uint pin_clk, float div)
     pio_sm_set_enabled(pio, clk_sm, true);
 }
 
+/*!
+  \brief 量測 PIN_CLK 的實際輸出，跟 clk_freq 比較
+  PIO 計數器直接讀 PIN_CLK，不需要跳線；PWM 閘門計數需要把 PIN_CLK 接到 PIN_LOOP
+ */
+void self_test()
+{
+    freq_measure_t m;
+    if (!freq_counter_measure(PIN_CLK, TEST_PERIODS, 10000, &m)) {
+        printf("自我測試: PIN_CLK 沒有訊號 FAIL\n");
+        return;
+    }
+    double ppm = (m.freq_hz - clk_freq) / clk_freq * 1e6;
+    printf("自我測試 (PIO, %u 個週期): %.3f Hz, 誤差 %.1f ppm, duty %.2f%% %s\n",
+           (uint) m.periods, m.freq_hz, ppm, m.duty * 100, fabs(ppm) <= TEST_TOLERANCE_PPM ? "PASS" : "FAIL");
+    printf("  週期 %.2f ~ %.2f ns, 抖動 %.2f ns rms (解析度 %.2f ns)\n",
+           m.period_ns_min, m.period_ns_max, m.jitter_ns_rms, m.resolution_ns);
+
+    double hz;
+    if (freq_gate_measure(PIN_LOOP, TEST_GATE_US, &hz) && hz > 0) {
+        printf("  PWM 閘門計數 (GPIO %d): %.0f Hz\n", PIN_LOOP, hz);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// 指令列
+// -----------------------------------------------------------------------------
+
+#if CLK_MODE_SSC
+static float ssc_depth = SSC_DEPTH;
+static float ssc_rate = SSC_RATE_HZ;
+static ssc_config_t ssc_running;    //<! 目前輸出的設定，新的設定無法達成時恢復
+
+//! 頻率、深度、調變頻率改變都要重新產生週期表
+static bool apply_ssc(const shell_param_t *p)
+{
+    ssc_config_t ssc = {.carrier_hz = clk_freq, .depth = ssc_depth, .rate_hz = ssc_rate, .profile = SSC_PROFILE};
+    ssc_gen_stop();
+    if (ssc_gen_start(PIN_CLK, &ssc)) {
+        ssc_running = ssc;
+        return true;
+    }
+    hard_assert(ssc_gen_start(PIN_CLK, &ssc_running));
+    return false;
+}
+
+static const shell_param_t params[] = {
+        SHELL_PARAM("clk",   clk_freq,  1000, 20000000, apply_ssc, "載波頻率 (Hz)"),
+        SHELL_PARAM("depth", ssc_depth, 0, 0.1f,        apply_ssc, "峰對峰展頻深度 (0.02 = 2%)"),
+        SHELL_PARAM("rate",  ssc_rate,  100, 100000,    apply_ssc, "調變頻率 (Hz)"),
+        SHELL_PARAM("cycle", cycle_s,   0, 3600,        NULL,      "幾秒切換一次系統主頻，0 不切換"),
+};
+#else
+static int clk_notify_id = -1;
+
+//! sys_khz[] 裡最低的系統主頻 (Hz)
+static uint32_t sys_hz_min(void)
+{
+    uint32_t khz = sys_khz[0];
+    for (uint i = 1; i < count_of(sys_khz); i++) khz = MIN(khz, sys_khz[i]);
+    return khz * 1000;
+}
+
+//! 改變 clock_notify 維持的頻率，立即用新的頻率重新計算分頻
+static bool apply_clk(const shell_param_t *p)
+{
+    // 每個週期 2 個 PIO 指令，分頻最小是 1；輪流切換的每一個主頻都要做得到，不是只看現在的
+    if (clk_freq * 2 > sys_hz_min()) {
+        printf("最高 %u Hz (最低的系統主頻 %u kHz / 2)\n", (uint) (sys_hz_min() / 2), (uint) (sys_hz_min() / 1000));
+        return false;
+    }
+    return clock_notify_retune(clk_notify_id, clk_freq * 2.f) == PICO_OK;
+}
+
+static const shell_param_t params[] = {
+        SHELL_PARAM("clk",   clk_freq, 1000, 75000000, apply_clk, "輸出頻率 (Hz)，最高 sys_khz[] 最低的主頻 / 2"),
+        SHELL_PARAM("cycle", cycle_s,  0, 3600,        NULL,      "幾秒切換一次系統主頻，0 不切換"),
+};
+#endif
+
+static int cmd_selftest(int argc, char **argv)
+{
+    self_test();
+    return 0;
+}
+
+static int cmd_sys(int argc, char **argv)
+{
+    if (argc == 2 && !clock_notify_set_sys_khz((uint32_t) atoi(argv[1]))) {
+        printf("無法設定 %s kHz\n", argv[1]);
+        return 1;
+    }
+    printf("clk_sys %u kHz\n", (uint) (clock_get_hz(clk_sys) / 1000));
+#if !CLK_MODE_SSC
+    // 手動設定的主頻可能比 sys_khz[] 都低，分頻被限制在 1，輸出不是 clk_freq
+    if (clk_freq * 2 > clock_get_hz(clk_sys)) {
+        printf("輸出只能到 %u Hz，不是 %u Hz\n", (uint) (clock_get_hz(clk_sys) / 2), clk_freq);
+    }
+#endif
+    return 0;
+}
+
+static const shell_cmd_t cmds[] = {
+        {"selftest", cmd_selftest, "量測輸出的頻率與抖動"},
+        {"sys",      cmd_sys,      "[kHz] 顯示 / 設定系統主頻 (建議先 set cycle 0)"},
+};
+
 int main()
 {
     stdio_init_all();
 
     init_gpio();
 
+#if CLK_MODE_SSC
+    ssc_config_t ssc = {.carrier_hz = CLK_FREQ, .depth = SSC_DEPTH, .rate_hz = SSC_RATE_HZ, .profile = SSC_PROFILE};
+    hard_assert(ssc_gen_start(PIN_CLK, &ssc));
+    ssc_running = ssc;
+    printf("\n展頻輸出: %d MHz, 深度 %.2f%%, 調變頻率 %.0f Hz\n",
+           CLK_FREQ / 1000000, SSC_DEPTH * 100, ssc_gen_rate_hz());
+    hard_assert(freq_counter_init());
+    self_test();
+    clock_notify_uart(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+#else
     // 計算分頻
     // 假設產生 20 MHz clock, 每個週期 2 個 PIO 指令
     // 需要 PIO 跑在 40 MHz
@@ -85,5 +230,29 @@ int main()
     printf("目標頻率: %d MHz\n", CLK_FREQ / 1000000);
     printf("PIO 狀態機分頻值: %.4f\n", div);
 
-    while(1);
+    hard_assert(freq_counter_init());
+    self_test();
+
+    // 系統主頻改變時，狀態機的分頻與 UART 的 baudrate 自動重新計算
+    clk_notify_id = clock_notify_pio_sm(pio, clk_sm, CLK_FREQ * 2);
+    clock_notify_uart(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+#endif
+
+    shell_init("PIO 頻率產生測試", params, count_of(params), cmds, count_of(cmds));
+    absolute_time_t next = make_timeout_time_ms(cycle_s * 1000);
+    for (uint i = 1; ; ) {
+        shell_poll();
+        sleep_ms(10);
+        if (!cycle_s || !time_reached(next)) continue;
+        next = make_timeout_time_ms(cycle_s * 1000);
+        uint32_t khz = sys_khz[i++ % count_of(sys_khz)];
+        if (!clock_notify_set_sys_khz(khz)) continue;
+        printf("\n系統主頻: %d MHz\n", clock_get_hz(clk_sys) / 1000000);
+#if CLK_MODE_SSC
+        printf("調變頻率: %.0f Hz\n", ssc_gen_rate_hz());
+#else
+        printf("PIO 狀態機分頻值: %.4f\n", (float)clock_get_hz(clk_sys) / (clk_freq * 2));
+#endif
+        self_test();
+    }
 }
@@ -0,0 +1,147 @@
+/*!
+  \brief 展頻時鐘輸出
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "clock_notify.h"
+#include "ssc_gen.h"
+#include "ssc_gen.pio.h"
+
+#define TABLE_BYTES (SSC_TABLE_MAX * 4)
+
+// RP2350 的 DMA 有 ENDLESS 模式 (TRANS_COUNT 的 MODE = 0xf)，資料通道自己一直跑，不需要控制通道
+#if PICO_RP2350
+#define SSC_DMA_ENDLESS 1
+#else
+#define SSC_DMA_ENDLESS 0
+#endif
+
+static uint32_t table[SSC_TABLE_MAX] __attribute__((aligned(TABLE_BYTES)));
+static uint32_t table_len;
+static double rate_hz;
+
+static ssc_config_t config;
+static PIO pio;
+static uint sm;
+static uint offset;
+static uint pin_out;
+static int data_chan = -1;
+static int ctrl_chan = -1;
+static int notify_id = -1;
+
+#if !SSC_DMA_ENDLESS
+//! 控制通道每次寫回資料通道的傳輸次數
+static uint32_t reload_count;
+#endif
+
+static uint log2_u32(uint32_t v)
+{
+    uint n = 0;
+    while (v > 1) {
+        v >>= 1;
+        n++;
+    }
+    return n;
+}
+
+//! 依目前的 clk_sys 建表並啟動 DMA 與狀態機
+static bool run(void)
+{
+    table_len = ssc_build_table(table, SSC_TABLE_MAX, &config, clock_get_hz(clk_sys), &rate_hz);
+    if (!table_len) return false;
+
+    pio_sm_config c = ssc_gen_program_get_default_config(offset);
+    sm_config_set_sideset_pins(&c, pin_out);
+    sm_config_set_out_shift(&c, true, true, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    sm_config_set_clkdiv(&c, 1.f);      // 用 clk_sys 的全部解析度
+    pio_sm_init(pio, sm, offset, &c);
+
+    dma_channel_config dc = dma_channel_get_default_config(data_chan);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    // ring 讓讀取位址自己繞回表的開頭
+    channel_config_set_ring(&dc, false, log2_u32(table_len * 4));
+    channel_config_set_dreq(&dc, pio_get_dreq(pio, sm, true));
+#if SSC_DMA_ENDLESS
+    dma_channel_configure(data_chan, &dc, &pio->txf[sm], table, dma_encode_endless_transfer_count(), false);
+#else
+    // 一次傳整數圈的表，用完時控制通道寫回次數並重新觸發
+    reload_count = ssc_dma_reload_count(table_len);
+    channel_config_set_chain_to(&dc, ctrl_chan);
+    dma_channel_configure(data_chan, &dc, &pio->txf[sm], table, reload_count, false);
+
+    dma_channel_config cc = dma_channel_get_default_config(ctrl_chan);
+    channel_config_set_read_increment(&cc, false);
+    channel_config_set_write_increment(&cc, false);
+    dma_channel_configure(ctrl_chan, &cc, &dma_hw->ch[data_chan].al1_transfer_count_trig, &reload_count, 1, false);
+#endif
+
+    dma_channel_start(data_chan);
+    pio_sm_set_enabled(pio, sm, true);
+    return true;
+}
+
+static void halt(void)
+{
+    pio_sm_set_enabled(pio, sm, false);
+#if SSC_DMA_ENDLESS
+    dma_channel_abort(data_chan);
+#else
+    // 先停控制通道，資料通道就不會再被觸發
+    dma_channel_abort(ctrl_chan);
+    dma_channel_abort(data_chan);
+    dma_channel_abort(ctrl_chan);
+#endif
+    pio_sm_clear_fifos(pio, sm);
+    pio_sm_exec(pio, sm, pio_encode_nop() | pio_encode_sideset(1, 0));
+}
+
+static void clock_changed(clock_change_t change, uint32_t old_hz, uint32_t new_hz, void *ctx)
+{
+    if (change == CLOCK_CHANGE_PRE) halt();
+    else run();
+}
+
+bool ssc_gen_start(uint pin, const ssc_config_t *cfg)
+{
+    if (pio) ssc_gen_stop();
+    if (!pio_claim_free_sm_and_add_program_for_gpio_range(&ssc_gen_program, &pio, &sm, &offset, pin, 1, true)) {
+        pio = NULL;
+        return false;
+    }
+    data_chan = dma_claim_unused_channel(false);
+#if !SSC_DMA_ENDLESS
+    ctrl_chan = dma_claim_unused_channel(false);
+#endif
+    config = *cfg;
+    pin_out = pin;
+
+    pio_gpio_init(pio, pin);
+    pio_sm_set_consecutive_pindirs(pio, sm, pin, 1, true);
+    if (data_chan < 0 || (!SSC_DMA_ENDLESS && ctrl_chan < 0) || !run()) {
+        ssc_gen_stop();
+        return false;
+    }
+    notify_id = clock_notify_register(clock_changed, NULL);
+    return true;
+}
+
+void ssc_gen_stop(void)
+{
+    if (notify_id >= 0) clock_notify_unregister(notify_id);
+    notify_id = -1;
+    if (pio && data_chan >= 0 && (SSC_DMA_ENDLESS || ctrl_chan >= 0)) halt();
+    if (data_chan >= 0) dma_channel_unclaim(data_chan);
+    if (ctrl_chan >= 0) dma_channel_unclaim(ctrl_chan);
+    data_chan = ctrl_chan = -1;
+    if (pio) pio_remove_program_and_unclaim_sm(&ssc_gen_program, pio, sm, offset);
+    pio = NULL;
+}
+
+double ssc_gen_rate_hz(void)
+{
+    return rate_hz;
+}
@@ -0,0 +1,28 @@
+/*!
+  \brief 展頻時鐘輸出：PIO 狀態機 + DMA 循環播放週期表，CPU 不需要介入
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  資料通道以 ring 模式一直讀同一張表 (表格對齊到自己的大小)。
+  RP2350 用 DMA 的 ENDLESS 模式一直傳下去；RP2040 則是傳輸次數用完時串接到控制通道，
+  控制通道把次數寫回去並重新觸發資料通道。
+  系統主頻改變時 (clock_notify) 會自動重新計算週期表。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "ssc_table.h"
+
+#define SSC_TABLE_MAX   1024    //<! 週期表最多幾個 word (2 的次方)
+
+/*! 開始輸出
+  \return PIO、DMA 資源不足或設定無法達成時回傳 false
+ */
+bool ssc_gen_start(uint pin, const ssc_config_t *cfg);
+
+//! 停止輸出，釋放資源 (腳位維持低準位)
+void ssc_gen_stop(void);
+
+//! 目前實際的調變頻率
+double ssc_gen_rate_hz(void);
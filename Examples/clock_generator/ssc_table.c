@@ -0,0 +1,69 @@
+/*!
+  \brief 展頻時鐘的週期表
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <math.h>
+
+#include "ssc_table.h"
+
+//! xorshift32
+static uint32_t next_random(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+//! -1 ~ 1
+static double random_level(uint32_t *state)
+{
+    return (next_random(state) >> 8) / (double) (1u << 23) - 1.0;
+}
+
+uint32_t ssc_build_table(uint32_t *table, uint32_t max_len, const ssc_config_t *cfg, double pio_hz,
+                         double *actual_rate_hz)
+{
+    double nominal = pio_hz / cfg->carrier_hz;      // 平均週期 (PIO 週期，可能有小數)
+    double swing = nominal * cfg->depth / 2;
+    if (nominal - swing < 2 * SSC_HALF_OVERHEAD + 1 || nominal + swing > 2.0 * (0xffff + SSC_HALF_OVERHEAD)) return 0;
+
+    // 表格長度取最接近 carrier / rate 的 2 的次方
+    uint32_t len = 2;
+    double want = cfg->rate_hz > 0 ? cfg->carrier_hz / cfg->rate_hz : max_len;
+    while (len < max_len && len * 1.5 < want) len *= 2;
+
+    // 每個週期都取新的亂數時平均頻率幾乎不變，所以只取 SSC_RANDOM_POINTS 個點再內插
+    uint32_t seed = 0x2545f491;
+    uint32_t step = len > SSC_RANDOM_POINTS ? len / SSC_RANDOM_POINTS : 1;
+    double first = random_level(&seed), from = 0, to = 0;
+    double edge = 0;            // 理想的累積時間
+    uint64_t emitted = 0;       // 已經輸出的整數週期數
+    for (uint32_t i = 0; i < len; i++) {
+        double shape;
+        if (cfg->profile == SSC_TRIANGLE) {
+            // 0 -> 1 -> -1 -> 0，從中心開始
+            double p = (double) i / len;
+            shape = p < 0.25 ? 4 * p : p < 0.75 ? 2 - 4 * p : 4 * p - 4;
+        } else {
+            // 每段之間線性內插，最後一段接回第一個點，表格重複播放時才連續
+            uint32_t seg = i / step, pos = i % step;
+            if (pos == 0) {
+                from = seg ? to : first;
+                to = seg + 1 < len / step ? random_level(&seed) : first;
+            }
+            shape = from + (to - from) * pos / step;
+        }
+        // 頻率變化 ±depth/2，週期是倒數
+        edge += nominal / (1.0 + shape * cfg->depth / 2);
+        uint32_t period = (uint32_t) (llround(edge) - (int64_t) emitted);
+        emitted += period;
+
+        uint32_t high = period / 2, low = period - high;
+        table[i] = (high - SSC_HALF_OVERHEAD) | ((low - SSC_HALF_OVERHEAD) << 16);
+    }
+    if (actual_rate_hz) *actual_rate_hz = pio_hz / (double) emitted;
+    return len;
+}
@@ -0,0 +1,66 @@
+/*!
+  \brief 展頻時鐘 (spread spectrum) 的週期表
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  固定頻率的方波能量全部集中在基頻與奇次諧波上，EMI 量測時就是一根很高的尖峰。
+  讓週期跟著三角波 (或虛擬亂數) 在 ±depth/2 之間變化，能量就被攤到一段頻寬上。
+
+  表格的每一個 word 是一個完整週期，給 ssc_gen.pio 用：
+  低 16 bits 是高準位、高 16 bits 是低準位，單位是 PIO 週期，都已經減掉指令的固定開銷。
+  每個週期只能是整數個 PIO 週期，所以用累積誤差 (一階 sigma-delta) 讓平均週期跟著設定走。
+
+  不依賴 Pico SDK，電腦上的 host/ssc_spectrum 用同一份程式計算頻譜。
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define SSC_HALF_OVERHEAD   2   //<! ssc_gen.pio 每個半週期固定多 2 個 PIO 週期
+#define SSC_RANDOM_POINTS   16  //<! 虛擬亂數波形每圈幾個轉折點
+#define SSC_DMA_COUNT_MAX   0x0fffffffu //<! RP2350 的 TRANS_COUNT 只有低 28 bits 是次數，31:28 是 MODE
+
+//! 調變波形
+typedef enum {
+    SSC_TRIANGLE,       //<! 三角波，頻譜接近平坦
+    SSC_RANDOM,         //<! 虛擬亂數轉折點之間線性內插 (固定種子，表格重複播放)
+} ssc_profile_t;
+
+//! 展頻設定
+typedef struct {
+    float carrier_hz;       //<! 中心頻率
+    float depth;            //<! 頻率變化的峰對峰比例，0.01 表示 ±0.5%
+    float rate_hz;          //<! 調變頻率，要遠小於 carrier_hz * depth / 2 才壓得下尖峰；實際值會調整成表格長度是 2 的次方
+    ssc_profile_t profile;
+} ssc_config_t;
+
+/*! 建立週期表
+  \param table 輸出，長度是 2 的次方 (DMA ring 需要)
+  \param max_len table 的大小 (2 的次方)
+  \param pio_hz 狀態機的執行速度
+  \param actual_rate_hz 輸出實際的調變頻率，可以是 NULL
+  \return 表格長度，設定無法達成 (週期太短或太長) 時回傳 0
+ */
+uint32_t ssc_build_table(uint32_t *table, uint32_t max_len, const ssc_config_t *cfg, double pio_hz,
+                         double *actual_rate_hz);
+
+//! 表格的一個週期有幾個 PIO 週期
+static inline uint32_t ssc_period_cycles(uint32_t word)
+{
+    return (word & 0xffff) + (word >> 16) + 2 * SSC_HALF_OVERHEAD;
+}
+
+//! 表格的一個週期高準位有幾個 PIO 週期
+static inline uint32_t ssc_high_cycles(uint32_t word)
+{
+    return (word & 0xffff) + SSC_HALF_OVERHEAD;
+}
+
+/*! DMA 每次重新載入的傳輸次數：整數圈的表，且不超過 SSC_DMA_COUNT_MAX
+  \note len 是 2 的次方時 len * (0x10000000 / len) 剛好是 0x10000000，
+        在 RP2350 上會變成 MODE = TRIGGER_SELF、次數 0，DMA 根本不會送資料
+ */
+static inline uint32_t ssc_dma_reload_count(uint32_t len)
+{
+    return (SSC_DMA_COUNT_MAX / len) * len;
+}
@@ -0,0 +1,264 @@
+/*!
+  \brief ATMEL AT24C256 I2C EEPROM 驅動
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+
+#include "at24c256.h"
+
+static i2c_inst_t *eeprom_i2c;
+static uint8_t eeprom_address;
+
+// 非同步讀取
+static uint32_t async_cmd[2 + EEPROM_ASYNC_MAX];    //<! 2 bytes 位址 + 每個 byte 一個讀取命令
+static int async_tx_chan = -1;
+static int async_rx_chan = -1;
+static eeprom_async_state_t async_state = EEPROM_ASYNC_IDLE;
+static absolute_time_t async_deadline;
+
+void eeprom_init(i2c_inst_t *i2c, uint8_t address)
+{
+    eeprom_i2c = i2c;
+    eeprom_address = address;
+}
+
+void eeprom_wait_ready(void)
+{
+    uint8_t dummy;
+    int ret;
+    // 不斷嘗試讀取，直到收到 ACK (ret >= 0)
+    do
+    {
+        // 這裡單純用 write 測試 address 是否有 ACK
+        ret = i2c_write_blocking(eeprom_i2c, eeprom_address, &dummy, 1, false);
+        if (ret < 0) {
+            sleep_us(100); // 稍微等一下再試，避免佔用太多 Bus 頻寬
+        }
+    } while (ret < 0);
+}
+
+static void _eeprom_write_page_raw(uint16_t mem_addr, const uint8_t *data, size_t len)
+{
+    // 準備 I2C Buffer: 2 bytes Address + Data
+    uint8_t buf[EEPROM_PAGE_SIZE + 2];
+
+    buf[0] = (mem_addr >> 8) & 0xFF; // High Byte
+    buf[1] = mem_addr & 0xFF;        // Low Byte
+    memcpy(&buf[2], data, len);      // 複製數據
+
+    // 發送 (Address + Data)
+    i2c_write_blocking(eeprom_i2c, eeprom_address, buf, len + 2, false);
+
+    // 等待 EEPROM 寫入完成
+    eeprom_wait_ready();
+}
+
+void eeprom_write_buffer(uint16_t addr, const uint8_t *data, size_t len)
+{
+    size_t remaining_len = len;
+    size_t offset = 0;
+
+    while (remaining_len > 0)
+    {
+        // 計算這一頁還剩多少空間
+        // (例如 addr=60, 64 - (60%64) = 4 bytes)
+        size_t space_in_page = EEPROM_PAGE_SIZE - (addr % EEPROM_PAGE_SIZE);
+
+        // 這次要寫多少？取「剩餘資料長度」和「頁面剩餘空間」的最小值
+        size_t chunk_size = (remaining_len < space_in_page) ? remaining_len : space_in_page;
+
+        // 執行底層寫入
+        _eeprom_write_page_raw(addr, &data[offset], chunk_size);
+
+        // 更新指標與計數
+        addr += chunk_size;
+        offset += chunk_size;
+        remaining_len -= chunk_size;
+    }
+}
+
+int eeprom_read_buffer(uint16_t addr, uint8_t *buf, size_t len)
+{
+    // 先寫入要讀取的起始位址 (Dummy Write)
+    uint8_t reg_addr[2];
+    reg_addr[0] = (addr >> 8) & 0xFF;
+    reg_addr[1] = addr & 0xFF;
+
+    // nostop = true (Repeated Start)
+    if (i2c_write_blocking(eeprom_i2c, eeprom_address, reg_addr, 2, true) < 0) {
+        return PICO_ERROR_GENERIC;
+    }
+
+    // 一口氣讀取所有 bytes
+    // I2C controller 會自動處理 ACK/NACK
+    return i2c_read_blocking(eeprom_i2c, eeprom_address, buf, len, false);
+}
+
+/*! 寫入一個 Byte
+  \brief 特別注意：AT24C256 的「位址」是 16-bit 跟小的 EEPROM\n
+   (如 AT24C02) 不同，AT24C256 容量大，所以寫入數據時，需要發送 2 個\n
+    byte 的記憶體位址 (High Byte + Low Byte)。
+ */
+void eeprom_write_byte(uint16_t mem_addr, uint8_t data)
+{
+    uint8_t buf[3];
+
+    // AT24C256 需要 16-bit 記憶體位址(大端序)
+    // 假設 mem_addr = 0x1234 (16-bit)
+    // 高位元組 (High Byte/MSB) = 0x12
+    // 低位元組 (Low Byte/LSB)  = 0x34
+    // 發送順序： 先送 buf[0] (0x12)，再送 buf[1] (0x34)
+    // 意義：先送 高位 (High Byte)，後送低位 (Low Byte)。
+
+    // 大端序 (Big-Endian)：高位元組 (MSB) 存放在記憶體低位址，或是在通訊中先被發送。
+    // 就像我們寫阿拉伯數字 "1234"，先寫千位數 (1)，最後寫個位數 (4)。
+    // 小端序 (Little-Endian)： 低位元組 (LSB) 先被發送。
+
+    buf[0] = (mem_addr >> 8) & 0xFF; // 取出 0x12(High)，放入陣列第 0 格
+    buf[1] = mem_addr & 0xFF;        // 取出 0x34(Low)，放入陣列第 1 格
+    buf[2] = data;                   // Data
+
+    // 寫入數據
+    // 注意：nostop = false，表示傳完這 3 個 byte 後發送 STOP 訊號
+    // 這樣 EEPROM 才會開始內部的寫入週期
+    i2c_write_blocking(eeprom_i2c, eeprom_address, buf, 3, false);
+
+    // 【重要】EEPROM 寫入需要時間 (約 5ms)
+    // 如果不加這行，馬上讀取會失敗
+    eeprom_wait_ready();
+}
+
+/*! 讀取一個 Byte
+  \brief 特別注意：AT24C256 的「位址」是 16-bit 跟小的 EEPROM\n
+   (如 AT24C02) 不同，AT24C256 容量大，所以讀取數據時，需要先發送 2 個\n
+    byte 的記憶體位址 (High Byte + Low Byte)，然後再讀取數據。
+ */
+uint8_t eeprom_read_byte(uint16_t mem_addr)
+{
+    uint8_t reg_addr[2];
+    uint8_t rx_data = 0;
+
+    reg_addr[0] = (mem_addr >> 8) & 0xFF;
+    reg_addr[1] = mem_addr & 0xFF;
+
+    // 先寫入我們要讀的記憶體位址 (Dummy Write)
+    // nostop = true，表示先不放手，緊接著要讀取 (Repeated Start)
+    i2c_write_blocking(eeprom_i2c, eeprom_address, reg_addr, 2, true);
+
+    // 讀取數據
+    i2c_read_blocking(eeprom_i2c, eeprom_address, &rx_data, 1, false);
+
+    return rx_data;
+}
+
+void eeprom_update_byte(uint16_t addr, uint8_t new_val)
+{
+    uint8_t old_val = eeprom_read_byte(addr);
+    if (old_val != new_val) {
+        eeprom_write_byte(addr, new_val); // 只有變更時才寫，節省壽命
+    }
+}
+
+// -----------------------------------------------------------------------------
+// 非同步讀取 (DMA)
+// -----------------------------------------------------------------------------
+
+bool eeprom_read_async(uint16_t addr, uint8_t *buf, size_t len)
+{
+    if (async_state == EEPROM_ASYNC_BUSY || len == 0 || len > EEPROM_ASYNC_MAX) return false;
+
+    // 每次讀取才宣告通道，結束時 (async_release) 歸還
+    async_tx_chan = dma_claim_unused_channel(true);
+    async_rx_chan = dma_claim_unused_channel(true);
+
+    i2c_hw_t *hw = i2c_get_hw(eeprom_i2c);
+
+    // 跟 eeprom_read_buffer() 一樣是 dummy write + repeated start，
+    // 只是位址和讀取命令全部寫進 TX 命令佇列，由硬體自己送出
+    async_cmd[0] = (addr >> 8) & 0xFF;
+    async_cmd[1] = addr & 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        uint32_t cmd = I2C_IC_DATA_CMD_CMD_BITS;
+        if (i == 0) cmd |= I2C_IC_DATA_CMD_RESTART_BITS;
+        if (i == len - 1) cmd |= I2C_IC_DATA_CMD_STOP_BITS;
+        async_cmd[2 + i] = cmd;
+    }
+
+    // 目標位址只能在 I2C 關閉時修改
+    hw->enable = 0;
+    hw->tar = eeprom_address;
+    hw->enable = 1;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+    (void) hw->clr_tx_abrt;
+
+    dma_channel_config rx = dma_channel_get_default_config(async_rx_chan);
+    channel_config_set_transfer_data_size(&rx, DMA_SIZE_8);
+    channel_config_set_read_increment(&rx, false);
+    channel_config_set_write_increment(&rx, true);
+    channel_config_set_dreq(&rx, i2c_get_dreq(eeprom_i2c, false));
+    dma_channel_configure(async_rx_chan, &rx, buf, &hw->data_cmd, len, true);
+
+    dma_channel_config tx = dma_channel_get_default_config(async_tx_chan);
+    channel_config_set_transfer_data_size(&tx, DMA_SIZE_32);
+    channel_config_set_read_increment(&tx, true);
+    channel_config_set_write_increment(&tx, false);
+    channel_config_set_dreq(&tx, i2c_get_dreq(eeprom_i2c, true));
+    dma_channel_configure(async_tx_chan, &tx, &hw->data_cmd, async_cmd, len + 2, true);
+
+    async_deadline = make_timeout_time_us(EEPROM_ASYNC_TIMEOUT_US);
+    async_state = EEPROM_ASYNC_BUSY;
+    return true;
+}
+
+//! 停掉並歸還兩個 DMA 通道，關掉 I2C 的 DMA 請求，之後的阻塞式讀寫不會被留下來的通道搶走資料
+static void async_release(void)
+{
+    i2c_get_hw(eeprom_i2c)->dma_cr = 0;
+    dma_channel_abort(async_tx_chan);
+    dma_channel_abort(async_rx_chan);
+    dma_channel_unclaim(async_tx_chan);
+    dma_channel_unclaim(async_rx_chan);
+    async_tx_chan = -1;
+    async_rx_chan = -1;
+}
+
+//! 逾時：命令可能還在 I2C 的 FIFO 裡，送 STOP 並清掉，RX FIFO 剩下的資料也丟掉
+static void async_abort_bus(i2c_hw_t *hw)
+{
+    if (hw->enable & I2C_IC_ENABLE_ENABLE_BITS) {
+        hw->enable |= I2C_IC_ENABLE_ABORT_BITS;
+        absolute_time_t until = make_timeout_time_us(1000);
+        while ((hw->enable & I2C_IC_ENABLE_ABORT_BITS) && !time_reached(until)) {
+            tight_loop_contents();
+        }
+    }
+    while (hw->rxflr) (void) hw->data_cmd;
+    (void) hw->clr_tx_abrt;
+}
+
+eeprom_async_state_t eeprom_async_poll(void)
+{
+    if (async_state != EEPROM_ASYNC_BUSY) return async_state;
+
+    i2c_hw_t *hw = i2c_get_hw(eeprom_i2c);
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+        // 沒有 ACK，TX FIFO 被硬體清空，DMA 會一直等下去，要手動停掉
+        async_release();
+        (void) hw->clr_tx_abrt;
+        async_state = EEPROM_ASYNC_ERROR;
+    } else if (!dma_channel_is_busy(async_rx_chan)) {
+        async_release();
+        async_state = EEPROM_ASYNC_DONE;
+    } else if (time_reached(async_deadline)) {
+        // 例如傳到一半 I2C 被關掉重新設定速率 (clock_notify)，收不到剩下的資料
+        async_release();
+        async_abort_bus(hw);
+        async_state = EEPROM_ASYNC_ERROR;
+    }
+    return async_state;
+}
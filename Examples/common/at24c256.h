@@ -0,0 +1,68 @@
+/*!
+  \brief ATMEL AT24C256 I2C EEPROM 驅動
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  從 i2c_eeprom_AT24C256 範例抽出來，讓其他範例也能使用。
+  除了原本的阻塞式讀寫，另外提供用 DMA 的非同步讀取：
+  位址、讀取命令全部由 DMA 送進 IC_DATA_CMD，CPU 只需要定期呼叫 eeprom_async_poll()。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+#define EEPROM_PAGE_SIZE    64      //<! 每頁 64 Bytes
+#define EEPROM_SIZE         32768   //<! 32KB
+#define EEPROM_ASYNC_MAX    64      //<! 非同步讀取一次最多幾個 bytes
+
+//! 非同步讀取的期限 (us)，64 bytes 在最低的 10 kHz 大約 60 ms；超過就停掉 DMA 並回報 ERROR
+#ifndef EEPROM_ASYNC_TIMEOUT_US
+#define EEPROM_ASYNC_TIMEOUT_US 100000
+#endif
+
+//! 非同步讀取狀態
+typedef enum {
+    EEPROM_ASYNC_IDLE,
+    EEPROM_ASYNC_BUSY,
+    EEPROM_ASYNC_DONE,
+    EEPROM_ASYNC_ERROR,     //<! 沒有 ACK (沒接 EEPROM 或位址錯誤)，或超過 EEPROM_ASYNC_TIMEOUT_US
+} eeprom_async_state_t;
+
+/*! 設定使用的 I2C 埠與 7-bit 位址
+  \note I2C 埠要先用 i2c_init() 初始化，GPIO 也要設定好
+ */
+void eeprom_init(i2c_inst_t *i2c, uint8_t address);
+
+//! ACK 查詢，等待內部寫入週期結束
+void eeprom_wait_ready(void);
+
+/*! 連續讀取多個 Byte
+  \return 讀到的 byte 數，失敗時回傳 PICO_ERROR_GENERIC
+ */
+int eeprom_read_buffer(uint16_t addr, uint8_t *buf, size_t len);
+
+//! 智慧型寫入 (自動分頁)
+void eeprom_write_buffer(uint16_t addr, const uint8_t *data, size_t len);
+
+//! 寫入一個 Byte
+void eeprom_write_byte(uint16_t mem_addr, uint8_t data);
+
+//! 讀取一個 Byte
+uint8_t eeprom_read_byte(uint16_t mem_addr);
+
+//! 寫入之前，先讀取該位址的值。只有當新值跟舊值不一樣時，才執行寫入。
+void eeprom_update_byte(uint16_t addr, uint8_t new_val);
+
+/*! 開始非同步讀取
+  \param buf 讀取完成前不能使用
+  \return 上一次讀取還沒結束或 len 超過 EEPROM_ASYNC_MAX 時回傳 false
+  \note 讀取進行中不能呼叫其他阻塞式 API
+ */
+bool eeprom_read_async(uint16_t addr, uint8_t *buf, size_t len);
+
+/*! 查詢非同步讀取狀態
+  DONE / ERROR 會一直保持到下一次 eeprom_read_async()；
+  進入 DONE / ERROR 時 DMA 通道已經釋放，I2C 的 DMA 請求也關掉了，可以直接接著用阻塞式 API
+ */
+eeprom_async_state_t eeprom_async_poll(void);
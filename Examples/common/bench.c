@@ -0,0 +1,107 @@
+/*!
+  \brief 板子上的微基準測試
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "bench.h"
+
+#if PICO_RISCV
+#include "hardware/riscv.h"
+#define BENCH_ARCH "riscv"
+#else
+#include "hardware/structs/m33.h"
+#define BENCH_ARCH "arm"
+#endif
+
+static uint32_t samples[BENCH_MAX_ITERS];
+static uint32_t overhead;
+static bool ready;
+
+uint32_t __not_in_flash_func(bench_cycles)(void)
+{
+#if PICO_RISCV
+    return riscv_read_csr(mcycle);
+#else
+    return m33_hw->dwt_cyccnt;
+#endif
+}
+
+//! 量測開銷用的空函式，不能被 inline
+static void __attribute__((noinline)) empty(void *ctx)
+{
+    __asm volatile ("" : : "r" (ctx) : "memory");
+}
+
+//! 量測一次，計數器與呼叫都在 RAM 裡，避免 XIP cache miss 算進結果
+static uint32_t __not_in_flash_func(measure)(bench_fn fn, void *ctx, bool irqs_on)
+{
+    uint32_t save = irqs_on ? 0 : save_and_disable_interrupts();
+    uint32_t t0 = bench_cycles();
+    fn(ctx);
+    uint32_t t1 = bench_cycles();
+    if (!irqs_on) restore_interrupts(save);
+    return t1 - t0;
+}
+
+void bench_init(void)
+{
+    if (ready) return;
+#if PICO_RISCV
+    // Hazard3 的 mcycle 預設可能被停止
+    riscv_clear_csr(mcountinhibit, 1u);
+#else
+    m33_hw->demcr |= M33_DEMCR_TRCENA_BITS;
+    m33_hw->dwt_cyccnt = 0;
+    m33_hw->dwt_ctrl |= M33_DWT_CTRL_CYCCNTENA_BITS;
+#endif
+    overhead = UINT32_MAX;
+    for (int i = 0; i < 100; i++) {
+        uint32_t t = measure(empty, NULL, false);
+        if (t < overhead) overhead = t;
+    }
+    ready = true;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+    return x < y ? -1 : x > y;
+}
+
+void bench_run(const bench_case_t *c, uint32_t iters, bench_result_t *result)
+{
+    bench_init();
+    if (c->iters) iters = c->iters;
+    if (iters < 1) iters = 1;
+    if (iters > BENCH_MAX_ITERS) iters = BENCH_MAX_ITERS;
+    bool irqs_on = c->flags & BENCH_IRQS_ON;
+
+    c->fn(c->ctx);      // 暖機
+    for (uint32_t i = 0; i < iters; i++) {
+        uint32_t t = measure(c->fn, c->ctx, irqs_on);
+        samples[i] = t > overhead ? t - overhead : 0;
+    }
+    qsort(samples, iters, sizeof(samples[0]), compare_u32);
+    result->iters = iters;
+    result->min = samples[0];
+    result->median = samples[iters / 2];
+    result->max = samples[iters - 1];
+}
+
+void bench_run_all(const char *suite, const bench_case_t *cases, uint32_t count, uint32_t iters)
+{
+    bench_init();
+    printf("BENCH_BEGIN,%s,%s,%u,%u\n", suite, BENCH_ARCH, (uint) clock_get_hz(clk_sys), (uint) overhead);
+    for (uint32_t i = 0; i < count; i++) {
+        bench_result_t r;
+        bench_run(&cases[i], iters, &r);
+        printf("BENCH,%s,%s,%u,%u,%u,%u\n", suite, cases[i].name, (uint) r.iters, (uint) r.min, (uint) r.median,
+               (uint) r.max);
+    }
+    printf("BENCH_END,%s\n", suite);
+}
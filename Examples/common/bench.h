@@ -0,0 +1,63 @@
+/*!
+  \brief 板子上的微基準測試：量測一段程式要幾個 CPU 週期
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  Arm M33 用 DWT 週期計數器，Hazard3 RISC-V 用 mcycle，解析度都是 1 個 clk_sys 週期。
+  每次量測前後都關中斷，結果已經扣掉量測本身的開銷 (呼叫一個空函式)。
+  第一次呼叫不計入 (讓 XIP cache 先載入程式)，之後的 iters 次取最小、中位數、最大值。
+
+  結果以一行一筆的 CSV 從 stdio 送出，host/bench_diff.py 可以比較兩次的結果：
+
+    BENCH_BEGIN,suite,arch,clk_sys_hz,overhead
+    BENCH,suite,name,iters,min,median,max
+    BENCH_END,suite
+
+  \note 會等待 (sleep) 的函式 (例如 EEPROM 寫入) 必須加 BENCH_IRQS_ON，
+        關中斷時計時器的中斷進不來，sleep 可能永遠不會結束
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define BENCH_MAX_ITERS     1000    //<! 每個項目最多量幾次
+#define BENCH_IRQS_ON       1u      //<! 量測時不關中斷 (結果會包含中斷處理的時間)
+
+typedef void (*bench_fn)(void *ctx);
+
+//! 一個量測項目
+typedef struct {
+    const char *name;       //<! 不要有逗號
+    bench_fn fn;
+    void *ctx;
+    uint32_t flags;         //<! BENCH_IRQS_ON
+    uint32_t iters;         //<! 0 表示用 bench_run_all() 的預設次數
+} bench_case_t;
+
+//! 一般的項目
+#define BENCH_CASE(name, fn, ctx)               {(name), (fn), (ctx), 0, 0}
+//! 會 sleep 的項目，只量 iters 次
+#define BENCH_CASE_IRQS_ON(name, fn, ctx, iters) {(name), (fn), (ctx), BENCH_IRQS_ON, (iters)}
+
+//! 量測結果 (CPU 週期)
+typedef struct {
+    uint32_t iters;
+    uint32_t min;
+    uint32_t median;
+    uint32_t max;
+} bench_result_t;
+
+//! 啟動週期計數器並量測開銷，其他函式會自動呼叫
+void bench_init(void);
+
+//! 目前的週期計數 (32-bit，150 MHz 大約 28 秒繞回)
+uint32_t bench_cycles(void);
+
+//! 量測一個項目
+void bench_run(const bench_case_t *c, uint32_t iters, bench_result_t *result);
+
+/*! 依序量測所有項目並印出 CSV
+  \param suite 測試組的名稱 (通常是範例名稱)
+  \param iters 每個項目的預設次數，最多 BENCH_MAX_ITERS
+ */
+void bench_run_all(const char *suite, const bench_case_t *cases, uint32_t count, uint32_t iters);
@@ -0,0 +1,226 @@
+/*!
+  \brief 系統時鐘變更通知
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include "clock_notify.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+
+#if LIB_HARDWARE_PWM
+#include "hardware/pwm.h"
+#endif
+
+typedef struct {
+    clock_notify_fn fn;
+    void *ctx;
+} notifier_t;
+
+static notifier_t notifiers[CLOCK_NOTIFY_MAX];
+
+int clock_notify_register(clock_notify_fn fn, void *ctx)
+{
+    for (int i = 0; i < CLOCK_NOTIFY_MAX; i++) {
+        if (!notifiers[i].fn) {
+            notifiers[i].fn = fn;
+            notifiers[i].ctx = ctx;
+            return i;
+        }
+    }
+    return PICO_ERROR_INSUFFICIENT_RESOURCES;
+}
+
+static void release_peripheral(int id);
+
+void clock_notify_unregister(int id)
+{
+    if (id < 0 || id >= CLOCK_NOTIFY_MAX) return;
+    notifiers[id].fn = NULL;
+    release_peripheral(id);
+}
+
+static void notify(clock_change_t change, uint32_t old_hz, uint32_t new_hz)
+{
+    if (change == CLOCK_CHANGE_PRE) {
+        // 跟初始化相反的順序暫停
+        for (int i = CLOCK_NOTIFY_MAX - 1; i >= 0; i--) {
+            if (notifiers[i].fn) notifiers[i].fn(change, old_hz, new_hz, notifiers[i].ctx);
+        }
+    } else {
+        for (int i = 0; i < CLOCK_NOTIFY_MAX; i++) {
+            if (notifiers[i].fn) notifiers[i].fn(change, old_hz, new_hz, notifiers[i].ctx);
+        }
+    }
+}
+
+bool clock_notify_set_sys_khz(uint32_t khz)
+{
+    uint vco, postdiv1, postdiv2;
+    if (!check_sys_clock_khz(khz, &vco, &postdiv1, &postdiv2)) return false;
+
+    clock_notify_set_sys_pll(vco, postdiv1, postdiv2);
+    return true;
+}
+
+void clock_notify_set_sys_pll(uint32_t vco_hz, uint postdiv1, uint postdiv2)
+{
+    uint32_t old_hz = clock_get_hz(clk_sys);
+    notify(CLOCK_CHANGE_PRE, old_hz, vco_hz / (postdiv1 * postdiv2));
+    set_sys_clock_pll(vco_hz, postdiv1, postdiv2);
+    notify(CLOCK_CHANGE_POST, old_hz, clock_get_hz(clk_sys));
+}
+
+void clock_notify_set_sys_48mhz(void)
+{
+    uint32_t old_hz = clock_get_hz(clk_sys);
+    notify(CLOCK_CHANGE_PRE, old_hz, 48 * MHZ);
+    set_sys_clock_48mhz();
+    notify(CLOCK_CHANGE_POST, old_hz, clock_get_hz(clk_sys));
+}
+
+bool clock_notify_get_sys_pll(uint32_t *vco_hz, uint *postdiv1, uint *postdiv2)
+{
+    const uint32_t aux_pll_sys =
+            (CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX << CLOCKS_CLK_SYS_CTRL_SRC_LSB) |
+            (CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS << CLOCKS_CLK_SYS_CTRL_AUXSRC_LSB);
+    uint32_t ctrl = clocks_hw->clk[clk_sys].ctrl & (CLOCKS_CLK_SYS_CTRL_SRC_BITS | CLOCKS_CLK_SYS_CTRL_AUXSRC_BITS);
+    if (ctrl != aux_pll_sys) return false;
+
+    uint refdiv = pll_sys_hw->cs & PLL_CS_REFDIV_BITS;
+    *vco_hz = XOSC_HZ / refdiv * (pll_sys_hw->fbdiv_int & PLL_FBDIV_INT_BITS);
+    *postdiv1 = (pll_sys_hw->prim & PLL_PRIM_POSTDIV1_BITS) >> PLL_PRIM_POSTDIV1_LSB;
+    *postdiv2 = (pll_sys_hw->prim & PLL_PRIM_POSTDIV2_BITS) >> PLL_PRIM_POSTDIV2_LSB;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// 常用周邊
+
+//! 一個周邊的設定，ctx 指向這裡；跟註冊編號同一個索引，取消註冊時一起釋放
+typedef struct {
+    clock_notify_fn fn; //<! NULL 表示沒有使用
+    void *hw;           //<! PIO / i2c_inst_t / uart_inst_t
+    uint index;         //<! 狀態機或 PWM slice 編號
+    float hz;           //<! 要維持的頻率 (baudrate)
+    bool was_enabled;
+} peripheral_t;
+
+static peripheral_t peripherals[CLOCK_NOTIFY_MAX];
+
+static void release_peripheral(int id)
+{
+    peripherals[id].fn = NULL;
+}
+
+//! 用目前的時鐘重新套用一次
+static void apply_peripheral(peripheral_t *p)
+{
+    uint32_t hz_now = clock_get_hz(clk_sys);
+    p->fn(CLOCK_CHANGE_PRE, hz_now, hz_now, p);
+    p->fn(CLOCK_CHANGE_POST, hz_now, hz_now, p);
+}
+
+//! 註冊並立即套用一次目前的時鐘
+static int add_peripheral(clock_notify_fn fn, void *hw, uint index, float hz)
+{
+    int id = clock_notify_register(fn, NULL);
+    if (id < 0) return id;
+    peripheral_t *p = &peripherals[id];
+    *p = (peripheral_t) {.fn = fn, .hw = hw, .index = index, .hz = hz};
+    notifiers[id].ctx = p;
+    apply_peripheral(p);
+    return id;
+}
+
+int clock_notify_retune(int id, float hz)
+{
+    if (id < 0 || id >= CLOCK_NOTIFY_MAX || !peripherals[id].fn) return PICO_ERROR_INVALID_ARG;
+    peripherals[id].hz = hz;
+    apply_peripheral(&peripherals[id]);
+    return PICO_OK;
+}
+
+//! 等 done() 成立，最多 CLOCK_NOTIFY_DRAIN_US
+#define DRAIN(done) do { \
+        absolute_time_t until_ = make_timeout_time_us(CLOCK_NOTIFY_DRAIN_US); \
+        while (!(done) && !time_reached(until_)) tight_loop_contents(); \
+    } while (0)
+
+static inline float clamp_div(float div, float max)
+{
+    return div < 1.f ? 1.f : div > max ? max : div;
+}
+
+#if LIB_HARDWARE_PIO
+static void pio_sm_changed(clock_change_t change, uint32_t old_hz, uint32_t new_hz, void *ctx)
+{
+    peripheral_t *p = ctx;
+    PIO pio = p->hw;
+    if (change == CLOCK_CHANGE_PRE) {
+        p->was_enabled = pio->ctrl & (1u << (PIO_CTRL_SM_ENABLE_LSB + p->index));
+        DRAIN(pio_sm_is_tx_fifo_empty(pio, p->index));
+        pio_sm_set_enabled(pio, p->index, false);
+    } else {
+        pio_sm_set_clkdiv(pio, p->index, clamp_div((float) new_hz / p->hz, 65536.f));
+        pio_sm_clkdiv_restart(pio, p->index);
+        pio_sm_set_enabled(pio, p->index, p->was_enabled);
+    }
+}
+
+int clock_notify_pio_sm(PIO pio, uint sm, float sm_hz)
+{
+    return add_peripheral(pio_sm_changed, pio, sm, sm_hz);
+}
+#endif
+
+#if LIB_HARDWARE_PWM
+static void pwm_slice_changed(clock_change_t change, uint32_t old_hz, uint32_t new_hz, void *ctx)
+{
+    peripheral_t *p = ctx;
+    if (change == CLOCK_CHANGE_POST) {
+        pwm_set_clkdiv(p->index, clamp_div((float) new_hz / p->hz, 255.9375f));
+    }
+}
+
+int clock_notify_pwm_slice(uint slice, float counter_hz)
+{
+    return add_peripheral(pwm_slice_changed, NULL, slice, counter_hz);
+}
+#endif
+
+#if LIB_HARDWARE_I2C
+static void i2c_changed(clock_change_t change, uint32_t old_hz, uint32_t new_hz, void *ctx)
+{
+    peripheral_t *p = ctx;
+    i2c_inst_t *i2c = p->hw;
+    if (change == CLOCK_CHANGE_PRE) {
+        DRAIN(!(i2c_get_hw(i2c)->status & I2C_IC_STATUS_ACTIVITY_BITS));
+    } else {
+        i2c_set_baudrate(i2c, (uint) p->hz);
+    }
+}
+
+int clock_notify_i2c(i2c_inst_t *i2c, uint baudrate)
+{
+    return add_peripheral(i2c_changed, i2c, 0, (float) baudrate);
+}
+#endif
+
+#if LIB_HARDWARE_UART
+static void uart_changed(clock_change_t change, uint32_t old_hz, uint32_t new_hz, void *ctx)
+{
+    peripheral_t *p = ctx;
+    uart_inst_t *uart = p->hw;
+    if (change == CLOCK_CHANGE_PRE) {
+        uart_tx_wait_blocking(uart);
+    } else {
+        // UART 用的是 clk_peri，SDK 變更 clk_sys 時也會一起調整 clk_peri
+        uart_set_baudrate(uart, (uint) p->hz);
+    }
+}
+
+int clock_notify_uart(uart_inst_t *uart, uint baudrate)
+{
+    return add_peripheral(uart_changed, uart, 0, (float) baudrate);
+}
+#endif
@@ -0,0 +1,92 @@
+/*!
+  \brief 系統時鐘變更通知：clk_sys 改變時自動重新計算各周邊的分頻
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  PIO、PWM、I2C、UART 的分頻都是初始化時用 clock_get_hz() 算一次，
+  之後直接呼叫 set_sys_clock_khz() 會讓所有時序都跑掉。
+
+  改用 clock_notify_set_sys_khz() 變更時鐘：
+  - 變更前依註冊的相反順序呼叫 CLOCK_CHANGE_PRE (暫停狀態機、等傳輸結束)
+  - 變更後依註冊順序呼叫 CLOCK_CHANGE_POST (重新計算分頻、恢復狀態機)
+
+  常用的周邊可以直接用 clock_notify_pio_sm() 等函式註冊，註冊時就會先套用一次目前的時鐘。
+  這些函式只有在有連結對應的 hardware_xxx 程式庫時才會編譯 (LIB_HARDWARE_PIO 等)。
+
+  \note 只能在一個核心上呼叫，變更期間另一個核心不應該使用這些周邊
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#if LIB_HARDWARE_PIO
+#include "hardware/pio.h"
+#endif
+#if LIB_HARDWARE_I2C
+#include "hardware/i2c.h"
+#endif
+
+#define CLOCK_NOTIFY_MAX        16      //<! 最多幾個註冊
+#define CLOCK_NOTIFY_DRAIN_US   2000    //<! 變更前最多等多久讓傳輸結束
+
+//! 通知的時機
+typedef enum {
+    CLOCK_CHANGE_PRE,       //<! 時鐘還沒變更，old_hz 是目前的頻率
+    CLOCK_CHANGE_POST,      //<! 時鐘已經變更，clock_get_hz(clk_sys) == new_hz
+} clock_change_t;
+
+typedef void (*clock_notify_fn)(clock_change_t change, uint32_t old_hz, uint32_t new_hz, void *ctx);
+
+/*! 註冊通知函式
+  \return 註冊編號，已滿時回傳 PICO_ERROR_INSUFFICIENT_RESOURCES
+ */
+int clock_notify_register(clock_notify_fn fn, void *ctx);
+
+//! 取消註冊 (clock_notify_pio_sm() 等函式的註冊也一樣，會一起釋放周邊的設定)
+void clock_notify_unregister(int id);
+
+/*! 變更 clk_sys 並通知所有註冊的驅動
+  \return 頻率無法達成時回傳 false，時鐘不變也不會通知
+ */
+bool clock_notify_set_sys_khz(uint32_t khz);
+
+/*! 直接指定 PLL 設定 (例如 clock_plan_solve() 的結果)
+  \param vco_hz 750 ~ 1600 MHz，必須是 12 MHz 的整數倍
+ */
+void clock_notify_set_sys_pll(uint32_t vco_hz, uint postdiv1, uint postdiv2);
+
+//! 改用 USB PLL 的 48 MHz (最省電的設定)
+void clock_notify_set_sys_48mhz(void);
+
+/*! 目前 clk_sys 的 PLL 設定，可以之後用 clock_notify_set_sys_pll() 恢復
+  \return clk_sys 不是直接由 PLL_SYS 供應 (例如已經改用 48 MHz) 時回傳 false
+ */
+bool clock_notify_get_sys_pll(uint32_t *vco_hz, uint *postdiv1, uint *postdiv2);
+
+/*! 改變 clock_notify_pio_sm() 等函式註冊的頻率 (baudrate)，並立即用目前的時鐘重新套用
+  不用取消再重新註冊，編號不變
+  \return id 不是周邊的註冊時回傳 PICO_ERROR_INVALID_ARG
+ */
+int clock_notify_retune(int id, float hz);
+
+#if LIB_HARDWARE_PIO
+/*! PIO 狀態機維持 sm_hz 的執行速度
+  變更前等 TX FIFO 送完再暫停，變更後重設分頻並恢復原本的啟用狀態
+ */
+int clock_notify_pio_sm(PIO pio, uint sm, float sm_hz);
+#endif
+
+#if LIB_HARDWARE_PWM
+//! PWM slice 的計數器維持 counter_hz (分頻只能在 1 ~ 256 之間)
+int clock_notify_pwm_slice(uint slice, float counter_hz);
+#endif
+
+#if LIB_HARDWARE_I2C
+//! I2C 維持 baudrate，變更前等目前的傳輸結束
+int clock_notify_i2c(i2c_inst_t *i2c, uint baudrate);
+#endif
+
+#if LIB_HARDWARE_UART
+//! UART 維持 baudrate (stdio UART 也要註冊)，變更前等 TX 送完
+int clock_notify_uart(uart_inst_t *uart, uint baudrate);
+#endif
@@ -0,0 +1,135 @@
+/*!
+  \brief 系統時鐘規劃
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "clock_plan.h"
+
+//! clk_sys 上限與需要的核心電壓
+static const struct {
+    uint32_t max_sys_hz;
+    uint16_t voltage_mv;
+} voltage_table[] = {
+    {150000000u, 1100},     // RP2350 規格
+    {200000000u, 1150},
+    {250000000u, 1200},
+    {300000000u, 1300},
+};
+
+uint16_t clock_plan_voltage_mv(uint32_t sys_hz)
+{
+    for (uint32_t i = 0; i < sizeof(voltage_table) / sizeof(voltage_table[0]); i++) {
+        if (sys_hz <= voltage_table[i].max_sys_hz) return voltage_table[i].voltage_mv;
+    }
+    return 0;
+}
+
+void clock_plan_evaluate(const clock_plan_req_t *req, uint32_t sys_hz, clock_plan_result_t *result)
+{
+    double div = sys_hz / req->hz;
+    double steps = (double) (1u << req->frac_bits);
+    double q = round(div * steps) / steps;     // 硬體實際用的分頻
+    if (q < 1.0) q = 1.0;
+    if (q > req->max_div) q = req->max_div;
+
+    result->div = div;
+    result->actual_hz = sys_hz / q;
+    result->error_ppm = (result->actual_hz - req->hz) / req->hz * 1e6;
+    result->in_range = div >= 1.0 && div <= req->max_div;
+    result->integral = result->in_range && fabs(div - round(div)) < div * 1e-12;
+}
+
+//! a 比 b 好的時候回傳 true
+static bool better(const clock_plan_t *a, const clock_plan_t *b)
+{
+    if (a->integral != b->integral) return a->integral > b->integral;
+    if (fabs(a->error_ppm_sum - b->error_ppm_sum) > 1e-3) return a->error_ppm_sum < b->error_ppm_sum;
+    if (a->voltage_mv != b->voltage_mv) return a->voltage_mv < b->voltage_mv;
+    if (a->sys_hz != b->sys_hz) return a->sys_hz > b->sys_hz;
+    return a->vco_hz > b->vco_hz;
+}
+
+//! 計算一個 PLL 設定的分數，有周邊超出分頻範圍時回傳 false
+static bool score(clock_plan_t *plan, const clock_plan_req_t *reqs, uint32_t count)
+{
+    plan->integral = 0;
+    plan->error_ppm_sum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        clock_plan_result_t *r = &plan->results[i];
+        clock_plan_evaluate(&reqs[i], plan->sys_hz, r);
+        if (!r->in_range) return false;
+        if (r->integral) plan->integral++;
+        plan->error_ppm_sum += fabs(r->error_ppm);
+    }
+    return true;
+}
+
+uint32_t clock_plan_rank(const clock_plan_req_t *reqs, uint32_t count, const clock_plan_limits_t *limits,
+                         clock_plan_t *plans, uint32_t max_plans)
+{
+    if (count > CLOCK_PLAN_MAX_REQS) count = CLOCK_PLAN_MAX_REQS;
+    uint32_t found = 0;
+    clock_plan_t c;
+
+    // 跟 SDK 的 check_sys_clock_khz() 一樣從最高的 VCO 開始，同樣的 clk_sys 只留 VCO 最高的
+    for (uint32_t fbdiv = 320; fbdiv >= 16; fbdiv--) {
+        uint32_t vco = CLOCK_PLAN_XOSC_HZ * fbdiv;
+        if (vco < CLOCK_PLAN_VCO_MIN_HZ || vco > CLOCK_PLAN_VCO_MAX_HZ) continue;
+
+        for (uint32_t pd1 = 7; pd1 >= 1; pd1--) {
+            for (uint32_t pd2 = pd1; pd2 >= 1; pd2--) {
+                // SDK 只接受剛好是整數 kHz 的頻率
+                if (vco % (pd1 * pd2 * 1000u)) continue;
+                uint32_t sys = vco / (pd1 * pd2);
+                if (sys < limits->min_sys_hz || sys > limits->max_sys_hz) continue;
+                uint16_t mv = clock_plan_voltage_mv(sys);
+                if (!mv || mv > limits->max_voltage_mv) continue;
+
+                bool duplicate = false;
+                for (uint32_t i = 0; i < found && !duplicate; i++) duplicate = plans[i].sys_hz == sys;
+                if (duplicate) continue;
+
+                c.vco_hz = vco;
+                c.postdiv1 = (uint8_t) pd1;
+                c.postdiv2 = (uint8_t) pd2;
+                c.sys_hz = sys;
+                c.voltage_mv = mv;
+                if (!score(&c, reqs, count)) continue;
+
+                // 插入排序，只留前 max_plans 名
+                uint32_t pos = found < max_plans ? found : max_plans;
+                while (pos > 0 && better(&c, &plans[pos - 1])) pos--;
+                if (pos >= max_plans) continue;
+                uint32_t last = found < max_plans ? found : max_plans - 1;
+                memmove(&plans[pos + 1], &plans[pos], (last - pos) * sizeof(c));
+                plans[pos] = c;
+                if (found < max_plans) found++;
+            }
+        }
+    }
+    return found;
+}
+
+bool clock_plan_solve(const clock_plan_req_t *reqs, uint32_t count, const clock_plan_limits_t *limits,
+                      clock_plan_t *plan)
+{
+    return clock_plan_rank(reqs, count, limits, plan, 1) == 1;
+}
+
+void clock_plan_print(const clock_plan_t *plan, const clock_plan_req_t *reqs, uint32_t count)
+{
+    if (count > CLOCK_PLAN_MAX_REQS) count = CLOCK_PLAN_MAX_REQS;
+    printf("clk_sys %.3f MHz = VCO %u MHz / %u / %u, %u.%02u V, %u/%u integral dividers\n",
+           plan->sys_hz / 1e6, (unsigned) (plan->vco_hz / 1000000), plan->postdiv1, plan->postdiv2,
+           plan->voltage_mv / 1000u, (plan->voltage_mv % 1000u) / 10u, plan->integral, (unsigned) count);
+    printf("  %-16s %14s %12s %16s %12s\n", "peripheral", "target Hz", "divider", "actual Hz", "error ppm");
+    for (uint32_t i = 0; i < count; i++) {
+        const clock_plan_result_t *r = &plan->results[i];
+        printf("  %-16s %14.1f %12.5f %16.3f %12.3f %s\n", reqs[i].name, reqs[i].hz, r->div, r->actual_hz,
+               r->error_ppm, r->integral ? "" : r->in_range ? "fractional" : "out of range");
+    }
+}
@@ -0,0 +1,97 @@
+/*!
+  \brief 系統時鐘規劃：找一個讓各周邊分頻盡量是整數的 clk_sys
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  PIO 與 PWM 的分頻有小數部分時，狀態機是用「有時多等一個週期」的方式平均出來的，
+  輸出會有一個 clk_sys 週期的抖動。例如 WS2812 每個 bit 10 個 PIO 週期，800 kHz
+  需要 8 MHz，150 MHz / 8 MHz = 18.75 就不是整數。
+
+  clock_plan_solve() 列舉所有 PLL 設定 (XOSC 12 MHz、VCO 750 ~ 1600 MHz、postdiv 1 ~ 7)，
+  依序比較：
+  1. 分頻是整數的周邊數量 (越多越好)
+  2. 量化後實際頻率的誤差總和 (越小越好)
+  3. 需要的核心電壓 (越低越好)
+  4. clk_sys (越高越好)
+
+  不依賴 Pico SDK，電腦上也能執行 (host/clock_plan)。
+  板子上用 clock_notify_set_sys_pll() 套用結果。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CLOCK_PLAN_XOSC_HZ      12000000u
+#define CLOCK_PLAN_VCO_MIN_HZ   750000000u
+#define CLOCK_PLAN_VCO_MAX_HZ   1600000000u
+#define CLOCK_PLAN_MAX_REQS     16
+
+//! 一個周邊需要的頻率
+typedef struct {
+    const char *name;
+    double hz;              //<! 周邊需要的輸入頻率 (PIO 狀態機、PWM 計數器、I2C bit rate ...)
+    uint8_t frac_bits;      //<! 分頻小數部分的 bits，0 表示只能整數
+    uint32_t max_div;       //<! 分頻整數部分的最大值
+} clock_plan_req_t;
+
+//! PIO 狀態機執行速度 (16.8 分頻)
+#define CLOCK_REQ_PIO(name, hz)     ((clock_plan_req_t) {(name), (hz), 8, 65536})
+//! PWM 計數器速度 (8.4 分頻)
+#define CLOCK_REQ_PWM(name, hz)     ((clock_plan_req_t) {(name), (hz), 4, 256})
+//! I2C baudrate (SCL 高低準位都是整數個 clk_sys 週期)
+#define CLOCK_REQ_I2C(name, hz)     ((clock_plan_req_t) {(name), (hz), 0, 65535})
+
+//! 搜尋範圍
+typedef struct {
+    uint32_t min_sys_hz;
+    uint32_t max_sys_hz;        //<! 超過 150 MHz 是超頻
+    uint16_t max_voltage_mv;    //<! 可以接受的核心電壓，預設 1100 (不調整電壓)
+} clock_plan_limits_t;
+
+#define CLOCK_PLAN_LIMITS_DEFAULT   ((clock_plan_limits_t) {48000000u, 150000000u, 1100})
+
+//! 一個周邊在某個 clk_sys 下的結果
+typedef struct {
+    double div;             //<! 理想分頻
+    double actual_hz;       //<! 分頻量化後的實際頻率
+    double error_ppm;
+    bool integral;          //<! 分頻剛好是整數 (沒有抖動)
+    bool in_range;          //<! 分頻在 1 ~ max_div 之間
+} clock_plan_result_t;
+
+//! 規劃結果
+typedef struct {
+    uint32_t vco_hz;
+    uint8_t postdiv1;
+    uint8_t postdiv2;
+    uint32_t sys_hz;
+    uint16_t voltage_mv;    //<! 這個頻率需要的核心電壓
+    uint8_t integral;       //<! 分頻是整數的周邊數量
+    double error_ppm_sum;
+    clock_plan_result_t results[CLOCK_PLAN_MAX_REQS];
+} clock_plan_t;
+
+/*! 這個 clk_sys 需要的核心電壓 (mV)，超過可以達到的範圍時回傳 0
+  \note 150 MHz 以內是規格值；以上是常見的超頻經驗值，不保證每顆晶片都穩定
+ */
+uint16_t clock_plan_voltage_mv(uint32_t sys_hz);
+
+//! 計算一個周邊在 sys_hz 下的分頻與誤差
+void clock_plan_evaluate(const clock_plan_req_t *req, uint32_t sys_hz, clock_plan_result_t *result);
+
+/*! 找出最好的 PLL 設定
+  \param count 最多 CLOCK_PLAN_MAX_REQS
+  \return 在限制內找不到任何可用的設定時回傳 false
+ */
+bool clock_plan_solve(const clock_plan_req_t *reqs, uint32_t count, const clock_plan_limits_t *limits,
+                      clock_plan_t *plan);
+
+/*! 列出前 max_plans 名的設定 (依 clock_plan_solve 的順序)
+  \return 實際找到的數量
+ */
+uint32_t clock_plan_rank(const clock_plan_req_t *reqs, uint32_t count, const clock_plan_limits_t *limits,
+                         clock_plan_t *plans, uint32_t max_plans);
+
+//! 印出誤差表
+void clock_plan_print(const clock_plan_t *plan, const clock_plan_req_t *reqs, uint32_t count);
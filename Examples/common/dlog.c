@@ -0,0 +1,119 @@
+/*!
+  \brief 延遲格式化的二進位 log
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "dlog.h"
+
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio_usb.h"
+#endif
+
+#define MASK        (DLOG_RING_WORDS - 1)
+#define TIME_MASK   0x0fffffffu
+
+//! 單一生產者 (這個核心) 單一消費者 (dlog_drain) 的環狀緩衝區
+typedef struct {
+    uint32_t buf[DLOG_RING_WORDS];
+    volatile uint32_t head;         //<! 只有生產者寫
+    volatile uint32_t tail;         //<! 只有 dlog_drain 寫
+    volatile uint32_t dropped;      //<! 只有生產者寫
+    uint32_t dropped_sent;          //<! 已經回報過的丟棄筆數
+} ring_t;
+
+static ring_t rings[NUM_CORES];
+
+// 放在 RAM 裡執行，避免 XIP cache miss 造成的延遲
+void __not_in_flash_func(dlog_write)(const char *fmt, uint32_t n, uint32_t a0, uint32_t a1, uint32_t a2,
+                                     uint32_t a3)
+{
+    ring_t *r = &rings[get_core_num()];
+    uint32_t words = 2 + n;
+
+    // 同一個核心上的中斷也可能寫 log，關中斷比 compare-and-swap 便宜
+    uint32_t save = save_and_disable_interrupts();
+    uint32_t head = r->head;
+    if (DLOG_RING_WORDS - (head - r->tail) < words) {
+        r->dropped++;
+        restore_interrupts(save);
+        return;
+    }
+    uint32_t *buf = r->buf;
+    buf[head & MASK] = (uint32_t) (uintptr_t) fmt;
+    buf[(head + 1) & MASK] = (n << 28) | (timer_hw->timerawl & TIME_MASK);
+    switch (n) {
+        case 4: buf[(head + 5) & MASK] = a3; // fall through
+        case 3: buf[(head + 4) & MASK] = a2; // fall through
+        case 2: buf[(head + 3) & MASK] = a1; // fall through
+        case 1: buf[(head + 2) & MASK] = a0; // fall through
+        default: break;
+    }
+    // 資料要比 head 先被另一個核心看到
+    __dmb();
+    r->head = head + words;
+    restore_interrupts(save);
+}
+
+// ----------------------------------------------------------------------------
+// 輸出
+
+//! 送出一個封包，words 最多 6 個字
+static void send_frame(uint core, uint32_t kind, const uint32_t *words, uint32_t count)
+{
+    uint8_t frame[3 + 4 * (2 + DLOG_MAX_ARGS)];
+    uint32_t len = 0;
+    uint8_t sum = 0;
+    frame[len++] = DLOG_SYNC;
+    frame[len++] = (uint8_t) ((core << 4) | kind);
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t b = 0; b < 4; b++) frame[len++] = (uint8_t) (words[i] >> (8 * b));
+    }
+    for (uint32_t i = 1; i < len; i++) sum ^= frame[i];
+    frame[len++] = sum;
+    stdio_put_string((const char *) frame, (int) len, false, false);
+}
+
+uint32_t dlog_drain(uint32_t max_records)
+{
+#if LIB_PICO_STDIO_USB
+    // USB 沒連線時寫入會等到逾時，紀錄留在緩衝區裡
+    if (!stdio_usb_connected()) return 0;
+#endif
+    uint32_t sent = 0;
+    for (uint core = 0; core < NUM_CORES; core++) {
+        ring_t *r = &rings[core];
+        uint32_t dropped = r->dropped;
+        if (dropped != r->dropped_sent) {
+            uint32_t count = dropped - r->dropped_sent;
+            send_frame(core, DLOG_DROPPED, &count, 1);
+            r->dropped_sent = dropped;
+        }
+
+        uint32_t tail = r->tail;
+        uint32_t head = r->head;
+        __dmb();
+        while (tail != head && (!max_records || sent < max_records)) {
+            uint32_t record[2 + DLOG_MAX_ARGS];
+            record[0] = r->buf[tail & MASK];
+            record[1] = r->buf[(tail + 1) & MASK];
+            uint32_t words = 2 + (record[1] >> 28);
+            for (uint32_t i = 2; i < words; i++) record[i] = r->buf[(tail + i) & MASK];
+            tail += words;
+            // 先釋放空間，送出時生產者就可以繼續寫
+            __dmb();
+            r->tail = tail;
+            send_frame(core, words, record, words);
+            sent++;
+        }
+    }
+    return sent;
+}
+
+uint32_t dlog_dropped(void)
+{
+    uint32_t total = 0;
+    for (uint core = 0; core < NUM_CORES; core++) total += rings[core].dropped;
+    return total;
+}
@@ -0,0 +1,99 @@
+/*!
+  \brief 延遲格式化的二進位 log：取代熱迴圈裡的 printf
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  printf 要格式化字串，USB CDC 滿了還會阻塞，在 LED 迴圈裡會造成好幾 ms 的抖動。
+  DLOG() 只把格式字串的位址、時間戳記與最多 4 個 32-bit 參數寫進目前核心的環狀緩衝區，
+  大約幾十個 CPU 週期；格式化留給電腦上的 host/dlog_decode.py 用 ELF 檔還原。
+
+    DLOG("pattern %s, speed %d", pattern_table[pat].name, speed);
+
+  - 格式字串必須是字串常數 (位址要在 ELF 裡找得到)
+  - %s 只能接 flash 裡的常數字串，RAM 裡的字串請用 printf
+  - float / double 會自動轉成 float 的 bits，用 %f %e %g 顯示
+  - 其他指標請自己轉成 uintptr_t，用 %x 或 %p 顯示
+
+  每個核心一個環狀緩衝區，中斷裡也可以呼叫；滿了就丟掉新的紀錄並計數。
+  主迴圈 (或其他低優先權的地方) 定期呼叫 dlog_drain()，把紀錄編成封包從 stdio 送出，
+  封包以外的 printf 文字解碼器會照原樣顯示。
+
+  \note 封包是二進位，只適合接 dlog_decode.py 的 stdio；有 common/shell 指令列的程式
+        (終端機要打字、看文字) 不要在同一個 stdio 上呼叫 dlog_drain()，回應指令的輸出請用 printf
+
+  封包格式：0xA5, (core << 4) | 字數, 字數 * 4 bytes (little endian), XOR 檢查碼
+  - 第 1 個字：格式字串位址
+  - 第 2 個字：參數個數 << 28 | 時間戳記 (us 的低 28 bits)
+  - 字數 0xF 表示丟掉的筆數 (1 個字)
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#ifndef DLOG_ENABLE
+#define DLOG_ENABLE     1
+#endif
+
+#ifndef DLOG_RING_WORDS
+#define DLOG_RING_WORDS 1024    //<! 每個核心的緩衝區大小 (32-bit 字數，2 的次方)
+#endif
+
+#define DLOG_MAX_ARGS   4
+#define DLOG_SYNC       0xa5    //<! 封包開頭
+#define DLOG_DROPPED    0xf     //<! 丟掉筆數的封包
+
+/*! 寫入一筆紀錄，請用 DLOG()
+  \param n 參數個數 (0 ~ DLOG_MAX_ARGS)
+ */
+void dlog_write(const char *fmt, uint32_t n, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/*! 把緩衝區的紀錄送到 stdio
+  \param max_records 這次最多送幾筆，0 表示全部
+  \return 送出的筆數
+  \note 只能在一個地方呼叫 (單一消費者)
+ */
+uint32_t dlog_drain(uint32_t max_records);
+
+//! 到目前為止因為緩衝區滿了而丟掉的筆數 (兩個核心合計)
+uint32_t dlog_dropped(void);
+
+// ----------------------------------------------------------------------------
+// 參數轉換
+
+static inline uint32_t dlog_arg_u(uint32_t v) { return v; }
+static inline uint32_t dlog_arg_s(const char *s) { return (uint32_t) (uintptr_t) s; }
+
+static inline uint32_t dlog_arg_f(float f)
+{
+    union { float f; uint32_t u; } v = {.f = f};
+    return v.u;
+}
+
+static inline uint32_t dlog_arg_d(double d) { return dlog_arg_f((float) d); }
+
+#define DLOG_ARG(x) _Generic((x),                   \
+        float: dlog_arg_f,                          \
+        double: dlog_arg_d,                         \
+        char *: dlog_arg_s,                         \
+        const char *: dlog_arg_s,                   \
+        default: dlog_arg_u)(x)
+
+// ----------------------------------------------------------------------------
+// DLOG(fmt, ...)：依參數個數展開
+
+#define DLOG_NARGS_(...)    DLOG_NARGS_N_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_N_(_0, _1, _2, _3, _4, n, ...) n
+#define DLOG_CAT_(a, b)     a##b
+#define DLOG_N_(n)          DLOG_CAT_(DLOG_, n)
+
+#define DLOG_0(f)               dlog_write(f, 0, 0, 0, 0, 0)
+#define DLOG_1(f, a)            dlog_write(f, 1, DLOG_ARG(a), 0, 0, 0)
+#define DLOG_2(f, a, b)         dlog_write(f, 2, DLOG_ARG(a), DLOG_ARG(b), 0, 0)
+#define DLOG_3(f, a, b, c)      dlog_write(f, 3, DLOG_ARG(a), DLOG_ARG(b), DLOG_ARG(c), 0)
+#define DLOG_4(f, a, b, c, d)   dlog_write(f, 4, DLOG_ARG(a), DLOG_ARG(b), DLOG_ARG(c), DLOG_ARG(d))
+
+#if DLOG_ENABLE
+#define DLOG(fmt, ...)  DLOG_N_(DLOG_NARGS_(__VA_ARGS__))("" fmt, ##__VA_ARGS__)
+#else
+#define DLOG(fmt, ...)  ((void) 0)
+#endif
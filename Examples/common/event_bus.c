@@ -0,0 +1,239 @@
+/*!
+  \brief 無鎖事件匯流排
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <assert.h>
+#include <stdio.h>
+
+#include "pico/multicore.h"
+#include "hardware/irq.h"
+
+#include "event_bus.h"
+
+#define SLOT_MASK   (EVENT_QUEUE_SLOTS - 1)
+
+static_assert((EVENT_QUEUE_SLOTS & SLOT_MASK) == 0, "EVENT_QUEUE_SLOTS must be a power of 2");
+
+#ifdef SIO_IRQ_FIFO
+#define DOORBELL_IRQ    SIO_IRQ_FIFO                        //<! RP2350：兩個核心同一個編號
+#else
+#define DOORBELL_IRQ    (SIO_IRQ_PROC0 + get_core_num())    //<! RP2040
+#endif
+
+typedef struct {
+    atomic_uint published;
+    atomic_uint delivered;
+    atomic_uint dropped;
+} topic_counter_t;
+
+static const char *const *topic_names;
+static uint topic_name_count;
+static topic_counter_t counters[EVENT_TOPIC_MAX];
+static uint32_t stats_start_us;
+
+static event_queue_t *_Atomic queues[EVENT_QUEUE_MAX];
+static atomic_uint queue_count;
+//! 這個核心有沒有門鈴中斷，沒有的話不送 (FIFO 的資料會卡住 multicore_launch_core1)
+static atomic_bool doorbell_enabled[2];
+
+// ----------------------------------------------------------------------------
+// 環狀佇列
+
+//! 寫入一筆：搶到寫入位置 (CAS) 後複製事件，最後更新格子的序號讓接收者看到
+static bool __not_in_flash_func(queue_push)(event_queue_t *q, const event_t *ev)
+{
+    uint pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+    event_slot_t *s;
+    while (true) {
+        s = &q->slot[pos & SLOT_MASK];
+        uint seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+        int diff = (int) (seq - pos);
+        if (diff == 0) {
+            // 失敗時 pos 會被更新成目前的寫入位置
+            if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // 這個格子還沒被讀走：滿了
+            return false;
+        } else {
+            // 別的生產者已經搶走這個位置
+            pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+        }
+    }
+    s->ev = *ev;
+    atomic_store_explicit(&s->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+bool event_queue_pop(event_queue_t *q, event_t *ev)
+{
+    event_slot_t *s = &q->slot[q->tail & SLOT_MASK];
+    if (atomic_load_explicit(&s->seq, memory_order_acquire) != q->tail + 1) return false;
+    *ev = s->ev;
+    // 下一輪同一個格子的寫入位置
+    atomic_store_explicit(&s->seq, q->tail + EVENT_QUEUE_SLOTS, memory_order_release);
+    q->tail++;
+    return true;
+}
+
+uint event_queue_count(const event_queue_t *q)
+{
+    return atomic_load_explicit(&q->head, memory_order_relaxed) - q->tail;
+}
+
+// ----------------------------------------------------------------------------
+// 門鈴
+
+//! 中斷本身就會把核心從 WFE / WFI 叫醒，這裡只要清空 FIFO；佇列由主迴圈 drain
+static void __not_in_flash_func(doorbell_isr)(void)
+{
+    while (multicore_fifo_rvalid()) (void) multicore_fifo_pop_blocking();
+    multicore_fifo_clear_irq();
+}
+
+void event_bus_doorbell_init(void)
+{
+    while (multicore_fifo_rvalid()) (void) multicore_fifo_pop_blocking();
+    multicore_fifo_clear_irq();
+    irq_set_exclusive_handler(DOORBELL_IRQ, doorbell_isr);
+    irq_set_enabled(DOORBELL_IRQ, true);
+    atomic_store(&doorbell_enabled[get_core_num()], true);
+}
+
+//! 同一個佇列在處理之前只送一次；FIFO 滿的時候對方已經有中斷待處理，不用再送
+static void __not_in_flash_func(ring_doorbell)(event_queue_t *q, uint index)
+{
+    if (!atomic_load_explicit(&doorbell_enabled[q->core], memory_order_relaxed)) return;
+    if (atomic_exchange(&q->doorbell, true)) return;
+    if (multicore_fifo_wready()) multicore_fifo_push_blocking(index);
+}
+
+// ----------------------------------------------------------------------------
+
+void event_bus_init(const char *const *names, uint count)
+{
+    topic_names = names;
+    topic_name_count = count;
+    event_bus_reset_stats();
+}
+
+bool event_queue_init(event_queue_t *q, const char *name, uint32_t topics, event_handler_fn handler, void *ctx)
+{
+    uint index = atomic_fetch_add(&queue_count, 1);
+    if (index >= EVENT_QUEUE_MAX) {
+        atomic_fetch_sub(&queue_count, 1);
+        return false;
+    }
+    for (uint i = 0; i < EVENT_QUEUE_SLOTS; i++) atomic_init(&q->slot[i].seq, i);
+    atomic_init(&q->head, 0);
+    q->tail = 0;
+    atomic_init(&q->doorbell, false);
+    atomic_init(&q->dropped, 0);
+    q->name = name;
+    q->topics = topics;
+    q->core = get_core_num();
+    q->handler = handler;
+    q->ctx = ctx;
+    q->depth_max = 0;
+    q->latency_us_max = 0;
+    // 設定完才讓發布的一方看到
+    atomic_store_explicit(&queues[index], q, memory_order_release);
+    return true;
+}
+
+bool __not_in_flash_func(event_publish)(uint topic, uint32_t arg0, uint32_t arg1)
+{
+    if (topic >= EVENT_TOPIC_MAX) return false;
+    uint core = get_core_num();
+    event_t ev = {(uint16_t) topic, (uint16_t) core, time_us_32(), {arg0, arg1}};
+    topic_counter_t *c = &counters[topic];
+    atomic_fetch_add_explicit(&c->published, 1, memory_order_relaxed);
+
+    bool ok = true;
+    uint n = MIN(atomic_load_explicit(&queue_count, memory_order_acquire), EVENT_QUEUE_MAX);
+    for (uint i = 0; i < n; i++) {
+        event_queue_t *q = atomic_load_explicit(&queues[i], memory_order_acquire);
+        if (!q || !(q->topics & EVENT_MASK(topic))) continue;
+        if (queue_push(q, &ev)) {
+            atomic_fetch_add_explicit(&c->delivered, 1, memory_order_relaxed);
+            if (q->core != core) ring_doorbell(q, i);
+        } else {
+            atomic_fetch_add_explicit(&c->dropped, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+uint event_queue_drain(event_queue_t *q, uint max)
+{
+    // 先清門鈴再讀：之後才放進來的事件會再送一次門鈴
+    atomic_store(&q->doorbell, false);
+    uint depth = event_queue_count(q);
+    if (depth > q->depth_max) q->depth_max = depth;
+
+    uint n = 0;
+    event_t ev;
+    while ((!max || n < max) && event_queue_pop(q, &ev)) {
+        uint32_t latency = time_us_32() - ev.time_us;
+        if (latency > q->latency_us_max) q->latency_us_max = latency;
+        if (q->handler) q->handler(&ev, q->ctx);
+        n++;
+    }
+    return n;
+}
+
+void event_bus_get_stats(uint topic, event_topic_stats_t *s)
+{
+    const topic_counter_t *c = &counters[topic % EVENT_TOPIC_MAX];
+    s->published = atomic_load_explicit(&c->published, memory_order_relaxed);
+    s->delivered = atomic_load_explicit(&c->delivered, memory_order_relaxed);
+    s->dropped = atomic_load_explicit(&c->dropped, memory_order_relaxed);
+}
+
+void event_bus_reset_stats(void)
+{
+    for (uint i = 0; i < EVENT_TOPIC_MAX; i++) {
+        atomic_store(&counters[i].published, 0);
+        atomic_store(&counters[i].delivered, 0);
+        atomic_store(&counters[i].dropped, 0);
+    }
+    uint n = MIN(atomic_load(&queue_count), EVENT_QUEUE_MAX);
+    for (uint i = 0; i < n; i++) {
+        event_queue_t *q = atomic_load(&queues[i]);
+        if (!q) continue;
+        atomic_store(&q->dropped, 0);
+        q->depth_max = 0;
+        q->latency_us_max = 0;
+    }
+    stats_start_us = time_us_32();
+}
+
+void event_bus_report(void)
+{
+    uint32_t elapsed_us = time_us_32() - stats_start_us;
+    float seconds = elapsed_us ? elapsed_us / 1e6f : 1.f;
+    printf("event bus (%.1f 秒)\n", seconds);
+    printf("  %-16s %10s %8s %10s %8s\n", "主題", "發布", "次/秒", "送達", "丟棄");
+    for (uint t = 0; t < EVENT_TOPIC_MAX; t++) {
+        event_topic_stats_t s;
+        event_bus_get_stats(t, &s);
+        if (!s.published) continue;
+        if (t < topic_name_count && topic_names && topic_names[t]) {
+            printf("  %-16s", topic_names[t]);
+        } else {
+            printf("  %-16u", t);
+        }
+        printf(" %10u %8.1f %10u %8u\n", (uint) s.published, s.published / seconds, (uint) s.delivered,
+               (uint) s.dropped);
+    }
+    uint n = MIN(atomic_load(&queue_count), EVENT_QUEUE_MAX);
+    for (uint i = 0; i < n; i++) {
+        event_queue_t *q = atomic_load(&queues[i]);
+        if (!q) continue;
+        printf("  佇列 %-10s core%u 丟棄 %u, 最多累積 %u/%u 筆, 最長延遲 %u us\n", q->name ? q->name : "?",
+               q->core, (uint) atomic_load(&q->dropped), q->depth_max, EVENT_QUEUE_SLOTS, (uint) q->latency_us_max);
+    }
+}
@@ -0,0 +1,114 @@
+/*!
+  \brief 無鎖事件匯流排：模組之間、core0 與 core1 之間傳遞固定大小的事件
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  每個接收者 (event_queue_t) 有自己的環狀佇列，訂閱一組主題 (topic)。
+  event_publish() 把事件複製到每個訂閱者的佇列，任何核心、中斷處理裡都可以呼叫：
+
+  - 佇列是多生產者、單一消費者 (MPSC)，每個格子有序號 (Vyukov 的 bounded queue)，
+    寫入只用 compare-and-swap，不關中斷也不用 spin lock
+  - 格子在編譯時配置好 (EVENT_QUEUE_SLOTS)，不使用 heap；佇列滿了就丟掉並計數，不會等待
+  - 接收者在另一個核心時，透過 SIO FIFO 送一個門鈴中斷把它叫醒 (同一個佇列只送一次，直到它處理)
+  - 每個主題有發布 / 送達 / 丟棄的計數，每個佇列記錄最多累積幾筆與最長延遲
+
+  用法：
+    event_bus_init(topic_names, count_of(topic_names));
+    event_queue_init(&ui_queue, "ui", EVENT_MASK(EV_BEAT) | EVENT_MASK(EV_SAVE), on_ui_event, NULL);
+    event_bus_doorbell_init();          // 在擁有佇列的核心上，multicore_launch_core1() 之後呼叫
+    ...
+    event_publish(EV_BEAT, level, 0);   // 任何地方
+    event_queue_drain(&ui_queue, 8);    // 接收者的主迴圈，一次最多處理 8 筆
+
+  \note 同一個核心上，生產者寫到一半被中斷，中斷裡又 drain 同一個佇列時，
+        後面的事件要等下一次 drain 才會取出 (順序不會亂，也不會遺失)
+  \note SIO FIFO 也被 multicore_launch_core1() 與 multicore_lockout 使用，
+        用了門鈴就不能再用 multicore_lockout (例如 flash_safe_execute)
+ */
+#pragma once
+
+#include <stdatomic.h>
+
+#include "pico/stdlib.h"
+
+#define EVENT_TOPIC_MAX     32      //<! 主題編號 0 ~ 31 (訂閱用 32-bit 遮罩)
+#define EVENT_QUEUE_MAX     8       //<! 最多幾個接收者
+#define EVENT_QUEUE_SLOTS   32      //<! 每個佇列的格子數 (2 的次方)
+
+#define EVENT_MASK(topic)   (1u << (topic))
+
+//! 事件 (16 bytes)
+typedef struct {
+    uint16_t topic;
+    uint16_t core;          //<! 發布的核心
+    uint32_t time_us;       //<! 發布的時間 (time_us_32)
+    uint32_t arg[2];
+} event_t;
+
+typedef void (*event_handler_fn)(const event_t *ev, void *ctx);
+
+typedef struct {
+    atomic_uint seq;        //<! 等於寫入位置表示可寫，等於寫入位置 + 1 表示可讀
+    event_t ev;
+} event_slot_t;
+
+//! 接收者的佇列，請配置成靜態變數
+typedef struct {
+    event_slot_t slot[EVENT_QUEUE_SLOTS];
+    atomic_uint head;       //<! 下一個寫入位置 (生產者 CAS)
+    uint tail;              //<! 下一個讀取位置 (只有接收者會改)
+    atomic_bool doorbell;   //<! 已經送出門鈴，還沒處理
+    atomic_uint dropped;
+    const char *name;
+    uint32_t topics;
+    uint core;              //<! 接收者所在的核心
+    event_handler_fn handler;
+    void *ctx;
+    uint depth_max;         //<! 最多累積幾筆 (drain 時統計)
+    uint32_t latency_us_max;//<! 發布到處理最久多少時間
+} event_queue_t;
+
+//! 每個主題的計數
+typedef struct {
+    uint32_t published;
+    uint32_t delivered;     //<! 放進佇列的次數 (每個訂閱者算一次)
+    uint32_t dropped;       //<! 佇列滿了沒放進去
+} event_topic_stats_t;
+
+/*! 設定主題名稱 (報告用)，並清除計數
+  \param names 主題名稱陣列，可以是 NULL
+ */
+void event_bus_init(const char *const *names, uint count);
+
+/*! 初始化佇列並加入匯流排，之後在這個核心上用 event_queue_drain() 處理
+  \param topics 訂閱的主題 (EVENT_MASK() 的組合)
+  \param handler drain 時對每個事件呼叫
+  \return 接收者已滿時回傳 false
+ */
+bool event_queue_init(event_queue_t *q, const char *name, uint32_t topics, event_handler_fn handler, void *ctx);
+
+//! 在目前的核心上啟用門鈴中斷 (其他核心發布的事件會把這個核心叫醒)
+void event_bus_doorbell_init(void);
+
+/*! 發布事件給所有訂閱 topic 的接收者，不會等待
+  \return 有接收者的佇列滿了 (事件沒送到) 時回傳 false
+ */
+bool event_publish(uint topic, uint32_t arg0, uint32_t arg1);
+
+//! 取出一筆事件，沒有時回傳 false (只能在接收者的核心上呼叫)
+bool event_queue_pop(event_queue_t *q, event_t *ev);
+
+/*! 取出事件並呼叫 handler
+  \param max 最多處理幾筆 (0 表示全部)，用來限制每次處理的時間
+  \return 處理的筆數
+ */
+uint event_queue_drain(event_queue_t *q, uint max);
+
+//! 佇列目前有幾筆 (大約，生產者可能同時在寫)
+uint event_queue_count(const event_queue_t *q);
+
+void event_bus_get_stats(uint topic, event_topic_stats_t *s);
+void event_bus_reset_stats(void);
+
+//! 印出每個主題的次數與每秒次數，以及每個佇列的丟棄數、最多累積筆數與最長延遲
+void event_bus_report(void);
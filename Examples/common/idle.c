@@ -0,0 +1,153 @@
+/*!
+  \brief 閒置管理
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "clock_notify.h"
+#include "idle.h"
+
+static idle_mode_t mode = IDLE_WFE;
+static idle_stats_t stats;
+static uint64_t start_us;
+
+static volatile uint32_t notify_us;
+static volatile bool notified;
+
+//! 換回原本 PLL 要多久 (平滑後的估計值)，提早這麼多醒來
+static uint32_t restore_us = 200;
+
+static const char *const mode_names[IDLE_MODE_COUNT] = {"spin", "wfe", "low"};
+
+void idle_init(idle_mode_t m)
+{
+    mode = m;
+    idle_reset_stats();
+}
+
+idle_mode_t idle_set_mode(idle_mode_t m)
+{
+    idle_mode_t old = mode;
+    if (m < IDLE_MODE_COUNT) mode = m;
+    return old;
+}
+
+const char *idle_mode_name(idle_mode_t m)
+{
+    return m < IDLE_MODE_COUNT ? mode_names[m] : "?";
+}
+
+void __not_in_flash_func(idle_notify)(void)
+{
+    notify_us = time_us_32();
+    notified = true;
+    __sev();
+}
+
+static void record_wake(uint32_t latency_us)
+{
+    stats.wakes++;
+    stats.wake_us_sum += latency_us;
+    stats.wake_us_min = MIN(stats.wake_us_min, latency_us);
+    stats.wake_us_max = MAX(stats.wake_us_max, latency_us);
+}
+
+void idle_wait_sem(semaphore_t *sem)
+{
+    if (sem_try_acquire(sem)) return;
+
+    uint32_t t0 = time_us_32();
+    notified = false;
+    idle_mode_t m = mode == IDLE_SPIN ? IDLE_SPIN : IDLE_WFE;
+    while (!sem_try_acquire(sem)) {
+        if (m == IDLE_WFE) __wfe();
+        else tight_loop_contents();
+    }
+    uint32_t now = time_us_32();
+    stats.idle_us[m] += now - t0;
+    if (notified) record_wake(now - notify_us);
+}
+
+/*! 降到 48 MHz 睡到 wake，再換回原本的 PLL
+  \return clk_sys 不是由 PLL_SYS 供應時不降頻，回傳 false
+ */
+static bool sleep_low_clock(absolute_time_t wake)
+{
+    uint32_t vco_hz;
+    uint postdiv1, postdiv2;
+    if (!clock_notify_get_sys_pll(&vco_hz, &postdiv1, &postdiv2)) return false;
+
+    uint32_t t0 = time_us_32();
+    clock_notify_set_sys_48mhz();
+    uint32_t down_us = time_us_32() - t0;
+
+    while (!best_effort_wfe_or_timeout(wake)) {}
+
+    uint32_t t1 = time_us_32();
+    clock_notify_set_sys_pll(vco_hz, postdiv1, postdiv2);
+    uint32_t up_us = time_us_32() - t1;
+
+    restore_us = (restore_us * 3 + up_us) / 4;
+    stats.clock_switches++;
+    stats.switch_us_max = MAX(stats.switch_us_max, down_us + up_us);
+    return true;
+}
+
+void idle_sleep_until(absolute_time_t until)
+{
+    int64_t remain_us = absolute_time_diff_us(get_absolute_time(), until);
+    if (remain_us <= 0) return;
+
+    uint32_t t0 = time_us_32();
+    idle_mode_t m = mode;
+    if (m == IDLE_LOW_CLOCK) {
+        // 切換本身要時間，太短的等待降頻反而划不來
+        int64_t min_us = MAX(IDLE_LOW_CLOCK_MIN_US, 4 * restore_us);
+        absolute_time_t wake = from_us_since_boot(to_us_since_boot(until) - restore_us);
+        if (remain_us < min_us || !sleep_low_clock(wake)) m = IDLE_WFE;
+    }
+    if (m == IDLE_SPIN) {
+        while (!time_reached(until)) tight_loop_contents();
+    } else {
+        while (!best_effort_wfe_or_timeout(until)) {}
+    }
+
+    stats.idle_us[m] += time_us_32() - t0;
+    int64_t late_us = absolute_time_diff_us(until, get_absolute_time());
+    record_wake(late_us > 0 ? (uint32_t) late_us : 0);
+}
+
+void idle_get_stats(idle_stats_t *s)
+{
+    *s = stats;
+    s->run_us = time_us_64() - start_us;
+}
+
+void idle_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    stats.wake_us_min = UINT32_MAX;
+    start_us = time_us_64();
+}
+
+void idle_report(void)
+{
+    idle_stats_t s;
+    idle_get_stats(&s);
+    float run = s.run_us ? (float) s.run_us : 1.f;
+    printf("idle: 模式 %s, clk_sys %u MHz, 統計 %.1f 秒\n", idle_mode_name(mode),
+           (uint) (clock_get_hz(clk_sys) / 1000000), s.run_us / 1e6f);
+    printf("  等待時間: spin %.1f%%, wfe %.1f%%, low %.1f%%\n", s.idle_us[IDLE_SPIN] * 100 / run,
+           s.idle_us[IDLE_WFE] * 100 / run, s.idle_us[IDLE_LOW_CLOCK] * 100 / run);
+    if (s.wakes) {
+        printf("  喚醒延遲: %u 次, 最小 %u us, 平均 %.1f us, 最大 %u us\n", (uint) s.wakes, (uint) s.wake_us_min,
+               (float) s.wake_us_sum / s.wakes, (uint) s.wake_us_max);
+    }
+    if (s.clock_switches) {
+        printf("  降頻: %u 次, 切換最久 %u us (下降 + 恢復)\n", (uint) s.clock_switches, (uint) s.switch_us_max);
+    }
+}
@@ -0,0 +1,75 @@
+/*!
+  \brief 閒置管理：等待 DMA / 計時器的時候讓 CPU 睡覺，並統計喚醒延遲
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  LED 的資料由 DMA + PIO 送出、EEPROM 寫入週期由晶片自己處理，這段時間 CPU 只是在等。
+  主迴圈等待的地方改呼叫 idle_wait_sem() / idle_sleep_until()，依模式決定怎麼等：
+
+  - IDLE_SPIN：一直檢查 (比較用的基準，也是耗電最多的方式)
+  - IDLE_WFE：執行 WFE 睡覺，中斷處理或 SEV 喚醒
+  - IDLE_LOW_CLOCK：計時等待的時間夠長時，先把 clk_sys 降到 48 MHz (USB PLL) 再 WFE，
+    到期前換回原本的 PLL 設定。降頻時 SDK 會關掉 PLL_SYS，換回來要重新鎖定，
+    所以會依量到的恢復時間提早醒來
+
+  \note IDLE_LOW_CLOCK 會經過 clock_notify 暫停 PIO 狀態機，LED 資料正在輸出時不能用；
+        idle_wait_sem() 不知道要等多久，所以一律只用 WFE
+
+  喚醒延遲：中斷處理呼叫 idle_notify() 記下時間，等待的一方醒來後計算經過多久；
+  計時等待則是醒來的時間減掉預定的時間。idle_report() 印出各模式的統計。
+  量測耗電時用 idle_set_mode() 固定在某個模式一段時間，搭配電流表讀數。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+#include "pico/sync.h"
+
+#define IDLE_LOW_CLOCK_MIN_US   5000    //<! 至少要睡這麼久才降頻 (另外也要超過切換時間的 4 倍)
+
+typedef enum {
+    IDLE_SPIN,
+    IDLE_WFE,
+    IDLE_LOW_CLOCK,
+    IDLE_MODE_COUNT
+} idle_mode_t;
+
+//! 統計 (us)
+typedef struct {
+    uint64_t run_us;                        //<! idle_reset_stats() 之後經過的時間
+    uint64_t idle_us[IDLE_MODE_COUNT];      //<! 每種模式實際等待的時間
+    uint32_t wakes;
+    uint32_t wake_us_min;
+    uint32_t wake_us_max;
+    uint64_t wake_us_sum;
+    uint32_t clock_switches;                //<! 降頻再換回來的次數
+    uint32_t switch_us_max;                 //<! 降頻 + 換回來最久花多少時間
+} idle_stats_t;
+
+//! 設定模式並清除統計
+void idle_init(idle_mode_t mode);
+
+//! 變更模式，回傳原本的模式
+idle_mode_t idle_set_mode(idle_mode_t mode);
+
+//! 模式名稱 ("spin"、"wfe"、"low")
+const char *idle_mode_name(idle_mode_t mode);
+
+//! 中斷處理裡呼叫：記下喚醒的時間並送出 SEV
+void idle_notify(void);
+
+//! 等到取得 semaphore
+void idle_wait_sem(semaphore_t *sem);
+
+//! 等到指定的時間
+void idle_sleep_until(absolute_time_t until);
+
+static inline void idle_sleep_ms(uint32_t ms)
+{
+    idle_sleep_until(make_timeout_time_ms(ms));
+}
+
+void idle_get_stats(idle_stats_t *s);
+void idle_reset_stats(void);
+
+//! 印出閒置比例、喚醒延遲與降頻次數
+void idle_report(void);
@@ -0,0 +1,60 @@
+/*!
+  \brief PIO 分頻的編譯期計算 (C++17，只有標頭檔)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  *_program_init() 用 float 在執行時算分頻，設錯頻率要燒進去量波形才知道。
+  這裡在編譯時算出 16.8 的定點分頻值，範圍不對直接編譯失敗：
+
+    using div = pio_clkdiv<SYS_CLK_HZ, 8000000>;    // 150 MHz → 8 MHz = 18.75
+    sm_config_set_clkdiv_int_frac8(&c, div::int_part, div::frac_part);
+
+  跟 sm_config_set_clkdiv() 一樣取最接近的分頻，actual_hz / error_ppm 是實際結果。
+  系統主頻是模板參數 (預設 SYS_CLK_HZ)；主頻在執行時改變的程式 (clock_notify) 仍要用 C 的函式。
+ */
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+
+//! 16.8 定點分頻值，1.0 ~ 65535 + 255/256
+struct clkdiv_fixed {
+    uint32_t int_part;
+    uint8_t frac_part;
+};
+
+//! 最接近 sys_hz / sm_hz 的 16.8 分頻 (sm_hz 太高時是 0，由呼叫的一方檢查)
+constexpr uint32_t clkdiv_fixed8(uint32_t sys_hz, uint64_t sm_hz)
+{
+    return (uint32_t) (((uint64_t) sys_hz * 256 + sm_hz / 2) / sm_hz);
+}
+
+template <uint32_t SysHz, uint64_t SmHz>
+struct pio_clkdiv {
+    static_assert(SmHz > 0, "state machine frequency must be positive");
+    static_assert(SmHz <= SysHz, "state machine cannot run faster than clk_sys");
+
+    static constexpr uint32_t fixed8 = clkdiv_fixed8(SysHz, SmHz);
+    static_assert(fixed8 >= 256, "divider below 1.0");
+    static_assert(fixed8 < 65536u * 256, "divider above 65535, state machine frequency too low");
+
+    static constexpr uint32_t int_part = fixed8 >> 8;
+    static constexpr uint8_t frac_part = fixed8 & 0xff;
+    static constexpr clkdiv_fixed value = {int_part, frac_part};
+
+    //! 實際的狀態機頻率
+    static constexpr double actual_hz = (double) SysHz * 256 / fixed8;
+    static constexpr double error_ppm = (actual_hz - (double) SmHz) / (double) SmHz * 1e6;
+    //! 分頻不是整數時輸出會有 1 個 clk_sys 的抖動
+    static constexpr bool is_integer = frac_part == 0;
+};
+
+//! 除錯版本檢查執行時的主頻跟編譯時假設的一樣 (NDEBUG 時沒有程式碼)
+template <uint32_t SysHz>
+inline void pio_assert_sys_hz()
+{
+    assert(clock_get_hz(clk_sys) == SysHz);
+}
@@ -0,0 +1,267 @@
+/*!
+  \brief 當機與 watchdog 重新開機的事後紀錄
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hardware/exception.h"
+#include "hardware/irq.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/watchdog.h"
+#if !defined(__riscv)
+#include "hardware/structs/m33.h"
+#endif
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio_usb.h"
+#endif
+
+#include "at24c256.h"
+#include "postmortem.h"
+
+#define PM_MAGIC    0x504d3031u     //<! "PM01"
+#define RING_MAGIC  0x54524331u     //<! "TRC1"
+#define RING_MASK   (PM_TRACE_COUNT - 1)
+
+static_assert(sizeof(pm_record_t) <= EEPROM_SIZE - EEPROM_PAGE_SIZE - PM_EEPROM_ADDR, "record does not fit the reserved EEPROM area");
+// 下面的組合語言直接寫數字
+static_assert(PM_REASON_HANG == 1 && PM_REASON_HARDFAULT == 2, "the asm below hard-codes these values");
+
+typedef struct {
+    uint32_t magic;
+    uint32_t head;
+    pm_event_t ev[PM_TRACE_COUNT];
+} ring_t;
+
+// C runtime 不會清除，watchdog 重新開機後還在 (電源重開時是亂數，所以要檢查魔術數字與 CRC)
+static pm_record_t __uninitialized_ram(capture);
+static ring_t __uninitialized_ram(ring);
+
+static pm_record_t last;            //<! 上次的紀錄
+static bool pending_save;
+static bool pending_report;
+static int alarm_num = -1;
+static uint32_t pre_us;             //<! 最後一次 pm_kick() 之後多久抓現場
+
+static uint32_t __not_in_flash_func(crc32)(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    uint32_t crc = 0xffffffff;
+    while (len--) {
+        crc ^= *p++;
+        for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static uint32_t __not_in_flash_func(record_crc)(const pm_record_t *r)
+{
+    return crc32(r, offsetof(pm_record_t, crc));
+}
+
+static inline bool is_flash_addr(uint32_t addr)
+{
+    return addr >= XIP_BASE && addr < XIP_BASE + PICO_FLASH_SIZE_BYTES;
+}
+
+// ----------------------------------------------------------------------------
+// 抓現場 (全部放在 RAM，flash 出問題時也能執行)
+
+static void __not_in_flash_func(capture_and_reboot)(uint32_t reason, uint32_t pc, uint32_t lr, uint32_t sp,
+                                                    uint32_t psr, uint32_t fault)
+{
+    capture.reason = reason;
+    capture.pc = pc;
+    capture.lr = lr;
+    capture.sp = sp;
+    capture.psr = psr;
+    capture.fault = fault;
+    capture.uptime_ms = to_ms_since_boot(get_absolute_time());
+    for (uint i = 0; i < PM_STACK_WORDS; i++) {
+        uint32_t addr = sp + 4 * i;
+        capture.stack[i] = addr >= SRAM_BASE && addr < SRAM_END ? *(uint32_t *) (uintptr_t) addr : 0;
+    }
+    // 事件環留在原地，下次開機再複製進紀錄
+    capture.trace_count = 0;
+    capture.magic = PM_MAGIC;
+    capture.crc = record_crc(&capture);
+
+    watchdog_reboot(0, 0, 0);
+    while (1) tight_loop_contents();
+}
+
+#if !defined(__riscv)
+/*! 從例外堆疊框架 (r0, r1, r2, r3, r12, lr, pc, xPSR) 取出被中斷的位置
+  \param exc_return 進入例外時的 LR，bit 4 = 0 表示框架裡還有 FPU 暫存器
+ */
+static void __attribute__((used, noinline)) __not_in_flash_func(capture_frame)(uint32_t *frame, uint32_t reason,
+                                                                              uint32_t exc_return)
+{
+    uint32_t words = (exc_return & 0x10) ? 8 : 26;
+    if (frame[7] & (1u << 9)) words++;      // 進入例外時為了 8 bytes 對齊多推了一個字
+    uint32_t fault = reason == PM_REASON_HARDFAULT ? m33_hw->cfsr : 0;
+    capture_and_reboot(reason, frame[6], frame[5], (uint32_t) (uintptr_t) (frame + words), frame[7], fault);
+}
+
+//! 依 EXC_RETURN 選 MSP 或 PSP，r0 = 框架，r1 = 原因，r2 = EXC_RETURN
+static void __attribute__((naked)) __not_in_flash_func(hang_isr)(void)
+{
+    pico_default_asm_volatile(
+        "tst lr, #4\n"
+        "ite eq\n"
+        "mrseq r0, msp\n"
+        "mrsne r0, psp\n"
+        "movs r1, #1\n"             // PM_REASON_HANG
+        "mov r2, lr\n"
+        "b capture_frame\n"
+    );
+}
+
+static void __attribute__((naked)) __not_in_flash_func(fault_isr)(void)
+{
+    pico_default_asm_volatile(
+        "tst lr, #4\n"
+        "ite eq\n"
+        "mrseq r0, msp\n"
+        "mrsne r0, psp\n"
+        "movs r1, #2\n"             // PM_REASON_HARDFAULT
+        "mov r2, lr\n"
+        "b capture_frame\n"
+    );
+}
+#else
+//! Hazard3 的中斷由 SDK 的分派程式呼叫，mepc 是被中斷的位置，LR 已經無法取得
+static void __not_in_flash_func(hang_isr)(void)
+{
+    uint32_t mepc, mcause, sp;
+    pico_default_asm_volatile("csrr %0, mepc" : "=r" (mepc));
+    pico_default_asm_volatile("csrr %0, mcause" : "=r" (mcause));
+    pico_default_asm_volatile("mv %0, sp" : "=r" (sp));
+    capture_and_reboot(PM_REASON_HANG, mepc, 0, sp, 0, mcause);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+
+bool pm_init(uint32_t timeout_ms)
+{
+    // 沒有當機時只有這個比較
+    if (capture.magic == PM_MAGIC && capture.crc == record_crc(&capture)) {
+        last = capture;
+        pending_save = pending_report = true;
+    } else if (watchdog_enable_caused_reboot()) {
+        memset(&last, 0, sizeof(last));
+        last.reason = PM_REASON_WATCHDOG;
+        pending_save = pending_report = true;
+    }
+    if (pending_save && ring.magic == RING_MAGIC) {
+        uint32_t n = MIN(ring.head, PM_TRACE_COUNT);
+        for (uint32_t i = 0; i < n; i++) last.trace[i] = ring.ev[(ring.head - n + i) & RING_MASK];
+        last.trace_count = n;
+    }
+    if (pending_save) {
+        last.magic = PM_MAGIC;
+        last.crc = record_crc(&last);
+    }
+    capture.magic = 0;
+    ring.head = 0;
+    ring.magic = RING_MAGIC;
+
+    if (timeout_ms) {
+        pre_us = timeout_ms * 750;
+        alarm_num = hardware_alarm_claim_unused(true);
+        uint irq = hardware_alarm_get_irq_num(alarm_num);
+        irq_set_exclusive_handler(irq, hang_isr);
+        // 卡在其他中斷處理裡也要能抓到
+        irq_set_priority(irq, PICO_HIGHEST_IRQ_PRIORITY);
+        hw_set_bits(&timer_hw->inte, 1u << alarm_num);
+        irq_set_enabled(irq, true);
+#if !defined(__riscv)
+        exception_set_exclusive_handler(HARDFAULT_EXCEPTION, fault_isr);
+#endif
+        watchdog_enable(timeout_ms, true);
+        pm_kick();
+    }
+    return pending_save;
+}
+
+bool pm_save(void)
+{
+    if (!pending_save) return false;
+    pending_save = false;
+    // 沒接 EEPROM 時 eeprom_wait_ready() 會一直等，先確認有回應
+    uint8_t probe;
+    if (eeprom_read_buffer(PM_EEPROM_ADDR, &probe, 1) < 0) return false;
+    eeprom_write_buffer(PM_EEPROM_ADDR, (const uint8_t *) &last, sizeof(last));
+    return true;
+}
+
+void pm_kick(void)
+{
+    watchdog_update();
+    // 寫入 alarm 暫存器就會重新啟動
+    if (alarm_num >= 0) timer_hw->alarm[alarm_num] = timer_hw->timerawl + pre_us;
+}
+
+void __not_in_flash_func(pm_trace)(const char *tag, uint32_t value)
+{
+    uint32_t save = save_and_disable_interrupts();
+    pm_event_t *e = &ring.ev[ring.head++ & RING_MASK];
+    e->time_us = time_us_32();
+    e->tag = tag;
+    e->value = value;
+    restore_interrupts(save);
+}
+
+bool pm_load(pm_record_t *r)
+{
+    if (eeprom_read_buffer(PM_EEPROM_ADDR, (uint8_t *) r, sizeof(*r)) < 0) return false;
+    return r->magic == PM_MAGIC && r->crc == record_crc(r);
+}
+
+void pm_print(const pm_record_t *r)
+{
+    static const char *const reasons[] = {"無", "主迴圈卡住", "HardFault", "watchdog 逾時 (中斷被關閉，沒有抓到現場)"};
+    printf("=== post-mortem: %s ===\n", r->reason < count_of(reasons) ? reasons[r->reason] : "?");
+    if (r->reason != PM_REASON_WATCHDOG) {
+        printf("開機後 %u ms\n", (uint) r->uptime_ms);
+#if !defined(__riscv)
+        printf("PC 0x%08x  LR 0x%08x  SP 0x%08x  xPSR 0x%08x  CFSR 0x%08x\n",
+               (uint) r->pc, (uint) r->lr, (uint) r->sp, (uint) r->psr, (uint) r->fault);
+#else
+        printf("PC 0x%08x  SP 0x%08x  mcause 0x%08x\n", (uint) r->pc, (uint) r->sp, (uint) r->fault);
+#endif
+        printf("堆疊 (* 是 flash 的位址，可能是返回位址，用 addr2line -e firmware.elf 查)：\n");
+        for (uint i = 0; i < PM_STACK_WORDS; i++) {
+            printf(" %08x%c", (uint) r->stack[i], is_flash_addr(r->stack[i]) ? '*' : ' ');
+            if (i % 4 == 3) printf("\n");
+        }
+    }
+    uint32_t n = MIN(r->trace_count, PM_TRACE_COUNT);
+    printf("最後 %u 筆事件 (時間相對於最後一筆)：\n", (uint) n);
+    for (uint32_t i = 0; i < n; i++) {
+        const pm_event_t *e = &r->trace[i];
+        int32_t dt = (int32_t) (e->time_us - r->trace[n - 1].time_us);
+        // 韌體換過的話位址可能已經不是原本的字串
+        if (is_flash_addr((uint32_t) (uintptr_t) e->tag)) {
+            printf("  %10d us  %-24s %u (0x%x)\n", (int) dt, e->tag, (uint) e->value, (uint) e->value);
+        } else {
+            printf("  %10d us  0x%08x %15s %u\n", (int) dt, (uint) (uintptr_t) e->tag, "", (uint) e->value);
+        }
+    }
+}
+
+void pm_report(void)
+{
+    if (!pending_report) return;
+#if LIB_PICO_STDIO_USB
+    if (!stdio_usb_connected()) return;
+#endif
+    pending_report = false;
+    pm_print(&last);
+}
@@ -0,0 +1,93 @@
+/*!
+  \brief 當機與 watchdog 重新開機的事後紀錄 (post-mortem)，下次開機存進 AT24C256
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  現場的板子卡住 (例如 eeprom_wait_ready() 一直等不到 ACK) 被 watchdog 重新開機後，
+  什麼線索都沒留下。這裡在 watchdog 逾時之前先用一個最高優先權的計時器中斷抓現場：
+
+  - PC / LR / SP / xPSR (Arm 從例外堆疊框架取出，RISC-V 只有 mepc)
+  - SP 往上 PM_STACK_WORDS 個字 (裡面像 flash 位址的通常是返回位址)
+  - PM_TRACE() 記錄的最後 PM_TRACE_COUNT 筆事件
+
+  紀錄與事件環都放在不會被 C runtime 清除的 RAM (__uninitialized_ram)，watchdog 重新開機後還在。
+  HardFault (Arm) 也會抓一筆，然後立刻重新開機。關中斷時卡住的話計時器中斷進不來，
+  只會留下「watchdog 逾時，沒有抓到現場」與事件環。
+
+  開機流程：
+    pm_init(2000);          // 最先呼叫，沒有當機時只檢查一個魔術數字
+    setup_i2c();            // I2C 與 eeprom_init()
+    pm_save();              // 有紀錄時寫進 EEPROM 的 PM_EEPROM_ADDR
+    ...
+    while (1) {
+        pm_kick();          // 餵狗，主迴圈停止超過 timeout 就會觸發
+        pm_report();        // USB 連上後印出一次
+    }
+
+  \note 事件字串必須是字串常數 (存的是位址，下次開機用同一份韌體印出來)
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define PM_STACK_WORDS  16
+#define PM_TRACE_COUNT  32          //<! 2 的次方
+#define PM_EEPROM_ADDR  0x7c00      //<! 場景庫之後、at24c256_bench 的最後一頁之前 (最多 960 bytes)
+
+typedef enum {
+    PM_REASON_NONE,
+    PM_REASON_HANG,             //<! 主迴圈沒有在時間內呼叫 pm_kick()
+    PM_REASON_HARDFAULT,
+    PM_REASON_WATCHDOG,         //<! watchdog 逾時，但計時器中斷沒有機會執行 (中斷被關閉)
+} pm_reason_t;
+
+//! 一筆事件
+typedef struct {
+    uint32_t time_us;
+    const char *tag;
+    uint32_t value;
+} pm_event_t;
+
+//! 存進 EEPROM 的紀錄
+typedef struct {
+    uint32_t magic;
+    uint32_t reason;            //<! pm_reason_t
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t sp;
+    uint32_t psr;
+    uint32_t fault;             //<! Arm：CFSR，RISC-V：mcause
+    uint32_t uptime_ms;
+    uint32_t stack[PM_STACK_WORDS];
+    uint32_t trace_count;
+    pm_event_t trace[PM_TRACE_COUNT];   //<! 舊的在前
+    uint32_t crc;
+} pm_record_t;
+
+/*! 檢查上次是不是當機重新開機，然後啟動 watchdog 與抓現場用的計時器中斷
+  \param timeout_ms watchdog 逾時時間，抓現場的中斷在 3/4 的時候觸發；0 表示只檢查不啟動
+  \return 有上次的紀錄 (還沒 pm_save())
+ */
+bool pm_init(uint32_t timeout_ms);
+
+/*! 把上次的紀錄寫進 EEPROM (eeprom_init() 之後呼叫)，沒有紀錄時立即返回
+  \return 有寫入
+ */
+bool pm_save(void);
+
+//! 餵狗，並把抓現場的計時器往後延
+void pm_kick(void);
+
+//! 記錄一筆事件 (中斷裡也可以呼叫)，請用 PM_TRACE()
+void pm_trace(const char *tag, uint32_t value);
+
+#define PM_TRACE(tag, value)    pm_trace("" tag, (uint32_t) (value))
+
+//! 從 EEPROM 讀回最後一筆紀錄，沒有或檢查碼錯誤時回傳 false
+bool pm_load(pm_record_t *r);
+
+//! 印出一筆紀錄
+void pm_print(const pm_record_t *r);
+
+//! 這次開機有新的紀錄時，在 USB 連上後印出一次；其他時候立即返回
+void pm_report(void);
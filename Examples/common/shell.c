@@ -0,0 +1,310 @@
+/*!
+  \brief USB 序列埠上的指令列
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "shell.h"
+
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio_usb.h"
+#endif
+
+#define KEY_CTRL_C      0x03
+#define KEY_BACKSPACE   0x08
+#define KEY_DELETE      0x7f
+
+static const char *banner;
+static const shell_param_t *params;
+static uint param_count;
+static const shell_cmd_t *cmds;
+static uint cmd_count;
+
+static char line[SHELL_LINE_MAX + 1];
+static uint line_len;
+static bool last_cr;            //<! \r\n 只算一次 Enter
+static bool connected;
+
+// watch：每隔一段時間重新執行同一行，收到任何按鍵就停止
+static char watch_line[SHELL_LINE_MAX + 1];
+static uint32_t watch_ms;
+static absolute_time_t watch_next;
+static bool watching;
+
+// ----------------------------------------------------------------------------
+// 參數
+
+static const shell_param_t *find_param(const char *name)
+{
+    for (uint i = 0; i < param_count; i++) {
+        if (!strcmp(params[i].name, name)) return &params[i];
+    }
+    return NULL;
+}
+
+float shell_param_get(const shell_param_t *p)
+{
+    switch (p->type) {
+        case SHELL_INT:   return (float) *(int *) p->value;
+        case SHELL_UINT:  return (float) *(uint *) p->value;
+        case SHELL_FLOAT: return *(float *) p->value;
+        case SHELL_BOOL:  return *(bool *) p->value ? 1.f : 0.f;
+    }
+    return 0;
+}
+
+static void print_param(const shell_param_t *p)
+{
+    switch (p->type) {
+        case SHELL_INT:   printf("%-12s %-10d", p->name, *(int *) p->value); break;
+        case SHELL_UINT:  printf("%-12s %-10u", p->name, *(uint *) p->value); break;
+        case SHELL_FLOAT: printf("%-12s %-10g", p->name, *(float *) p->value); break;
+        case SHELL_BOOL:  printf("%-12s %-10s", p->name, *(bool *) p->value ? "on" : "off"); break;
+    }
+    if (p->type == SHELL_BOOL) {
+        printf("           ");
+    } else {
+        printf(" [%g, %g]", p->min, p->max);
+    }
+    printf(" %s\n", p->help ? p->help : "");
+}
+
+//! 文字轉成數值，可以用 0x 開頭 (strtof 支援)，後面可以接 k / M (例如 800k)
+static bool parse_number(const char *text, float *out)
+{
+    char *end;
+    float v = strtof(text, &end);
+    if (end == text) return false;
+    if (*end == 'k' || *end == 'K') {
+        v *= 1e3f;
+        end++;
+    } else if (*end == 'M') {
+        v *= 1e6f;
+        end++;
+    }
+    if (*end) return false;
+    *out = v;
+    return true;
+}
+
+bool shell_param_set(const char *name, const char *text)
+{
+    const shell_param_t *p = find_param(name);
+    if (!p) {
+        printf("沒有參數 %s\n", name);
+        return false;
+    }
+
+    float v;
+    if (p->type == SHELL_BOOL) {
+        if (!strcasecmp(text, "on") || !strcasecmp(text, "true") || !strcmp(text, "1")) v = 1;
+        else if (!strcasecmp(text, "off") || !strcasecmp(text, "false") || !strcmp(text, "0")) v = 0;
+        else {
+            printf("%s 要是 on / off\n", name);
+            return false;
+        }
+    } else if (!parse_number(text, &v) || v < p->min || v > p->max) {
+        printf("%s 的範圍是 %g ~ %g\n", name, p->min, p->max);
+        return false;
+    }
+
+    // 先保留原本的值，apply 拒絕時恢復
+    union { int i; uint u; float f; bool b; } old;
+    switch (p->type) {
+        case SHELL_INT:   old.i = *(int *) p->value;   *(int *) p->value = (int) v; break;
+        case SHELL_UINT:  old.u = *(uint *) p->value;  *(uint *) p->value = (uint) v; break;
+        case SHELL_FLOAT: old.f = *(float *) p->value; *(float *) p->value = v; break;
+        case SHELL_BOOL:  old.b = *(bool *) p->value;  *(bool *) p->value = v != 0; break;
+    }
+    if (p->apply && !p->apply(p)) {
+        switch (p->type) {
+            case SHELL_INT:   *(int *) p->value = old.i; break;
+            case SHELL_UINT:  *(uint *) p->value = old.u; break;
+            case SHELL_FLOAT: *(float *) p->value = old.f; break;
+            case SHELL_BOOL:  *(bool *) p->value = old.b; break;
+        }
+        printf("%s 無法套用，維持原本的值\n", name);
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// 內建指令
+
+static int cmd_help(int argc, char **argv)
+{
+    printf("help                  列出指令\n");
+    printf("get [參數]            顯示參數\n");
+    printf("set 參數 值           設定參數\n");
+    printf("watch ms 指令...      每隔 ms 執行一次，按任意鍵停止\n");
+    for (uint i = 0; i < cmd_count; i++) printf("%-21s %s\n", cmds[i].name, cmds[i].usage ? cmds[i].usage : "");
+    return 0;
+}
+
+static int cmd_get(int argc, char **argv)
+{
+    if (argc < 2) {
+        for (uint i = 0; i < param_count; i++) print_param(&params[i]);
+        return 0;
+    }
+    for (int i = 1; i < argc; i++) {
+        const shell_param_t *p = find_param(argv[i]);
+        if (!p) {
+            printf("沒有參數 %s\n", argv[i]);
+            return 1;
+        }
+        print_param(p);
+    }
+    return 0;
+}
+
+static int cmd_set(int argc, char **argv)
+{
+    if (argc != 3) {
+        printf("用法: set 參數 值\n");
+        return 1;
+    }
+    if (!shell_param_set(argv[1], argv[2])) return 1;
+    print_param(find_param(argv[1]));
+    return 0;
+}
+
+static int cmd_watch(int argc, char **argv)
+{
+    float ms;
+    if (argc < 3 || !parse_number(argv[1], &ms) || ms < 50) {
+        printf("用法: watch ms 指令... (ms 至少 50)\n");
+        return 1;
+    }
+    // argv 指向 line 裡面，重新組成一行存起來
+    watch_line[0] = '\0';
+    for (int i = 2; i < argc; i++) {
+        if (i > 2) strncat(watch_line, " ", SHELL_LINE_MAX - strlen(watch_line));
+        strncat(watch_line, argv[i], SHELL_LINE_MAX - strlen(watch_line));
+    }
+    watch_ms = (uint32_t) ms;
+    watch_next = get_absolute_time();
+    watching = true;
+    return 0;
+}
+
+static const shell_cmd_t builtin_cmds[] = {
+        {"help",  cmd_help,  NULL},
+        {"get",   cmd_get,   NULL},
+        {"set",   cmd_set,   NULL},
+        {"watch", cmd_watch, NULL},
+};
+
+// ----------------------------------------------------------------------------
+
+void shell_init(const char *name, const shell_param_t *param_table, uint params_n,
+                const shell_cmd_t *cmd_table, uint cmds_n)
+{
+    banner = name;
+    params = param_table;
+    param_count = params_n;
+    cmds = cmd_table;
+    cmd_count = cmds_n;
+    line_len = 0;
+    watching = false;
+}
+
+static void prompt(void)
+{
+    printf("> ");
+}
+
+//! 把一行切成 argv (直接在原字串上加 '\0') 並執行
+static void execute(char *text)
+{
+    char *argv[SHELL_ARGS_MAX];
+    int argc = 0;
+    for (char *tok = strtok(text, " \t"); tok && argc < SHELL_ARGS_MAX; tok = strtok(NULL, " \t")) {
+        argv[argc++] = tok;
+    }
+    if (!argc) return;
+
+    const shell_cmd_t *found = NULL;
+    for (uint i = 0; i < count_of(builtin_cmds) && !found; i++) {
+        if (!strcmp(builtin_cmds[i].name, argv[0])) found = &builtin_cmds[i];
+    }
+    for (uint i = 0; i < cmd_count && !found; i++) {
+        if (!strcmp(cmds[i].name, argv[0])) found = &cmds[i];
+    }
+    if (!found) {
+        printf("沒有指令 %s，輸入 help 查看\n", argv[0]);
+        return;
+    }
+    int rc = found->fn(argc, argv);
+    if (rc) printf("%s 失敗 (%d)\n", argv[0], rc);
+}
+
+static void run_watch(void)
+{
+    if (!time_reached(watch_next)) return;
+    watch_next = make_timeout_time_ms(watch_ms);
+
+    // 清除畫面，游標回到左上角
+    printf("\033[2J\033[H%s    (每 %u ms，按任意鍵停止)\n\n", watch_line, (uint) watch_ms);
+    char text[SHELL_LINE_MAX + 1];
+    strcpy(text, watch_line);
+    execute(text);
+}
+
+void shell_poll(void)
+{
+#if LIB_PICO_STDIO_USB
+    // 連上的時候顯示名稱與提示字元，沒連上時不處理 (輸出會等到逾時)
+    if (!stdio_usb_connected()) {
+        connected = false;
+        return;
+    }
+#endif
+    if (!connected) {
+        connected = true;
+        printf("\n%s，輸入 help 查看指令\n", banner ? banner : "shell");
+        prompt();
+    }
+
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (watching) {
+            // 任何按鍵都停止 watch
+            watching = false;
+            printf("\n");
+            prompt();
+            continue;
+        }
+        if (c == '\n' && last_cr) {
+            last_cr = false;
+            continue;
+        }
+        last_cr = c == '\r';
+        if (c == '\r' || c == '\n') {
+            printf("\n");
+            line[line_len] = '\0';
+            line_len = 0;
+            execute(line);
+            if (!watching) prompt();
+        } else if (c == KEY_BACKSPACE || c == KEY_DELETE) {
+            if (line_len) {
+                line_len--;
+                printf("\b \b");
+            }
+        } else if (c == KEY_CTRL_C) {
+            line_len = 0;
+            printf("^C\n");
+            prompt();
+        } else if (c >= ' ' && line_len < SHELL_LINE_MAX) {
+            line[line_len++] = (char) c;
+            putchar(c);
+        }
+    }
+
+    if (watching) run_watch();
+}
@@ -0,0 +1,94 @@
+/*!
+  \brief USB 序列埠上的指令列：執行中調整參數、執行量測、持續顯示統計
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  燈數、腳位、頻率這些 #define 每改一次就要重新編譯燒錄，
+  改成登記在參數表裡之後可以直接在終端機 (例如 minicom、PuTTY) 調整：
+
+    > get                       列出所有參數
+    > set rate 250              設定參數 (超出範圍會拒絕)
+    > watch 500 stats           每 500 ms 執行一次 stats，按任意鍵停止
+    > help                      列出所有指令
+
+  #define 仍然是開機時的預設值，參數只存在 RAM，重新開機就恢復。
+
+  shell_poll() 不會阻塞，每次只處理已經收到的字元，請在主迴圈 (thread mode) 呼叫。
+  thread mode 是最低的優先權，DMA、PIO 的中斷處理都會搶先執行，解析指令不會影響輸出的時序；
+  指令與參數的 apply 函式也在 shell_poll() 裡執行。
+
+  \note 參數必須是 int、uint、float 或 bool 的變數，SHELL_PARAM() 會依變數型別自動判斷，
+        其他型別會編譯錯誤 (int32_t / uint32_t 在 Arm 上是 long，請改用 int / uint)
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define SHELL_LINE_MAX  80      //<! 一行最多幾個字元
+#define SHELL_ARGS_MAX  8       //<! 一行最多幾個參數 (含指令名稱)
+
+typedef enum {
+    SHELL_INT,
+    SHELL_UINT,
+    SHELL_FLOAT,
+    SHELL_BOOL,
+} shell_type_t;
+
+typedef struct shell_param shell_param_t;
+
+/*! 參數改變後呼叫，把新的值套用到周邊
+  \return false 表示不能套用，shell 會恢復原本的值
+ */
+typedef bool (*shell_apply_fn)(const shell_param_t *p);
+
+//! 一個可以調整的參數
+struct shell_param {
+    const char *name;
+    shell_type_t type;
+    void *value;
+    float min;
+    float max;
+    shell_apply_fn apply;   //<! NULL 表示程式下次讀取變數時自然生效
+    const char *help;
+};
+
+/*! 登記一個參數，型別依變數自動判斷
+  \code
+    static uint num_pixels = NUM_PIXELS;
+    static const shell_param_t params[] = {
+        SHELL_PARAM("pixels", num_pixels, 1, 1024, NULL, "燈數"),
+    };
+  \endcode
+ */
+#define SHELL_PARAM(name, var, min, max, apply, help) \
+    {(name), _Generic((var), int: SHELL_INT, uint: SHELL_UINT, float: SHELL_FLOAT, bool: SHELL_BOOL), \
+     &(var), (min), (max), (apply), (help)}
+
+/*! 指令
+  \param argc 參數個數，argv[0] 是指令名稱
+  \return 0 表示成功，其他值會印出錯誤
+ */
+typedef int (*shell_cmd_fn)(int argc, char **argv);
+
+typedef struct {
+    const char *name;
+    shell_cmd_fn fn;
+    const char *usage;      //<! help 顯示的說明
+} shell_cmd_t;
+
+/*! 設定參數表與指令表 (兩個表都要一直存在)
+  \param banner 第一次連上時顯示的名稱
+ */
+void shell_init(const char *banner, const shell_param_t *params, uint param_count,
+                const shell_cmd_t *cmds, uint cmd_count);
+
+//! 處理已經收到的字元，沒有輸入時立即返回
+void shell_poll(void);
+
+/*! 用文字設定參數 (與 set 指令相同)，範圍檢查後呼叫 apply
+  \return 找不到參數、格式錯誤、超出範圍或 apply 拒絕時回傳 false
+ */
+bool shell_param_set(const char *name, const char *text);
+
+//! 參數目前的值轉成 float (方便 apply 函式使用)
+float shell_param_get(const shell_param_t *p);
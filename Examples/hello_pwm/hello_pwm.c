@@ -4,8 +4,13 @@
   \date 2026-01-31
  */
 
+#include <stdio.h>
+
 #include "pico/stdlib.h"
+#include "hardware/clocks.h"
 #include "hardware/pwm.h"
+#include "clock_notify.h"
+#include "shell.h"
 
 // ------------------------------------
 // 同一個 PWM Slice 底下的兩個 Channel
@@ -19,8 +24,48 @@
 #define LED_3       8   //<! 第三顆 LED
 #define LED_4       9   //<! 第四顆 LED
 
+#define PWM_COUNTER_HZ  12000000    //<! PWM 計數器頻率，wrap 1023 時 PWM 約 11.7 kHz
+
+// ------------------------------------
+// 指令列：執行中調整 wrap 與 level，直接看亮度與解析度的變化
+// ------------------------------------
+static uint slice_num;
+static uint pwm_wrap = 1023;
+static uint level_a = 100;
+static uint level_b = 1024;
+
+static bool apply_pwm(const shell_param_t *p)
+{
+    pwm_set_wrap(slice_num, pwm_wrap);
+    pwm_set_both_levels(slice_num, level_a, level_b);
+    return true;
+}
+
+static const shell_param_t params[] = {
+        SHELL_PARAM("wrap",    pwm_wrap, 1, 65534, apply_pwm, "PWM 週期長度 (解析度)"),
+        SHELL_PARAM("level_a", level_a,  0, 65535, apply_pwm, "LED_1 的 level，佔空比 = level / (wrap + 1)"),
+        SHELL_PARAM("level_b", level_b,  0, 65535, apply_pwm, "LED_2 的 level"),
+};
+
+static int cmd_status(int argc, char **argv)
+{
+    float pwm_hz = PWM_COUNTER_HZ / (float) (pwm_wrap + 1);
+    printf("clk_sys %u MHz, PWM %.1f Hz\n", (uint) (clock_get_hz(clk_sys) / 1000000), pwm_hz);
+    printf("LED_1 %.1f%%, LED_2 %.1f%%\n", MIN(level_a, pwm_wrap + 1) * 100.f / (pwm_wrap + 1),
+           MIN(level_b, pwm_wrap + 1) * 100.f / (pwm_wrap + 1));
+    return 0;
+}
+
+static const shell_cmd_t cmds[] = {
+        {"status", cmd_status, "PWM 頻率與佔空比"},
+};
+
 int main() 
 {
+    stdio_init_all();
+    // 下面會改用 48 MHz，stdio UART 的 baudrate 也要跟著重新計算
+    clock_notify_uart(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+
     // 指派 PWM 功能給 GPIO 6(LED_1)
     gpio_set_function(LED_1, GPIO_FUNC_PWM);
     gpio_set_function(LED_2, GPIO_FUNC_PWM);
@@ -34,13 +79,19 @@ int main()
      * 所以同一個 Slice 底下的兩個 Channel (A、B) 會共用同一個頻率設定。
      * 但兩個 Channel 的「佔空比 (Duty Cycle)」可以獨立設定。
      */
-    uint slice_num = pwm_gpio_to_slice_num(LED_1);
+    slice_num = pwm_gpio_to_slice_num(LED_1);
 
     /** 決定 PWM 的「週期長度」(也可以理解為解析度)
      * 例如 Wrap = 65535 (16-bit)，你可以把亮度調成 1/65535 的微光
      * 若 Wrap = 9，你只有 0~9 共 10 個亮度等級可選。調一點點亮度就跳很大
      */
-    pwm_set_wrap(slice_num, 1023);
+    pwm_set_wrap(slice_num, pwm_wrap);
+
+    /** 計數器頻率 = 系統時鐘 / 分頻
+     * 分頻只在這裡算一次的話，系統時鐘改變 PWM 頻率就跟著變
+     * 交給 clock_notify 之後，每次改變時鐘都會重新計算，維持 PWM_COUNTER_HZ
+     */
+    clock_notify_pwm_slice(slice_num, PWM_COUNTER_HZ);
 
     /** 與 pwm_set_wrap 配合使用，設定 Channel A 的「佔空比」(Duty Cycle)
      * 如果你設 wrap = 100，然後設 level = 50 -> 輸出 50% Duty Cycle。
@@ -48,9 +99,18 @@ int main()
      * 
      * Level = (Wrap + 1) * DutyCycle
      */
-    pwm_set_chan_level(slice_num, PWM_CHAN_A, 100);     // 10% 亮度
-    pwm_set_chan_level(slice_num, PWM_CHAN_B, 1024);    // 100% 亮度
+    pwm_set_chan_level(slice_num, PWM_CHAN_A, level_a);     // 10% 亮度
+    pwm_set_chan_level(slice_num, PWM_CHAN_B, level_b);     // 100% 亮度
 
     // 啟動 PWM
     pwm_set_enabled(slice_num, true);
+
+    // 改用 48 MHz 省電，PWM 頻率與亮度都不變
+    clock_notify_set_sys_48mhz();
+
+    shell_init("hello_pwm", params, count_of(params), cmds, count_of(cmds));
+    while (1) {
+        shell_poll();
+        sleep_ms(10);
+    }
 }
@@ -0,0 +1,413 @@
+/*!
+  \brief 在電腦上測試 Art-Net / sACN 接收 (pio_ws2812/artnet_rx.c)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  三種輸入：
+
+    ./artnet_replay                 產生測試封包 (Art-Net 收齊鎖存、ArtSync、E1.31 同步鎖存)，
+                                    每個鎖存的畫面都跟預期內容比對，不一致時回傳 1
+    ./artnet_replay capture.pcap    重播 Wireshark / tcpdump 存的封包 (UDP 6454 / 5568)
+    ./artnet_replay --listen [秒]   直接從網路接收，每秒印一次統計
+
+  每個 UDP payload 都切成兩個 pbuf 的串列再送進 artnet_rx_input()，
+  跟 lwIP 收到跨 pbuf 的大封包一樣。
+  對照表：universe 1、2 接到燈條 0，universe 3、4 接到燈條 1，每個 universe 170 顆 RGB。
+ */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "artnet_rx.h"
+
+#define UNIVERSE_BYTES  510     //<! 170 顆 RGB
+#define STRIP_BYTES     (2 * UNIVERSE_BYTES)
+#define SPLIT           100     //<! 第一個 pbuf 的長度
+#define MAX_PACKET      1500
+
+static const artnet_map_t map[] = {
+    {.universe = 1, .dmx_offset = 0, .length = UNIVERSE_BYTES, .strip = 0, .strip_offset = 0},
+    {.universe = 2, .dmx_offset = 0, .length = UNIVERSE_BYTES, .strip = 0, .strip_offset = UNIVERSE_BYTES},
+    {.universe = 3, .dmx_offset = 0, .length = UNIVERSE_BYTES, .strip = 1, .strip_offset = 0},
+    {.universe = 4, .dmx_offset = 0, .length = UNIVERSE_BYTES, .strip = 1, .strip_offset = UNIVERSE_BYTES},
+};
+#define UNIVERSES (sizeof(map) / sizeof(map[0]))
+
+static uint8_t strip_data[2][STRIP_BYTES];
+static const artnet_strip_t strips[] = {
+    {strip_data[0], STRIP_BYTES},
+    {strip_data[1], STRIP_BYTES},
+};
+
+static artnet_rx_t rx;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//! 把 payload 切成兩個 pbuf 再送進接收器
+static artnet_packet_t feed(const uint8_t *payload, uint32_t len, uint64_t now_us)
+{
+    struct pbuf tail = {NULL, (void *) (payload + SPLIT), 0, 0};
+    struct pbuf head = {NULL, (void *) payload, (u16_t) len, (u16_t) len};
+    if (len > SPLIT) {
+        tail.tot_len = tail.len = (u16_t) (len - SPLIT);
+        head.next = &tail;
+        head.len = SPLIT;
+    }
+    return artnet_rx_input(&rx, &head, now_us);
+}
+
+static void print_stats(const artnet_stats_t *s, double seconds)
+{
+    printf("  packets   %u (dmx %u, sync %u, ignored %u, invalid %u), %.0f packets/s\n",
+           (unsigned) s->packets, (unsigned) s->dmx_packets, (unsigned) s->sync_packets,
+           (unsigned) s->ignored, (unsigned) s->invalid, seconds > 0 ? s->packets / seconds : 0.0);
+    printf("  latches   %u, latency avg %.1f us, max %u us\n", (unsigned) s->latches,
+           s->latches ? (double) s->latency_us_sum / s->latches : 0.0, (unsigned) s->latency_us_max);
+    printf("  sequence errors %u\n", (unsigned) s->sequence_errors);
+}
+
+// ----------------------------------------------------------------------------
+// 產生測試封包
+
+static void put16(uint8_t *b, uint16_t v)
+{
+    b[0] = (uint8_t) (v >> 8);
+    b[1] = (uint8_t) v;
+}
+
+static void put32(uint8_t *b, uint32_t v)
+{
+    put16(b, (uint16_t) (v >> 16));
+    put16(b + 2, (uint16_t) v);
+}
+
+static uint32_t artnet_dmx(uint8_t *b, uint16_t universe, uint8_t seq, const uint8_t *data, uint16_t len)
+{
+    memset(b, 0, 18);
+    memcpy(b, "Art-Net", 8);
+    b[8] = 0x00;            // OpDmx 0x5000 (little endian)
+    b[9] = 0x50;
+    put16(&b[10], 14);      // ProtVer
+    b[12] = seq;
+    b[14] = (uint8_t) universe;
+    b[15] = (uint8_t) (universe >> 8);
+    put16(&b[16], len);
+    memcpy(&b[18], data, len);
+    return 18u + len;
+}
+
+static uint32_t artnet_sync(uint8_t *b)
+{
+    memset(b, 0, 14);
+    memcpy(b, "Art-Net", 8);
+    b[9] = 0x52;            // OpSync 0x5200
+    put16(&b[10], 14);
+    return 14;
+}
+
+static void e131_root(uint8_t *b, uint32_t len, uint32_t vector)
+{
+    static const uint8_t acn_id[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+    memset(b, 0, len);
+    put16(&b[0], 0x0010);
+    memcpy(&b[4], acn_id, sizeof(acn_id));
+    put16(&b[16], (uint16_t) (0x7000 | (len - 16)));
+    put32(&b[18], vector);
+    memcpy(&b[22], "artnet_replay CID", 16);
+    put16(&b[38], (uint16_t) (0x7000 | (len - 38)));
+}
+
+static uint32_t e131_dmx(uint8_t *b, uint16_t universe, uint8_t seq, uint16_t sync_address,
+                         const uint8_t *data, uint16_t len)
+{
+    uint32_t total = 126u + len;
+    e131_root(b, total, 0x00000004);
+    put32(&b[40], 0x00000002);
+    strcpy((char *) &b[44], "artnet_replay");
+    b[108] = 100;           // priority
+    put16(&b[109], sync_address);
+    b[111] = seq;
+    put16(&b[113], universe);
+    put16(&b[115], (uint16_t) (0x7000 | (total - 115)));
+    b[117] = 0x02;
+    b[118] = 0xa1;
+    put16(&b[121], 1);
+    put16(&b[123], (uint16_t) (len + 1));
+    memcpy(&b[126], data, len);
+    return total;
+}
+
+static uint32_t e131_sync(uint8_t *b, uint8_t seq, uint16_t sync_address)
+{
+    e131_root(b, 49, 0x00000008);
+    put32(&b[40], 0x00000001);
+    b[44] = seq;
+    put16(&b[45], sync_address);
+    return 49;
+}
+
+//! 第 frame 個畫面、第 u 個 universe 的內容
+static void frame_data(uint8_t *data, uint32_t frame, uint32_t u)
+{
+    for (uint32_t i = 0; i < UNIVERSE_BYTES; i++) {
+        uint32_t x = (frame * 0x9e3779b9u) ^ (u * 0x85ebca6bu) ^ (i * 0xc2b2ae35u);
+        data[i] = (uint8_t) ((x ^ (x >> 15)) * 0x2c1b3c6du >> 24);
+    }
+}
+
+//! 鎖存的畫面跟預期內容比對
+static uint32_t check_frame(uint32_t frame)
+{
+    uint8_t want[UNIVERSE_BYTES];
+    uint32_t errors = 0;
+    for (uint32_t u = 0; u < UNIVERSES; u++) {
+        frame_data(want, frame, u);
+        if (memcmp(strip_data[map[u].strip] + map[u].strip_offset, want, UNIVERSE_BYTES)) errors++;
+    }
+    return errors;
+}
+
+/*! 分成三段：Art-Net 不送同步封包 (收齊就鎖存)、Art-Net 每個畫面送 ArtSync、
+  E1.31 每個畫面送同步封包，並且每 7 個畫面重送一次上一個畫面的舊封包 (應該被序號檢查丟掉)
+ */
+static int run_synthetic(void)
+{
+    const uint32_t frames = 4000, frame_us = 25000, packet_us = 150;
+    static uint8_t data[UNIVERSES][UNIVERSE_BYTES];
+    static uint8_t stale[MAX_PACKET];
+    uint8_t packet[MAX_PACKET];
+    uint32_t stale_len = 0, latched = 0, errors = 0;
+    uint8_t seq = 0;
+    uint64_t t = 1000;
+    double busy_ns = 0;
+
+    for (uint32_t f = 0; f < frames; f++, t += frame_us) {
+        bool artsync = f >= frames / 3 && f < frames * 2 / 3;
+        bool e131 = f >= frames * 2 / 3;
+        uint64_t now = t;
+        seq = (uint8_t) (seq + 1);
+        if (!e131 && !seq) seq = 1;     // Art-Net 的序號 0 表示不使用
+        for (uint32_t u = 0; u < UNIVERSES; u++) frame_data(data[u], f, u);
+
+        for (uint32_t u = 0; u < UNIVERSES; u++, now += packet_us) {
+            uint32_t len = e131 ? e131_dmx(packet, map[u].universe, seq, 7999, data[u], UNIVERSE_BYTES)
+                                : artnet_dmx(packet, map[u].universe, seq, data[u], UNIVERSE_BYTES);
+            double t0 = now_ns();
+            feed(packet, len, now);
+            if (e131 && stale_len && u == 1 && f % 7 == 0) feed(stale, stale_len, now);
+            busy_ns += now_ns() - t0;
+            if (u == 2) {
+                memcpy(stale, packet, len);
+                stale_len = len;
+            }
+        }
+        if (e131 || artsync) {
+            uint32_t len = e131 ? e131_sync(packet, seq, 7999) : artnet_sync(packet);
+            double t0 = now_ns();
+            feed(packet, len, now);
+            busy_ns += now_ns() - t0;
+        }
+        if (artnet_rx_take_frame(&rx)) {
+            latched++;
+            uint32_t e = check_frame(f);
+            if (e && !errors) printf("frame %u: %u universes differ\n", (unsigned) f, (unsigned) e);
+            errors += e;
+        }
+    }
+
+    artnet_stats_t s;
+    artnet_rx_get_stats(&rx, &s, false);
+    printf("synthetic stream: %u frames x %u universes (Art-Net, Art-Net + ArtSync, E1.31 + sync)\n",
+           (unsigned) frames, (unsigned) UNIVERSES);
+    print_stats(&s, (t - 1000) / 1e6);
+    printf("  processing %.0f ns/packet (%.2f Mpackets/s)\n", busy_ns / s.packets, s.packets / busy_ns * 1e3);
+    printf("  latched %u / %u frames, %u universe mismatches\n", (unsigned) latched, (unsigned) frames,
+           (unsigned) errors);
+    return (errors || latched != frames) ? 1 : 0;
+}
+
+// ----------------------------------------------------------------------------
+// pcap 重播
+
+static uint32_t rd32(const uint8_t *b, bool swap)
+{
+    uint32_t v;
+    memcpy(&v, b, 4);
+    return swap ? __builtin_bswap32(v) : v;
+}
+
+//! 從 Ethernet / Linux cooked 封包取出 UDP payload，不是 Art-Net / sACN 埠時回傳 NULL
+static const uint8_t *udp_payload(const uint8_t *frame, uint32_t len, uint32_t linktype, uint32_t *out_len)
+{
+    uint32_t off, ethertype;
+    if (linktype == 1) {            // Ethernet
+        if (len < 14) return NULL;
+        off = 14;
+        ethertype = (frame[12] << 8) | frame[13];
+        if (ethertype == 0x8100 && len >= 18) {     // VLAN
+            ethertype = (frame[16] << 8) | frame[17];
+            off = 18;
+        }
+    } else if (linktype == 113) {   // Linux cooked capture
+        if (len < 16) return NULL;
+        off = 16;
+        ethertype = (frame[14] << 8) | frame[15];
+    } else {
+        return NULL;
+    }
+    if (ethertype != 0x0800 || len < off + 20) return NULL;
+
+    const uint8_t *ip = frame + off;
+    uint32_t ihl = (ip[0] & 0x0f) * 4u;
+    if ((ip[0] >> 4) != 4 || ip[9] != 17 || (((ip[6] << 8) | ip[7]) & 0x3fff)) return NULL;    // IPv4 UDP，不處理分段
+    if (len < off + ihl + 8) return NULL;
+
+    const uint8_t *udp = ip + ihl;
+    uint32_t port = (udp[2] << 8) | udp[3];
+    uint32_t udp_len = (udp[4] << 8) | udp[5];
+    if (port != ARTNET_PORT && port != E131_PORT) return NULL;
+    if (udp_len < 8 || off + ihl + udp_len > len) return NULL;
+    *out_len = udp_len - 8;
+    return udp + 8;
+}
+
+static int run_pcap(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+
+    uint8_t gh[24];
+    if (fread(gh, 1, sizeof(gh), f) != sizeof(gh)) {
+        fprintf(stderr, "%s: not a pcap file\n", path);
+        fclose(f);
+        return 1;
+    }
+    uint32_t magic;
+    memcpy(&magic, gh, 4);
+    bool swap = magic == 0xd4c3b2a1u || magic == 0x4d3cb2a1u;
+    bool nano = magic == 0xa1b23c4du || magic == 0x4d3cb2a1u;
+    if (!swap && magic != 0xa1b2c3d4u && magic != 0xa1b23c4du) {
+        fprintf(stderr, "%s: unsupported format (pcapng is not supported, save as pcap)\n", path);
+        fclose(f);
+        return 1;
+    }
+    uint32_t linktype = rd32(&gh[20], swap);
+
+    static uint8_t frame[65536];
+    uint8_t rh[16];
+    uint64_t first_us = 0, last_us = 0;
+    uint32_t udp_packets = 0;
+    double busy_ns = 0;
+
+    while (fread(rh, 1, sizeof(rh), f) == sizeof(rh)) {
+        uint32_t caplen = rd32(&rh[8], swap);
+        if (caplen > sizeof(frame) || fread(frame, 1, caplen, f) != caplen) break;
+
+        uint64_t ts = (uint64_t) rd32(&rh[0], swap) * 1000000u + rd32(&rh[4], swap) / (nano ? 1000u : 1u);
+        uint32_t len;
+        const uint8_t *payload = udp_payload(frame, caplen, linktype, &len);
+        if (!payload || len > 0xffff) continue;
+
+        if (!udp_packets) first_us = ts;
+        last_us = ts;
+        udp_packets++;
+
+        double t0 = now_ns();
+        feed(payload, len, ts);
+        artnet_rx_take_frame(&rx);
+        busy_ns += now_ns() - t0;
+    }
+    fclose(f);
+
+    artnet_stats_t s;
+    artnet_rx_get_stats(&rx, &s, false);
+    printf("%s: %u UDP packets on port %u / %u, %.3f s\n", path, (unsigned) udp_packets,
+           ARTNET_PORT, E131_PORT, (last_us - first_us) / 1e6);
+    print_stats(&s, (last_us - first_us) / 1e6);
+    if (s.packets) printf("  processing %.0f ns/packet\n", busy_ns / s.packets);
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// 直接從網路接收
+
+static int open_udp(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int run_listen(int seconds)
+{
+    int fds[2] = {open_udp(ARTNET_PORT), open_udp(E131_PORT)};
+    if (fds[0] < 0 || fds[1] < 0) {
+        perror("bind");
+        return 1;
+    }
+    // sACN 用 multicast 239.255.<universe 高位>.<universe 低位>
+    for (uint32_t u = 0; u < UNIVERSES; u++) {
+        struct ip_mreq mreq = {0};
+        mreq.imr_multiaddr.s_addr = htonl(0xefff0000u | map[u].universe);
+        mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        setsockopt(fds[1], IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+    }
+    printf("listening on UDP %u (Art-Net) and %u (sACN)\n", ARTNET_PORT, E131_PORT);
+
+    struct pollfd pfd[2] = {{fds[0], POLLIN, 0}, {fds[1], POLLIN, 0}};
+    uint8_t packet[MAX_PACKET];
+    double start = now_ns(), report = start + 1e9;
+    while (seconds <= 0 || now_ns() - start < seconds * 1e9) {
+        if (poll(pfd, 2, 100) > 0) {
+            for (int i = 0; i < 2; i++) {
+                if (!(pfd[i].revents & POLLIN)) continue;
+                ssize_t n = recv(fds[i], packet, sizeof(packet), 0);
+                if (n > 0) feed(packet, (uint32_t) n, (uint64_t) (now_ns() / 1000));
+            }
+        }
+        artnet_rx_take_frame(&rx);
+        if (now_ns() >= report) {
+            artnet_stats_t s;
+            artnet_rx_get_stats(&rx, &s, true);
+            print_stats(&s, 1.0);
+            report += 1e9;
+        }
+    }
+    close(fds[0]);
+    close(fds[1]);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    artnet_rx_init(&rx, map, UNIVERSES, strips, 2);
+
+    if (argc >= 2 && !strcmp(argv[1], "--listen")) return run_listen(argc >= 3 ? atoi(argv[2]) : 0);
+    if (argc >= 2) return run_pcap(argv[1]);
+    return run_synthetic();
+}
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+比較兩次 common/bench.h 的量測結果 (例如改程式前後、Arm 與 RISC-V、不同編譯選項)
+
+    python3 bench_diff.py before.txt after.txt
+    python3 bench_diff.py before.txt after.txt --threshold 2
+
+輸入是序列埠的紀錄 (例如 cat /dev/ttyACM0 > after.txt)，只看 BENCH 開頭的行，其他內容忽略。
+同一個項目出現好幾次 (範例會重複量測) 時取各次中位數的中位數。
+中位數變慢超過 threshold % 的項目標為 SLOWER，有任何一項時結束碼是 1，可以放在腳本裡檢查。
+只需要 Python 標準程式庫。
+"""
+import argparse
+import statistics
+import sys
+
+
+def load(path):
+    """回傳 {(suite, name): {"median": ..., "min": ..., "max": ..., "runs": ...}} 與標頭資訊"""
+    samples = {}
+    headers = set()
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        for line in f:
+            fields = line.strip().split(",")
+            if fields[0] == "BENCH_BEGIN" and len(fields) >= 5:
+                headers.add("%s: %s, clk_sys %.1f MHz" % (fields[1], fields[2], int(fields[3]) / 1e6))
+            if fields[0] != "BENCH" or len(fields) != 7:
+                continue
+            try:
+                _, suite, name, _, lo, median, hi = fields
+                entry = samples.setdefault((suite, name), {"min": [], "median": [], "max": []})
+                entry["min"].append(int(lo))
+                entry["median"].append(int(median))
+                entry["max"].append(int(hi))
+            except ValueError:
+                continue        # 傳輸中斷造成的半行
+    results = {}
+    for key, entry in samples.items():
+        results[key] = {
+            "min": min(entry["min"]),
+            "median": statistics.median(entry["median"]),
+            "max": max(entry["max"]),
+            "runs": len(entry["median"]),
+        }
+    return results, sorted(headers)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compare two bench logs")
+    parser.add_argument("before")
+    parser.add_argument("after")
+    parser.add_argument("--threshold", type=float, default=5.0, help="percent change reported as a regression")
+    args = parser.parse_args()
+
+    before, before_hdr = load(args.before)
+    after, after_hdr = load(args.after)
+    if not before or not after:
+        print("no BENCH lines in %s" % (args.before if not before else args.after), file=sys.stderr)
+        return 2
+    for label, hdr in (("before", before_hdr), ("after", after_hdr)):
+        for h in hdr:
+            print("%-7s %s" % (label, h))
+    print()
+
+    print("%-12s %-26s %12s %12s %9s %12s %12s" % ("suite", "name", "before", "after", "change", "min before",
+                                                   "min after"))
+    slower = 0
+    for key in sorted(set(before) | set(after)):
+        suite, name = key
+        b, a = before.get(key), after.get(key)
+        if not b or not a:
+            print("%-12s %-26s   (only in %s)" % (suite, name, "before" if b else "after"))
+            continue
+        change = (a["median"] - b["median"]) / b["median"] * 100 if b["median"] else 0.0
+        mark = ""
+        if change > args.threshold:
+            mark = "SLOWER"
+            slower += 1
+        elif change < -args.threshold:
+            mark = "faster"
+        print("%-12s %-26s %12.0f %12.0f %+8.1f%% %12d %12d %s" % (suite, name, b["median"], a["median"], change,
+                                                                 b["min"], a["min"], mark))
+    print("\n%d regression(s) over %.1f%%" % (slower, args.threshold))
+    return 1 if slower else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,103 @@
+/*!
+  \brief 系統時鐘規劃工具：列出讓各周邊分頻盡量是整數的 clk_sys
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+    ./clock_plan                                    範例裡用到的周邊 (WS2812、clock_generator、I2C、PWM)
+    ./clock_plan pio:ws2812=8M i2c:eeprom=400k      自訂周邊，種類是 pio / pwm / i2c，頻率可以加 k / M
+    ./clock_plan --max 200M --vmax 1150 --top 10    允許超頻到 200 MHz (1.15 V)，列出前 10 名
+
+  第一名印出完整的誤差表，其餘只列摘要。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clock_plan.h"
+
+static double parse_hz(const char *s)
+{
+    char *end;
+    double v = strtod(s, &end);
+    if (*end == 'k' || *end == 'K') v *= 1e3;
+    if (*end == 'M' || *end == 'm') v *= 1e6;
+    return v;
+}
+
+//! pio:name=hz
+static bool parse_req(const char *arg, clock_plan_req_t *req)
+{
+    const char *colon = strchr(arg, ':');
+    const char *eq = strchr(arg, '=');
+    if (!colon || !eq || eq < colon) return false;
+
+    static char names[CLOCK_PLAN_MAX_REQS][32];
+    static int used;
+    char *name = names[used++ % CLOCK_PLAN_MAX_REQS];
+    snprintf(name, sizeof(names[0]), "%.*s", (int) (eq - colon - 1), colon + 1);
+    double hz = parse_hz(eq + 1);
+    if (hz <= 0) return false;
+
+    if (!strncmp(arg, "pio:", 4)) *req = CLOCK_REQ_PIO(name, hz);
+    else if (!strncmp(arg, "pwm:", 4)) *req = CLOCK_REQ_PWM(name, hz);
+    else if (!strncmp(arg, "i2c:", 4)) *req = CLOCK_REQ_I2C(name, hz);
+    else return false;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    clock_plan_req_t reqs[CLOCK_PLAN_MAX_REQS];
+    uint32_t count = 0;
+    clock_plan_limits_t limits = CLOCK_PLAN_LIMITS_DEFAULT;
+    uint32_t top = 5;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--max") && i + 1 < argc) limits.max_sys_hz = (uint32_t) parse_hz(argv[++i]);
+        else if (!strcmp(argv[i], "--min") && i + 1 < argc) limits.min_sys_hz = (uint32_t) parse_hz(argv[++i]);
+        else if (!strcmp(argv[i], "--vmax") && i + 1 < argc) limits.max_voltage_mv = (uint16_t) atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--top") && i + 1 < argc) top = (uint32_t) atoi(argv[++i]);
+        else if (count < CLOCK_PLAN_MAX_REQS && parse_req(argv[i], &reqs[count])) count++;
+        else {
+            fprintf(stderr, "usage: %s [pio|pwm|i2c:name=hz]... [--min hz] [--max hz] [--vmax mV] [--top n]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (!count) {
+        reqs[count++] = CLOCK_REQ_PIO("ws2812", 800000.0 * 10);      // 800 kHz x 10 cycles/bit
+        reqs[count++] = CLOCK_REQ_PIO("clk_gen", 4000000.0 * 2);     // 4 MHz x 2 instructions
+        reqs[count++] = CLOCK_REQ_I2C("eeprom", 400000.0);
+        reqs[count++] = CLOCK_REQ_PWM("hello_pwm", 12000000.0);
+    }
+    if (top < 1) top = 1;
+
+    clock_plan_t *plans = calloc(top, sizeof(clock_plan_t));
+    uint32_t found = clock_plan_rank(reqs, count, &limits, plans, top);
+    if (!found) {
+        printf("no PLL setting between %.3f and %.3f MHz up to %u mV fits all dividers\n",
+               limits.min_sys_hz / 1e6, limits.max_sys_hz / 1e6, limits.max_voltage_mv);
+        free(plans);
+        return 1;
+    }
+
+    clock_plan_print(&plans[0], reqs, count);
+    if (found > 1) printf("\nrunners-up\n");
+    for (uint32_t i = 1; i < found; i++) {
+        printf("  %8.3f MHz  VCO %4u / %u / %u  %u mV  %u/%u integral  error sum %.1f ppm\n",
+               plans[i].sys_hz / 1e6, (unsigned) (plans[i].vco_hz / 1000000), plans[i].postdiv1,
+               plans[i].postdiv2, plans[i].voltage_mv, plans[i].integral, (unsigned) count,
+               plans[i].error_ppm_sum);
+    }
+
+    // 對照預設的 150 MHz
+    clock_plan_t nominal = {.sys_hz = 150000000u};
+    for (uint32_t i = 0; i < count; i++) clock_plan_evaluate(&reqs[i], nominal.sys_hz, &nominal.results[i]);
+    printf("\nfor comparison, the default 150 MHz:\n");
+    for (uint32_t i = 0; i < count; i++) {
+        printf("  %-16s divider %12.5f  error %10.3f ppm %s\n", reqs[i].name, nominal.results[i].div,
+               nominal.results[i].error_ppm, nominal.results[i].integral ? "" : "fractional");
+    }
+    free(plans);
+    return 0;
+}
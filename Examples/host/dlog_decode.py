@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""
+延遲格式化 log (common/dlog.h) 的解碼器：用 ELF 檔把封包還原成文字
+
+    python3 dlog_decode.py build/pio_ws2812_parallel.elf /dev/ttyACM0
+    python3 dlog_decode.py build/pio_ws2812_parallel.elf capture.bin
+    cat capture.bin | python3 dlog_decode.py build/pio_ws2812_parallel.elf
+
+序列埠要先設成 raw 模式，例如 stty -F /dev/ttyACM0 raw -echo
+封包以外的位元組 (一般 printf 的文字) 照原樣輸出。
+只需要 Python 標準程式庫。
+"""
+import codecs
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+DROPPED = 0xF
+TIME_BITS = 28
+
+# printf 的轉換規格：%[flags][width][.precision][length]conversion
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXcsfFeEgGp%])")
+
+
+class Elf:
+    """只讀有載入到記憶體的 section，用位址找字串"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError(f"{path} is not an ELF file")
+        is64 = data[4] == 2
+        end = "<" if data[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(end + "Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from(end + "HH", data, 0x3A)
+            fmt = end + "IIQQQQ"
+        else:
+            shoff, = struct.unpack_from(end + "I", data, 0x20)
+            shentsize, shnum = struct.unpack_from(end + "HH", data, 0x2E)
+            fmt = end + "IIIIII"
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from(fmt, data, shoff + i * shentsize)
+            # SHF_ALLOC，SHT_NOBITS (.bss) 沒有內容
+            if flags & 2 and sh_type != 8 and size:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string(self, addr):
+        for base, content in self.sections:
+            if base <= addr < base + len(content):
+                end = content.find(b"\0", addr - base)
+                if end < 0:
+                    end = len(content)
+                return content[addr - base:end].decode("utf-8", "replace")
+        return None
+
+
+def convert(spec, word, elf):
+    """把一個 32-bit 參數依 printf 規格轉成文字"""
+    flags, width, precision, _, conv = spec
+    if width == "*":
+        width = None
+    pyfmt = "%" + flags.replace("#", "#" if conv in "oxX" else "") + (width or "")
+    if precision is not None:
+        pyfmt += "." + precision
+    if conv in "di":
+        value = word - (1 << 32) if word & 0x80000000 else word
+        return (pyfmt + "d") % value
+    if conv in "ouxX":
+        return (pyfmt + conv) % word
+    if conv == "c":
+        return (pyfmt + "c") % chr(word & 0xFF)
+    if conv == "p":
+        return (pyfmt + "s") % ("0x%08x" % word)
+    if conv == "s":
+        s = elf.string(word)
+        return (pyfmt + "s") % (s if s is not None else "<0x%08x>" % word)
+    value, = struct.unpack("<f", struct.pack("<I", word))
+    return (pyfmt + conv) % value
+
+
+def format_record(fmt, args, elf):
+    out = []
+    pos = 0
+    it = iter(args)
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        if m.group(5) == "%":
+            out.append("%")
+            continue
+        word = next(it, None)
+        out.append("<missing>" if word is None else convert(m.groups(), word, elf))
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+class Decoder:
+    def __init__(self, elf, write):
+        self.elf = elf
+        self.write = write
+        self.buf = bytearray()
+        # 中文的 UTF-8 也會有 0xA5，文字可能被切成好幾段
+        self.utf8 = codecs.getincrementaldecoder("utf-8")("replace")
+        self.last = {}      # core -> (上一筆的 28-bit 時間, 累計的高位)
+
+    def timestamp(self, core, t):
+        last, high = self.last.get(core, (0, 0))
+        if t < last:
+            high += 1 << TIME_BITS
+        self.last[core] = (t, high)
+        return (high + t) / 1e6
+
+    def feed(self, data):
+        self.buf += data
+        while self.buf:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                self.text(self.buf)
+                self.buf.clear()
+                return
+            if start:
+                self.text(self.buf[:start])
+                del self.buf[:start]
+            if len(self.buf) < 2:
+                return
+            core, kind = self.buf[1] >> 4, self.buf[1] & 0xF
+            words = 1 if kind == DROPPED else kind
+            length = 3 + 4 * words
+            if core > 1 or not (kind == DROPPED or 2 <= kind <= 6):
+                self.text(self.buf[:1])
+                del self.buf[:1]
+                continue
+            if len(self.buf) < length:
+                return
+            frame = bytes(self.buf[:length])
+            check = 0
+            for b in frame[1:-1]:
+                check ^= b
+            if check != frame[-1]:
+                # 不是封包，只是剛好有 0xA5 的文字
+                self.text(self.buf[:1])
+                del self.buf[:1]
+                continue
+            del self.buf[:length]
+            values = struct.unpack_from("<%dI" % words, frame, 2)
+            self.record(core, kind, values)
+
+    def text(self, data):
+        self.write(self.utf8.decode(bytes(data)))
+
+    def record(self, core, kind, values):
+        if kind == DROPPED:
+            self.write("[core%d] *** %d records dropped ***\n" % (core, values[0]))
+            return
+        fmt = self.elf.string(values[0])
+        t = self.timestamp(core, values[1] & ((1 << TIME_BITS) - 1))
+        if fmt is None:
+            text = "<unknown format 0x%08x> %s" % (values[0], " ".join("0x%08x" % v for v in values[2:]))
+        else:
+            text = format_record(fmt, values[2:], self.elf)
+        self.write("[core%d %12.6f] %s%s" % (core, t, text, "" if text.endswith("\n") else "\n"))
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 2
+    elf = Elf(sys.argv[1])
+    src = open(sys.argv[2], "rb", buffering=0) if len(sys.argv) > 2 else sys.stdin.buffer
+    out = sys.stdout
+
+    def write(s):
+        out.write(s)
+        out.flush()
+
+    decoder = Decoder(elf, write)
+    try:
+        while True:
+            data = src.read(4096) if src is not sys.stdin.buffer else src.read1(4096)
+            if not data:
+                break
+            decoder.feed(data)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,301 @@
+/*!
+  \brief common/event_bus.c 的多執行緒驗證：用 pthread 當成多個生產者與兩個核心
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  跟板子上同一份 event_bus.c (sdk_shim 提供 get_core_num、SIO FIFO 與中斷)，檢查：
+  - 單一執行緒：剛好放得進 EVENT_QUEUE_SLOTS 筆，之後丟棄並計數；先進先出；繞很多圈之後仍正確
+  - 多個生產者同時發布到兩個佇列 (一個在 core0，一個在 core1)：
+    每個生產者的事件依序到達、沒有重複、內容沒有被其他生產者寫壞，
+    收到的筆數 + 佇列的丟棄數 = 發布的筆數，主題計數跟實際一致
+  - 門鈴：core1 的接收者只在收到 FIFO 門鈴 (模擬中斷) 之後才 drain，
+    佇列裡有事件卻超過 1 秒沒有門鈴就是遺失喚醒
+
+  最後量測單一生產者與多個生產者競爭時每秒能發布幾筆。
+
+    ./event_bus_stress [生產者數量] [每個生產者的筆數]      (有任何錯誤時回傳 1)
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/multicore.h"
+#include "hardware/irq.h"
+#include "event_bus.h"
+
+#define MAX_PRODUCERS   16
+#define WAKE_TIMEOUT_US 1000000
+
+enum {
+    TOPIC_A,        //<! 只有 core0 的佇列
+    TOPIC_B,        //<! 只有 core1 的佇列
+    TOPIC_BOTH,     //<! 兩個佇列都訂閱
+    TOPIC_NONE,     //<! 沒有人訂閱
+    TOPIC_COUNT
+};
+
+static const char *const topic_names[TOPIC_COUNT] = {"a", "b", "both", "none"};
+
+// sdk_shim 需要的變數
+_Thread_local uint host_core_num;
+atomic_uint host_fifo_count[2];
+atomic_uint host_fifo_pushes;
+irq_handler_t host_irq_handler[2];
+
+static atomic_uint failures;
+
+#define CHECK(cond, ...) do {                               \
+    if (!(cond)) {                                          \
+        if (failures++ < 20) {                              \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+        }                                                   \
+    }                                                       \
+} while (0)
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// ----------------------------------------------------------------------------
+// 單一執行緒
+
+static void check_single_thread(void)
+{
+    static event_queue_t q;
+    CHECK(event_queue_init(&q, "single", EVENT_MASK(TOPIC_A), NULL, NULL), "init");
+
+    uint32_t next_in = 0, next_out = 0;
+    for (uint round = 0; round < 1000; round++) {
+        // 每一輪放進不同的筆數，讓寫入位置繞過陣列的各個位置
+        uint burst = 1 + round % (EVENT_QUEUE_SLOTS + 5);
+        for (uint i = 0; i < burst; i++) {
+            bool full = event_queue_count(&q) >= EVENT_QUEUE_SLOTS;
+            bool ok = event_publish(TOPIC_A, 0, next_in);
+            CHECK(ok == !full, "round %u: publish returned %d with %u queued", round, ok, event_queue_count(&q));
+            if (ok) next_in++;
+        }
+        CHECK(event_queue_count(&q) <= EVENT_QUEUE_SLOTS, "count %u", event_queue_count(&q));
+        event_t ev;
+        uint take = round % 3 ? burst : burst / 2;
+        for (uint i = 0; i < take && event_queue_pop(&q, &ev); i++) {
+            CHECK(ev.topic == TOPIC_A && ev.arg[1] == next_out, "expected %u got %u", next_out, ev.arg[1]);
+            next_out++;
+        }
+    }
+    event_t ev;
+    while (event_queue_pop(&q, &ev)) {
+        CHECK(ev.arg[1] == next_out, "expected %u got %u", next_out, ev.arg[1]);
+        next_out++;
+    }
+    CHECK(next_out == next_in, "in %u out %u", next_in, next_out);
+
+    event_topic_stats_t s;
+    event_bus_get_stats(TOPIC_A, &s);
+    CHECK(s.delivered == next_in && s.delivered + s.dropped == s.published && s.dropped == atomic_load(&q.dropped),
+          "published %u delivered %u dropped %u", s.published, s.delivered, s.dropped);
+    printf("single thread: %u in/out, %u dropped when full\n", next_in, s.dropped);
+
+    // 不再收 TOPIC_A，後面的測試才不會塞滿
+    q.topics = 0;
+}
+
+// ----------------------------------------------------------------------------
+// 多個生產者
+
+typedef struct {
+    uint id;
+    uint count;
+    pthread_t thread;
+} producer_t;
+
+typedef struct {
+    event_queue_t q;
+    uint core;
+    uint32_t next_seq[MAX_PRODUCERS];   //<! 每個生產者下一筆至少是多少
+    uint32_t received[MAX_PRODUCERS];
+    uint32_t wakes;
+    bool use_doorbell;
+    pthread_t thread;
+} consumer_t;
+
+static consumer_t consumers[2];
+static atomic_uint producers_running;
+static atomic_uint consumers_ready;
+static uint producer_count;
+
+static void *producer_main(void *arg)
+{
+    producer_t *p = arg;
+    host_core_num = 0;
+    while (atomic_load(&consumers_ready) < 2) sched_yield();
+    for (uint32_t seq = 0; seq < p->count; seq++) {
+        uint topic = seq % TOPIC_COUNT;
+        // arg[0] 放生產者與主題，arg[1] 是序號，用來檢查內容有沒有被別人寫壞
+        // 佇列滿了就讓接收者跑一下 (丟掉的那筆不重送，由計數核對)
+        if (!event_publish(topic, (p->id << 8) | topic, seq) || seq % 1024 == 0) sched_yield();
+    }
+    atomic_fetch_sub(&producers_running, 1);
+    return NULL;
+}
+
+static void on_event(const event_t *ev, void *ctx)
+{
+    consumer_t *c = ctx;
+    uint id = ev->arg[0] >> 8;
+    uint topic = ev->arg[0] & 0xff;
+    CHECK(id < producer_count && topic == ev->topic, "core%u: corrupt event %08x", c->core, ev->arg[0]);
+    if (id >= producer_count) return;
+    CHECK(c->q.topics & EVENT_MASK(ev->topic), "core%u: unsubscribed topic %u", c->core, ev->topic);
+    CHECK(ev->core == 0, "core%u: publisher core %u", c->core, ev->core);
+    CHECK(ev->arg[1] >= c->next_seq[id], "core%u: producer %u out of order, %u after %u", c->core, id, ev->arg[1],
+          c->next_seq[id]);
+    c->next_seq[id] = ev->arg[1] + 1;
+    c->received[id]++;
+}
+
+static void *consumer_main(void *arg)
+{
+    consumer_t *c = arg;
+    host_core_num = c->core;
+    uint32_t topics = c->core == 0 ? EVENT_MASK(TOPIC_A) | EVENT_MASK(TOPIC_BOTH)
+                                   : EVENT_MASK(TOPIC_B) | EVENT_MASK(TOPIC_BOTH);
+    CHECK(event_queue_init(&c->q, c->core ? "core1" : "core0", topics, on_event, c), "init");
+    if (c->use_doorbell) event_bus_doorbell_init();
+    atomic_fetch_add(&consumers_ready, 1);
+
+    uint32_t wait_start = time_us_32();
+    uint rounds = 0;
+    bool more = false;      //<! 上次 drain 達到上限，佇列可能還有
+    while (atomic_load(&producers_running) || event_queue_count(&c->q)) {
+        if (c->use_doorbell && !more) {
+            // 佇列空了就睡到門鈴的中斷 (這裡是 FIFO 有資料就呼叫中斷處理)
+            if (!multicore_fifo_rvalid()) {
+                if (event_queue_count(&c->q) && time_us_32() - wait_start > WAKE_TIMEOUT_US) {
+                    CHECK(false, "core%u: %u events queued but no doorbell (lost wakeup)", c->core,
+                          event_queue_count(&c->q));
+                    more = true;
+                }
+                sched_yield();
+                continue;
+            }
+            host_irq_handler[c->core]();
+            c->wakes++;
+        }
+        // 一次只處理一部分，偶爾放慢，讓佇列有機會滿
+        more = event_queue_drain(&c->q, 8) == 8;
+        wait_start = time_us_32();
+        if (++rounds % 64 == 0) sched_yield();
+    }
+    return NULL;
+}
+
+static void check_producers(uint count, uint per_producer)
+{
+    producer_count = count;
+    atomic_store(&producers_running, count);
+    atomic_store(&consumers_ready, 0);
+    event_bus_reset_stats();
+
+    for (uint i = 0; i < 2; i++) {
+        memset(&consumers[i], 0, sizeof(consumers[i]));
+        consumers[i].core = i;
+        consumers[i].use_doorbell = i == 1;
+        pthread_create(&consumers[i].thread, NULL, consumer_main, &consumers[i]);
+    }
+    producer_t producers[MAX_PRODUCERS];
+    for (uint i = 0; i < count; i++) {
+        producers[i] = (producer_t) {.id = i, .count = per_producer};
+        pthread_create(&producers[i].thread, NULL, producer_main, &producers[i]);
+    }
+    for (uint i = 0; i < count; i++) pthread_join(producers[i].thread, NULL);
+    for (uint i = 0; i < 2; i++) pthread_join(consumers[i].thread, NULL);
+
+    // 每個生產者發給每個佇列的筆數
+    uint32_t expected[2] = {0, 0};
+    for (uint32_t seq = 0; seq < per_producer; seq++) {
+        uint topic = seq % TOPIC_COUNT;
+        if (topic == TOPIC_A || topic == TOPIC_BOTH) expected[0]++;
+        if (topic == TOPIC_B || topic == TOPIC_BOTH) expected[1]++;
+    }
+    for (uint c = 0; c < 2; c++) {
+        uint32_t received = 0;
+        for (uint i = 0; i < count; i++) {
+            received += consumers[c].received[i];
+            CHECK(consumers[c].received[i] <= expected[c], "core%u: producer %u sent %u, received %u", c, i,
+                  expected[c], consumers[c].received[i]);
+        }
+        uint32_t dropped = atomic_load(&consumers[c].q.dropped);
+        CHECK(received + dropped == expected[c] * count, "core%u: received %u + dropped %u != %u", c, received,
+              dropped, expected[c] * count);
+        printf("  core%u: received %u, dropped %u, max depth %u/%u, doorbell wakes %u\n", c, received, dropped,
+               consumers[c].q.depth_max, EVENT_QUEUE_SLOTS, consumers[c].wakes);
+    }
+
+    uint32_t published = 0, delivered = 0, dropped = 0;
+    for (uint t = 0; t < TOPIC_COUNT; t++) {
+        event_topic_stats_t s;
+        event_bus_get_stats(t, &s);
+        uint subscribers = t == TOPIC_BOTH ? 2 : t == TOPIC_NONE ? 0 : 1;
+        CHECK(s.delivered + s.dropped == s.published * subscribers, "topic %s: %u + %u != %u x %u", topic_names[t],
+              s.delivered, s.dropped, s.published, subscribers);
+        published += s.published;
+        delivered += s.delivered;
+        dropped += s.dropped;
+    }
+    CHECK(published == count * per_producer, "published %u", published);
+    CHECK(dropped == atomic_load(&consumers[0].q.dropped) + atomic_load(&consumers[1].q.dropped), "dropped %u", dropped);
+    printf("%u producers x %u: published %u, delivered %u, dropped %u, FIFO doorbells %u\n", count, per_producer,
+           published, delivered, dropped, atomic_load(&host_fifo_pushes));
+}
+
+// ----------------------------------------------------------------------------
+// 量測
+
+static void bench_publish(void)
+{
+    // core0 的佇列在測試結束後沒人 drain，改成不訂閱，只量發布本身 (計數 + 沒有接收者)
+    consumers[0].q.topics = 0;
+    consumers[1].q.topics = 0;
+    host_core_num = 0;
+    const uint n = 2000000;
+    uint64_t t0 = now_ns();
+    for (uint i = 0; i < n; i++) event_publish(TOPIC_NONE, i, i);
+    uint64_t ns = now_ns() - t0;
+    printf("BM_publish_no_subscriber %10.1f ns %12.0f events/s\n", (double) ns / n, n * 1e9 / ns);
+
+    // 一個接收者：發布後立刻取出
+    static event_queue_t q;
+    if (!event_queue_init(&q, "bench", EVENT_MASK(TOPIC_A), NULL, NULL)) return;
+    event_t ev;
+    t0 = now_ns();
+    for (uint i = 0; i < n; i++) {
+        event_publish(TOPIC_A, i, i);
+        event_queue_pop(&q, &ev);
+    }
+    ns = now_ns() - t0;
+    printf("BM_publish_pop           %10.1f ns %12.0f events/s\n", (double) ns / n, n * 1e9 / ns);
+}
+
+int main(int argc, char **argv)
+{
+    uint count = argc > 1 ? (uint) atoi(argv[1]) : 4;
+    uint per_producer = argc > 2 ? (uint) atoi(argv[2]) : 200000;
+    if (count < 1 || count > MAX_PRODUCERS) count = 4;
+
+    event_bus_init(topic_names, TOPIC_COUNT);
+    check_single_thread();
+    check_producers(count, per_producer);
+    event_bus_report();
+    bench_publish();
+
+    uint n = atomic_load(&failures);
+    printf("%s (%u failures)\n", n ? "FAILED" : "OK", n);
+    return n ? 1 : 0;
+}
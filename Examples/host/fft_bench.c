@@ -0,0 +1,106 @@
+/*!
+  \brief 在電腦上比對 Q15 FFT 與 double 精度 DFT，並量測執行時間
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  誤差以 SNR (dB) 表示：參考值是對同一組「已量化、已乘視窗」的輸入
+  做 double 精度 DFT 再除以 N，所以量到的只有 FFT 本身的捨入誤差。
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "audio_fft.h"
+
+#define N AUDIO_FFT_SIZE
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//! 回傳 SNR (dB)，max_err 為單一 bin 最大誤差 (LSB)
+static double compare(const int16_t *samples, double *max_err)
+{
+    static cq15_t x[N];
+    static cq15_t ref_in[N];
+    const double pi = 3.14159265358979323846;
+
+    audio_fft_load(x, samples);
+    // 取出乘過視窗的輸入 (x 目前是 bit reversal 順序)
+    for (unsigned i = 0; i < N; i++) {
+        unsigned r = 0;
+        for (unsigned b = 0; b < AUDIO_FFT_LOG2; b++) {
+            if (i & (1u << b)) r |= 1u << (AUDIO_FFT_LOG2 - 1 - b);
+        }
+        ref_in[i] = x[r];
+    }
+    audio_fft(x);
+
+    double sig = 0, noise = 0;
+    *max_err = 0;
+    for (unsigned k = 0; k < N; k++) {
+        double re = 0, im = 0;
+        for (unsigned n = 0; n < N; n++) {
+            double a = -2.0 * pi * (double) k * n / N;
+            re += ref_in[n].re * cos(a);
+            im += ref_in[n].re * sin(a);
+        }
+        re /= N;
+        im /= N;
+        double er = x[k].re - re, ei = x[k].im - im;
+        sig += re * re + im * im;
+        noise += er * er + ei * ei;
+        double e = sqrt(er * er + ei * ei);
+        if (e > *max_err) *max_err = e;
+    }
+    if (noise == 0) return INFINITY;
+    return 10.0 * log10(sig / noise);
+}
+
+int main(void)
+{
+    static int16_t samples[N];
+    const double pi = 3.14159265358979323846;
+    double snr, max_err;
+
+    audio_fft_init();
+
+    printf("Q15 FFT, N = %u\n\n", N);
+    printf("%-24s %10s %12s\n", "input", "SNR (dB)", "max err LSB");
+
+    for (unsigned i = 0; i < N; i++) samples[i] = (int16_t) (32000 * sin(2 * pi * 10.0 * i / N));
+    snr = compare(samples, &max_err);
+    printf("%-24s %10.1f %12.2f\n", "sine, bin 10, -0 dBFS", snr, max_err);
+
+    for (unsigned i = 0; i < N; i++) samples[i] = (int16_t) (1000 * sin(2 * pi * 37.3 * i / N));
+    snr = compare(samples, &max_err);
+    printf("%-24s %10.1f %12.2f\n", "sine, bin 37.3, -30 dBFS", snr, max_err);
+
+    for (unsigned i = 0; i < N; i++) {
+        samples[i] = (int16_t) (12000 * sin(2 * pi * 3.0 * i / N) + 8000 * sin(2 * pi * 90.0 * i / N));
+    }
+    snr = compare(samples, &max_err);
+    printf("%-24s %10.1f %12.2f\n", "two tones", snr, max_err);
+
+    srand(1);
+    for (unsigned i = 0; i < N; i++) samples[i] = (int16_t) ((rand() & 0xffff) - 0x8000);
+    snr = compare(samples, &max_err);
+    printf("%-24s %10.1f %12.2f\n", "white noise, full scale", snr, max_err);
+
+    // 效能
+    static cq15_t x[N];
+    const int loops = 20000;
+    double t0 = now_ns();
+    for (int i = 0; i < loops; i++) {
+        audio_fft_load(x, samples);
+        audio_fft(x);
+    }
+    double ns = (now_ns() - t0) / loops;
+    printf("\nload + fft: %.0f ns per %u-point FFT (host)\n", ns, N);
+
+    return 0;
+}
@@ -0,0 +1,402 @@
+/*!
+  \brief fixmath (定點 sin / cos、緩動曲線、noise) 與 libm 的精度比較與執行時間
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  精度表：
+  - fx_sin / fx_cos：所有 65536 個角度與 sin() / cos() 比較
+  - fx_ease：t 從 0 到 1 每個 Q16 值與 double 的公式比較，並檢查兩端剛好是 0 與 1
+  - fx_noise1 / 2 / 3：與浮點數的 improved Perlin noise (同一個排列表與梯度) 比較，
+    列出輸出範圍；並檢查 fx_noise*_span 跟逐點呼叫的結果完全相同
+  誤差單位是 LSB (1 / 65536)。
+
+  量測 (google benchmark 的格式)：每次算 SPAN 個像素，定點與浮點版本並列。
+
+    ./fixmath_bench               驗證 + 量測
+    ./fixmath_bench --no-bench    只驗證 (有任何錯誤時回傳 1)
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fixmath.h"
+
+#define SPAN            64          //<! 每次量測的像素數 (一條燈條)
+#define NOISE_SAMPLES   200000
+#define BENCH_MIN_NS    50e6
+
+#define SIN_MAX_LSB     2
+#define EASE_MAX_LSB    8
+#define NOISE_MAX_LSB   64
+
+static uint32_t failures;
+
+#define CHECK(cond, ...)                    \
+    do {                                    \
+        if (!(cond)) {                      \
+            if (failures++ < 20) {          \
+                printf("FAIL: " __VA_ARGS__); \
+                putchar('\n');              \
+            }                               \
+        }                                   \
+    } while (0)
+
+static const double pi = 3.14159265358979323846;
+
+//! 誤差統計
+typedef struct {
+    double max;
+    double sum_sq;
+    double lo, hi;          //<! 參考值的範圍
+    uint32_t n;
+} err_t;
+
+static void err_init(err_t *e)
+{
+    *e = (err_t) {0, 0, INFINITY, -INFINITY, 0};
+}
+
+static void err_add(err_t *e, fx16_t got, double ref)
+{
+    double d = fabs(got - ref * FX16_ONE);
+    if (d > e->max) e->max = d;
+    e->sum_sq += d * d;
+    if (ref < e->lo) e->lo = ref;
+    if (ref > e->hi) e->hi = ref;
+    e->n++;
+}
+
+static double err_rms(const err_t *e)
+{
+    return e->n ? sqrt(e->sum_sq / e->n) : 0;
+}
+
+static uint32_t rng_state = 1;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// ----------------------------------------------------------------------------
+// 浮點數的參考 noise：跟 fixmath.c 同一個排列表與梯度，用一般的寫法 (每個格點各自內積再內插)
+
+static const uint8_t perm[256] = {
+    151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225,
+    140,  36, 103,  30,  69, 142,   8,  99,  37, 240,  21,  10,  23, 190,   6, 148,
+    247, 120, 234,  75,   0,  26, 197,  62,  94, 252, 219, 203, 117,  35,  11,  32,
+     57, 177,  33,  88, 237, 149,  56,  87, 174,  20, 125, 136, 171, 168,  68, 175,
+     74, 165,  71, 134, 139,  48,  27, 166,  77, 146, 158, 231,  83, 111, 229, 122,
+     60, 211, 133, 230, 220, 105,  92,  41,  55,  46, 245,  40, 244, 102, 143,  54,
+     65,  25,  63, 161,   1, 216,  80,  73, 209,  76, 132, 187, 208,  89,  18, 169,
+    200, 196, 135, 130, 116, 188, 159,  86, 164, 100, 109, 198, 173, 186,   3,  64,
+     52, 217, 226, 250, 124, 123,   5, 202,  38, 147, 118, 126, 255,  82,  85, 212,
+    207, 206,  59, 227,  47,  16,  58,  17, 182, 189,  28,  42, 223, 183, 170, 213,
+    119, 248, 152,   2,  44, 154, 163,  70, 221, 153, 101, 155, 167,  43, 172,   9,
+    129,  22,  39, 253,  19,  98, 108, 110,  79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246,  97, 228, 251,  34, 242, 193, 238, 210, 144,  12, 191, 179, 162, 241,
+     81,  51, 145, 235, 249,  14, 239, 107,  49, 192, 214,  31, 181, 199, 106, 157,
+    184,  84, 204, 176, 115, 121,  50,  45, 127,   4, 150, 254, 138, 236, 205,  93,
+    222, 114,  67,  29,  24,  72, 243, 141, 128, 195,  78,  66, 215,  61, 156, 180,
+};
+
+#define P(i)    perm[(i) & 0xff]
+
+static float ref_fade(float t)
+{
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+static float ref_lerp(float a, float b, float t)
+{
+    return a + (b - a) * t;
+}
+
+static float ref_clamp(float n)
+{
+    return n > 1 ? 1 : n < -1 ? -1 : n;
+}
+
+static float ref_grad1(uint h, float x)
+{
+    float g = (float) ((h & 7) + 1) / 4;
+    return (h & 8 ? -g : g) * x;
+}
+
+static float ref_grad2(uint h, float x, float y)
+{
+    return (h & 1 ? -x : x) + (h & 2 ? -y : y);
+}
+
+//! Ken Perlin 的 improved noise 原本的 grad()
+static float ref_grad3(uint h, float x, float y, float z)
+{
+    h &= 15;
+    float u = h < 8 ? x : y;
+    float v = h < 4 ? y : h == 12 || h == 14 ? x : z;
+    return (h & 1 ? -u : u) + (h & 2 ? -v : v);
+}
+
+//! 座標與 fixmath 相同，Q16.16
+static float ref_noise1(uint32_t x)
+{
+    uint xi = x >> 16;
+    float xf = (x & 0xffff) / 65536.f;
+    return ref_clamp(ref_lerp(ref_grad1(P(xi), xf), ref_grad1(P(xi + 1), xf - 1), ref_fade(xf)));
+}
+
+static float ref_noise2(uint32_t x, uint32_t y)
+{
+    uint xi = x >> 16, yi = y >> 16;
+    float xf = (x & 0xffff) / 65536.f, yf = (y & 0xffff) / 65536.f;
+    float u = ref_fade(xf), v = ref_fade(yf);
+    uint a = P(xi), b = P(xi + 1);
+    float n0 = ref_lerp(ref_grad2(P(a + yi), xf, yf), ref_grad2(P(b + yi), xf - 1, yf), u);
+    float n1 = ref_lerp(ref_grad2(P(a + yi + 1), xf, yf - 1), ref_grad2(P(b + yi + 1), xf - 1, yf - 1), u);
+    return ref_clamp(ref_lerp(n0, n1, v));
+}
+
+static float ref_noise3(uint32_t x, uint32_t y, uint32_t z)
+{
+    uint xi = x >> 16, yi = y >> 16, zi = z >> 16;
+    float xf = (x & 0xffff) / 65536.f, yf = (y & 0xffff) / 65536.f, zf = (z & 0xffff) / 65536.f;
+    float u = ref_fade(xf), v = ref_fade(yf), w = ref_fade(zf);
+    uint a = P(xi) + yi, aa = P(a) + zi, ab = P(a + 1) + zi;
+    uint b = P(xi + 1) + yi, ba = P(b) + zi, bb = P(b + 1) + zi;
+    float n00 = ref_lerp(ref_grad3(P(aa), xf, yf, zf), ref_grad3(P(ba), xf - 1, yf, zf), u);
+    float n10 = ref_lerp(ref_grad3(P(ab), xf, yf - 1, zf), ref_grad3(P(bb), xf - 1, yf - 1, zf), u);
+    float n01 = ref_lerp(ref_grad3(P(aa + 1), xf, yf, zf - 1), ref_grad3(P(ba + 1), xf - 1, yf, zf - 1), u);
+    float n11 = ref_lerp(ref_grad3(P(ab + 1), xf, yf - 1, zf - 1), ref_grad3(P(bb + 1), xf - 1, yf - 1, zf - 1), u);
+    return ref_clamp(ref_lerp(ref_lerp(n00, n10, v), ref_lerp(n01, n11, v), w));
+}
+
+// ----------------------------------------------------------------------------
+// 精度
+
+static void print_err(const char *name, const err_t *e)
+{
+    printf("  %-16s %10.2f %10.3f %10.4f %10.4f\n", name, e->max, err_rms(e), e->lo, e->hi);
+}
+
+static void check_sin(void)
+{
+    err_t es, ec, e8;
+    err_init(&es);
+    err_init(&ec);
+    err_init(&e8);
+    for (uint a = 0; a < 65536; a++) {
+        double rad = 2 * pi * a / 65536;
+        err_add(&es, fx_sin((uint16_t) a), sin(rad));
+        err_add(&ec, fx_cos((uint16_t) a), cos(rad));
+        // 8 位元的誤差換算成 Q16 (1 個 8 位元單位 = 257 LSB)
+        err_add(&e8, fx_wave8((uint16_t) a) * 257, (sin(rad) + 1) / 2 * 65535 / 65536);
+    }
+    CHECK(es.max <= SIN_MAX_LSB, "fx_sin max error %.2f LSB", es.max);
+    CHECK(ec.max <= SIN_MAX_LSB, "fx_cos max error %.2f LSB", ec.max);
+    CHECK(e8.max <= 129, "fx_wave8 off by more than half a step");
+    CHECK(fx_sin(0) == 0 && fx_sin(16384) == FX16_ONE && fx_sin(32768) == 0 && fx_sin(49152) == -FX16_ONE,
+          "fx_sin not exact at 0/90/180/270");
+    print_err("fx_sin", &es);
+    print_err("fx_cos", &ec);
+    print_err("fx_wave8", &e8);
+}
+
+static double ref_ease(fx_ease_t kind, double t)
+{
+    double r = 1 - t;
+    switch (kind) {
+    case FX_EASE_IN_QUAD:       return t * t;
+    case FX_EASE_OUT_QUAD:      return 1 - r * r;
+    case FX_EASE_IN_OUT_QUAD:   return t < 0.5 ? 2 * t * t : 1 - 2 * r * r;
+    case FX_EASE_IN_CUBIC:      return t * t * t;
+    case FX_EASE_OUT_CUBIC:     return 1 - r * r * r;
+    case FX_EASE_IN_OUT_CUBIC:  return t < 0.5 ? 4 * t * t * t : 1 - 4 * r * r * r;
+    case FX_EASE_IN_SINE:       return 1 - cos(t * pi / 2);
+    case FX_EASE_OUT_SINE:      return sin(t * pi / 2);
+    case FX_EASE_IN_OUT_SINE:   return (1 - cos(t * pi)) / 2;
+    case FX_EASE_SMOOTHSTEP:    return t * t * (3 - 2 * t);
+    case FX_EASE_SMOOTHERSTEP:  return t * t * t * (t * (t * 6 - 15) + 10);
+    default:                    return t;
+    }
+}
+
+static void check_ease(void)
+{
+    for (int k = 0; k < FX_EASE_COUNT; k++) {
+        err_t e;
+        err_init(&e);
+        fx16_t prev = 0;
+        bool monotonic = true;
+        for (fx16_t t = 0; t <= FX16_ONE; t++) {
+            fx16_t v = fx_ease(k, t);
+            err_add(&e, v, ref_ease(k, t / 65536.0));
+            if (v < prev) monotonic = false;
+            prev = v;
+        }
+        CHECK(e.max <= EASE_MAX_LSB, "%s max error %.2f LSB", fx_ease_name(k), e.max);
+        CHECK(fx_ease(k, 0) == 0 && fx_ease(k, FX16_ONE) == FX16_ONE, "%s endpoints not 0 and 1", fx_ease_name(k));
+        CHECK(fx_ease(k, -100) == 0 && fx_ease(k, 2 * FX16_ONE) == FX16_ONE, "%s not clamped", fx_ease_name(k));
+        CHECK(monotonic, "%s not monotonic", fx_ease_name(k));
+        print_err(fx_ease_name(k), &e);
+    }
+}
+
+static void check_noise(void)
+{
+    err_t e1, e2, e3;
+    err_init(&e1);
+    err_init(&e2);
+    err_init(&e3);
+    fx16_t lo = FX16_ONE, hi = -FX16_ONE;
+    for (uint i = 0; i < NOISE_SAMPLES; i++) {
+        uint32_t x = rng(), y = rng(), z = rng();
+        fx16_t n1 = fx_noise1(x), n2 = fx_noise2(x, y), n3 = fx_noise3(x, y, z);
+        err_add(&e1, n1, ref_noise1(x));
+        err_add(&e2, n2, ref_noise2(x, y));
+        err_add(&e3, n3, ref_noise3(x, y, z));
+        lo = MIN(lo, MIN(n1, MIN(n2, n3)));
+        hi = MAX(hi, MAX(n1, MAX(n2, n3)));
+    }
+    CHECK(e1.max <= NOISE_MAX_LSB, "fx_noise1 max error %.2f LSB", e1.max);
+    CHECK(e2.max <= NOISE_MAX_LSB, "fx_noise2 max error %.2f LSB", e2.max);
+    CHECK(e3.max <= NOISE_MAX_LSB, "fx_noise3 max error %.2f LSB", e3.max);
+    CHECK(lo >= -FX16_ONE && hi <= FX16_ONE, "noise out of range");
+    CHECK(fx_noise2(5 << 16, 9 << 16) == 0 && fx_noise3(1 << 16, 2 << 16, 3 << 16) == 0, "noise not 0 on the lattice");
+    print_err("fx_noise1", &e1);
+    print_err("fx_noise2", &e2);
+    print_err("fx_noise3", &e3);
+
+    // span 版本逐點相同 (包含 x 溢位繞回)
+    fx16_t span[SPAN];
+    for (uint r = 0; r < 2000; r++) {
+        uint32_t x = rng(), y = rng(), z = rng(), dx = rng() >> (8 + r % 16);
+        if (r == 0) x = 0xffff0000u;
+        fx_noise1_span(span, SPAN, x, dx);
+        for (uint i = 0; i < SPAN; i++) CHECK(span[i] == fx_noise1(x + i * dx), "fx_noise1_span differs at %u", i);
+        fx_noise2_span(span, SPAN, x, dx, y);
+        for (uint i = 0; i < SPAN; i++) CHECK(span[i] == fx_noise2(x + i * dx, y), "fx_noise2_span differs at %u", i);
+        fx_noise3_span(span, SPAN, x, dx, y, z);
+        for (uint i = 0; i < SPAN; i++) CHECK(span[i] == fx_noise3(x + i * dx, y, z), "fx_noise3_span differs at %u", i);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// 量測
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef void (*bench_fn)(uint32_t iter);
+
+//! 次數加倍直到總時間超過 BENCH_MIN_NS，另外列出每個像素的時間
+static void run_bench(const char *name, bench_fn fn)
+{
+    uint32_t iters = 1;
+    double ns;
+    for (;;) {
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < iters; i++) fn(i);
+        ns = now_ns() - t0;
+        if (ns >= BENCH_MIN_NS || iters >= (1u << 30)) break;
+        iters *= ns < BENCH_MIN_NS / 100 ? 10 : 2;
+    }
+    printf("BM_%-26s %12.1f ns %12u %10.2f ns/px\n", name, ns / iters, (uint) iters, ns / iters / SPAN);
+}
+
+static fx16_t out_fx[SPAN];
+static float out_f[SPAN];
+
+//! 跟 google benchmark 的 DoNotOptimize() 一樣：讓編譯器認定輸出會被讀取，不能把迴圈整個省掉
+static inline void clobber(const void *p)
+{
+    __asm__ volatile("" : : "r"(p) : "memory");
+}
+
+// 每個像素的角度、位置都跟著 i 變，避免編譯器把迴圈外提
+static void bm_fx_sin(uint32_t it)
+{
+    for (uint i = 0; i < SPAN; i++) out_fx[i] = fx_sin((uint16_t) (it * 97 + i * 1031));
+    clobber(out_fx);
+}
+
+static void bm_sinf(uint32_t it)
+{
+    for (uint i = 0; i < SPAN; i++) out_f[i] = sinf((float) (it * 97 + i * 1031) * (float) (2 * pi / 65536));
+    clobber(out_f);
+}
+
+static void bm_fx_ease(uint32_t it)
+{
+    for (uint i = 0; i < SPAN; i++) out_fx[i] = fx_ease(FX_EASE_IN_OUT_SINE, (it * 31 + i * 1024) & 0xffff);
+    clobber(out_fx);
+}
+
+static void bm_ease_float(uint32_t it)
+{
+    for (uint i = 0; i < SPAN; i++) out_f[i] = (1 - cosf(((it * 31 + i * 1024) & 0xffff) / 65536.f * (float) pi)) / 2;
+    clobber(out_f);
+}
+
+static void bm_fx_noise1_span(uint32_t it) { fx_noise1_span(out_fx, SPAN, it << 10, 0x2000); clobber(out_fx); }
+static void bm_fx_noise2_span(uint32_t it) { fx_noise2_span(out_fx, SPAN, it << 10, 0x2000, it << 8); clobber(out_fx); }
+static void bm_fx_noise3_span(uint32_t it) { fx_noise3_span(out_fx, SPAN, it << 10, 0x2000, 0x18000, it << 8); clobber(out_fx); }
+
+static void bm_fx_noise2_point(uint32_t it)
+{
+    for (uint i = 0; i < SPAN; i++) out_fx[i] = fx_noise2((it << 10) + i * 0x2000, it << 8);
+    clobber(out_fx);
+}
+
+static void bm_fx_noise3_point(uint32_t it)
+{
+    for (uint i = 0; i < SPAN; i++) out_fx[i] = fx_noise3((it << 10) + i * 0x2000, 0x18000, it << 8);
+    clobber(out_fx);
+}
+
+static void bm_float_noise2(uint32_t it)
+{
+    for (uint i = 0; i < SPAN; i++) out_f[i] = ref_noise2((it << 10) + i * 0x2000, it << 8);
+    clobber(out_f);
+}
+
+static void bm_float_noise3(uint32_t it)
+{
+    for (uint i = 0; i < SPAN; i++) out_f[i] = ref_noise3((it << 10) + i * 0x2000, 0x18000, it << 8);
+    clobber(out_f);
+}
+
+int main(int argc, char **argv)
+{
+    bool bench = !(argc > 1 && !strcmp(argv[1], "--no-bench"));
+
+    printf("%-18s %10s %10s %10s %10s\n", "vs libm / float", "max LSB", "rms LSB", "min", "max");
+    check_sin();
+    check_ease();
+    check_noise();
+    printf("%u failure(s)\n", (uint) failures);
+
+    if (bench && !failures) {
+        printf("\n%-29s %15s %12s %16s\n", "Benchmark", "Time", "Iterations", "Per pixel");
+        run_bench("fx_sin", bm_fx_sin);
+        run_bench("sinf", bm_sinf);
+        run_bench("fx_ease_in_out_sine", bm_fx_ease);
+        run_bench("ease_in_out_sine_float", bm_ease_float);
+        run_bench("fx_noise1_span", bm_fx_noise1_span);
+        run_bench("fx_noise2_span", bm_fx_noise2_span);
+        run_bench("fx_noise2_point", bm_fx_noise2_point);
+        run_bench("noise2_float", bm_float_noise2);
+        run_bench("fx_noise3_span", bm_fx_noise3_span);
+        run_bench("fx_noise3_point", bm_fx_noise3_point);
+        run_bench("noise3_float", bm_float_noise3);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,371 @@
+/*!
+  \brief 不需要硬體的邏輯在電腦上驗證與量測 (sdk_shim 提供最小的 Pico SDK 標頭)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  用板子上同一份原始碼 (settings.c、common/at24c256.c、ws2812_planes.c、ws2812_patterns.c、fixmath.c)，
+  搭配一個 AT24C256 的記憶體模型 (寫入超過頁尾會繞回頁首，跟真的晶片一樣)，檢查：
+  - calc_checksum 等於所有 bytes 的累加，settings_save / settings_init 來回一致
+  - eeprom_write_buffer 的每次寫入都不跨 64 bytes 的頁，寫完的內容與讀回一致
+  - add_error 等於整數加法 (小數 planes 相加、進位到整數部分)
+  - dither_values 連續 N 個 frame 的輸出總和剛好等於 N * 顏色值 (誤差不會遺失)
+  - transform_strips 與逐 byte 參考實作 + 逐 bit 轉置一致
+  - 燈效只寫 len 個像素，RGBW 的 W 是 0，同一個 t 畫出來的結果相同
+
+  再以 google benchmark 的格式量測每個函式 (自動增加次數直到超過 BENCH_MIN_NS)。
+  優化可以先在電腦上確認結果沒變，再燒到板子上用 pio_ws2812_bench 量實際週期數。
+
+    ./logic_check               驗證 + 量測
+    ./logic_check --no-bench    只驗證 (有任何錯誤時回傳 1)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "at24c256.h"
+#include "pixel_kernels_ref.h"
+#include "settings.h"
+#include "ws2812_patterns.h"
+
+#define EEPROM_ADDRESS  0x50
+#define BUSY_POLLS      3           //<! 寫入後幾次 ACK 查詢沒有回應 (讓 eeprom_wait_ready 真的重試)
+#define BENCH_MIN_NS    50e6
+
+// ----------------------------------------------------------------------------
+// AT24C256 模型
+
+static i2c_inst_t i2c_model;
+static uint8_t eeprom_mem[EEPROM_SIZE];
+static uint16_t eeprom_ptr;
+static int eeprom_busy;
+static uint32_t page_writes;
+static uint32_t page_crossings;
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    (void) i2c;
+    if (addr != EEPROM_ADDRESS) return PICO_ERROR_GENERIC;
+    if (eeprom_busy > 0) {
+        eeprom_busy--;
+        return PICO_ERROR_GENERIC;
+    }
+    if (len >= 2) eeprom_ptr = (uint16_t) (((src[0] << 8) | src[1]) % EEPROM_SIZE);
+    if (len > 2 && !nostop) {
+        // 頁寫入：超過頁尾繞回同一頁的開頭
+        uint16_t page = eeprom_ptr & ~(EEPROM_PAGE_SIZE - 1);
+        uint16_t offset = eeprom_ptr % EEPROM_PAGE_SIZE;
+        size_t n = len - 2;
+        if (offset + n > EEPROM_PAGE_SIZE) page_crossings++;
+        for (size_t i = 0; i < n; i++) eeprom_mem[page + (offset + i) % EEPROM_PAGE_SIZE] = src[2 + i];
+        page_writes++;
+        eeprom_busy = BUSY_POLLS;
+    }
+    return (int) len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop)
+{
+    (void) i2c, (void) nostop;
+    if (addr != EEPROM_ADDRESS || eeprom_busy > 0) return PICO_ERROR_GENERIC;
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = eeprom_mem[eeprom_ptr];
+        eeprom_ptr = (eeprom_ptr + 1) % EEPROM_SIZE;
+    }
+    return (int) len;
+}
+
+// ----------------------------------------------------------------------------
+
+static uint32_t rng = 0x12345678;
+
+static uint32_t next_random(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static uint32_t failures;
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { \
+            if (failures++ < 10) { printf("  FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+        } \
+    } while (0)
+
+static void report(const char *name, uint32_t before)
+{
+    printf("%-28s %s\n", name, failures == before ? "ok" : "FAIL");
+}
+
+//! 第 lane 條燈的值 (planes 是 MSB first)
+static uint32_t lane_value(const value_bits_t *v, uint lane)
+{
+    uint32_t value = 0;
+    for (uint p = 0; p < VALUE_PLANE_COUNT; p++) value = (value << 1) | ((v->planes[p] >> lane) & 1);
+    return value;
+}
+
+// ----------------------------------------------------------------------------
+// 驗證
+
+static void check_checksum(void)
+{
+    uint32_t before = failures;
+    for (int n = 0; n < 10000; n++) {
+        SystemSettings s;
+        for (size_t i = 0; i < sizeof(s); i++) ((uint8_t *) &s)[i] = (uint8_t) next_random();
+        uint8_t sum = 0;
+        for (size_t i = 0; i < offsetof(SystemSettings, checksum); i++) sum += ((uint8_t *) &s)[i];
+        CHECK(calc_checksum(&s) == sum, "checksum %02x != %02x", calc_checksum(&s), sum);
+    }
+
+    // 存進 EEPROM 模型再讀回來，設定要完全一樣
+    memset(&current_settings, 0, sizeof(current_settings));
+    current_settings.magic = MAGIC_CODE;
+    current_settings.motor_offset = -1234;
+    current_settings.volume = 77;
+    strcpy((char *) current_settings.wifi_ssid, "logic_check");
+    settings_save();
+    SystemSettings saved = current_settings;
+    memset(&current_settings, 0, sizeof(current_settings));
+    settings_init();
+    CHECK(!memcmp(&saved, &current_settings, sizeof(saved)), "settings round trip");
+    report("calc_checksum / settings", before);
+}
+
+static void check_page_split(void)
+{
+    uint32_t before = failures;
+    static uint8_t expected[EEPROM_SIZE];
+    memcpy(expected, eeprom_mem, sizeof(expected));
+    page_crossings = 0;
+
+    for (int n = 0; n < 3000; n++) {
+        uint8_t data[300];
+        size_t len = 1 + next_random() % sizeof(data);
+        uint16_t addr = (uint16_t) (next_random() % (EEPROM_SIZE - len));
+        for (size_t i = 0; i < len; i++) data[i] = (uint8_t) next_random();
+
+        uint32_t writes = page_writes;
+        eeprom_write_buffer(addr, data, len);
+        memcpy(expected + addr, data, len);
+
+        // 最少需要的頁數 = 實際寫入次數
+        uint32_t pages = (addr + len - 1) / EEPROM_PAGE_SIZE - addr / EEPROM_PAGE_SIZE + 1;
+        CHECK(page_writes - writes == pages, "addr %u len %u: %u writes, %u pages", addr, (uint) len,
+              (uint) (page_writes - writes), (uint) pages);
+
+        uint8_t back[300];
+        CHECK(eeprom_read_buffer(addr, back, len) == (int) len, "read length");
+        CHECK(!memcmp(back, data, len), "addr %u len %u read back differs", addr, (uint) len);
+    }
+    CHECK(page_crossings == 0, "%u writes crossed a page boundary", (uint) page_crossings);
+    CHECK(!memcmp(expected, eeprom_mem, sizeof(expected)), "EEPROM image differs (page wrap overwrote data)");
+
+    // 單一 byte 讀寫與 update
+    eeprom_write_byte(0x7fff, 0xa5);
+    CHECK(eeprom_read_byte(0x7fff) == 0xa5, "write_byte / read_byte");
+    uint32_t writes = page_writes;
+    eeprom_update_byte(0x7fff, 0xa5);
+    CHECK(page_writes == writes, "update_byte wrote an unchanged value");
+    report("eeprom page splitting", before);
+}
+
+static void check_add_error(void)
+{
+    uint32_t before = failures;
+    const uint32_t mask = (1u << VALUE_PLANE_COUNT) - 1, frac = (1u << FRAC_BITS) - 1;
+    for (int n = 0; n < 20000; n++) {
+        uint32_t s[32], e[32];
+        for (uint i = 0; i < 32; i++) {
+            s[i] = next_random() & mask;
+            e[i] = next_random() & mask;
+        }
+        value_bits_t vs, ve, vd;
+        planes_from_values(&vs, s, 32);
+        planes_from_values(&ve, e, 32);
+        add_error(&vd, &vs, &ve);
+        for (uint i = 0; i < 32; i++) {
+            uint32_t want = (s[i] + (e[i] & frac)) & mask;
+            CHECK(lane_value(&vd, i) == want, "lane %u: %03x + %x = %03x, got %03x", i, (uint) s[i],
+                  (uint) (e[i] & frac), (uint) want, (uint) lane_value(&vd, i));
+        }
+    }
+    report("add_error == integer add", before);
+}
+
+static void check_dither(void)
+{
+    uint32_t before = failures;
+    enum { VALUES = 8, FRAMES = 4096 };
+    value_bits_t colors[VALUES], state[2][VALUES];
+    uint32_t c[VALUES][32];
+    uint64_t sum[VALUES][32] = {0};
+    memset(state, 0, sizeof(state));
+    for (uint v = 0; v < VALUES; v++) {
+        // 整數部分最多 254，加上小數進位才不會超過 8 bits
+        for (uint i = 0; i < 32; i++) c[v][i] = next_random() % (0xff << FRAC_BITS);
+        planes_from_values(&colors[v], c[v], 32);
+    }
+    for (uint f = 0; f < FRAMES; f++) {
+        dither_values(colors, state[f & 1], state[(f & 1) ^ 1], VALUES);
+        for (uint v = 0; v < VALUES; v++) {
+            for (uint i = 0; i < 32; i++) sum[v][i] += lane_value(&state[f & 1][v], i) >> FRAC_BITS;
+        }
+    }
+    // 送出的整數部分總和 + 最後剩下的小數 = FRAMES 個顏色值
+    const value_bits_t *last = state[(FRAMES - 1) & 1];
+    for (uint v = 0; v < VALUES; v++) {
+        for (uint i = 0; i < 32; i++) {
+            uint64_t total = (sum[v][i] << FRAC_BITS) + (lane_value(&last[v], i) & ((1u << FRAC_BITS) - 1));
+            CHECK(total == (uint64_t) FRAMES * c[v][i], "value %u lane %u: %llu != %llu", v, i,
+                  (unsigned long long) total, (unsigned long long) FRAMES * c[v][i]);
+        }
+    }
+    report("dither_values keeps the sum", before);
+}
+
+static uint8_t strip0_data[NUM_PIXELS * 3] __attribute__((aligned(4)));
+static uint8_t strip1_data[NUM_PIXELS * 4] __attribute__((aligned(4)));
+static strip_t strip0 = {.data = strip0_data, .data_len = sizeof(strip0_data), .frac_brightness = 0x40};
+static strip_t strip1 = {.data = strip1_data, .data_len = sizeof(strip1_data), .frac_brightness = 0x100};
+static strip_t *strips[] = {&strip0, &strip1};
+static value_bits_t colors[NUM_PIXELS * 4];
+static value_bits_t states[2][NUM_PIXELS * 4];
+
+//! transform_strips 的參考實作：逐 byte 縮放，再逐 bit 放進 plane
+static uint32_t ref_value(const strip_t *strip, uint v, uint frac_brightness)
+{
+    if (v >= strip->data_len) return 0;
+    uint32_t word;
+    memcpy(&word, strip->data + (v & ~3u), 4);
+    uint scale = strip->frac_brightness;
+    word = scale <= 0x100 ? ref_scale(word, scale) : ref_gain(word, MIN(scale >> 2, 0x100));
+    uint32_t byte = (word >> (8 * (v & 3))) & 0xff;
+    return (byte * frac_brightness) >> 8;
+}
+
+static void check_transform(void)
+{
+    uint32_t before = failures;
+    static const uint scales[] = {0x40, 0x100, 0x180, 0x3ff};
+    for (int n = 0; n < 200; n++) {
+        for (size_t i = 0; i < sizeof(strip0_data); i++) strip0_data[i] = (uint8_t) next_random();
+        for (size_t i = 0; i < sizeof(strip1_data); i++) strip1_data[i] = (uint8_t) next_random();
+        strip0.frac_brightness = scales[n % 4];
+        strip1.frac_brightness = scales[(n / 4) % 4];
+        uint frac_brightness = next_random() % (0x20 << FRAC_BITS);
+        transform_strips(strips, count_of(strips), colors, NUM_PIXELS * 4, frac_brightness);
+        for (uint v = 0; v < NUM_PIXELS * 4; v++) {
+            for (uint s = 0; s < 2; s++) {
+                uint32_t want = ref_value(strips[s], v, frac_brightness);
+                CHECK(lane_value(&colors[v], s) == want, "value %u strip %u: %x != %x", v, s,
+                      (uint) lane_value(&colors[v], s), (uint) want);
+            }
+        }
+    }
+    strip0.frac_brightness = 0x40;
+    strip1.frac_brightness = 0x100;
+    report("transform_strips vs ref", before);
+}
+
+static void check_patterns(void)
+{
+    uint32_t before = failures;
+    uint8_t buf[NUM_PIXELS * 4 + 16], again[sizeof(buf)];
+    for (int pat = 0; pat < PATTERN_COUNT; pat++) {
+        for (uint t = 0; t < 2000; t += 7) {
+            for (int four = 0; four < 2; four++) {
+                uint bytes = NUM_PIXELS * (four ? 4 : 3);
+                memset(buf, 0xee, sizeof(buf));
+                pattern_render(pat, buf, four, NUM_PIXELS, t);
+                for (uint i = bytes; i < sizeof(buf); i++) CHECK(buf[i] == 0xee, "%s wrote past the strip", pattern_table[pat].name);
+                if (four) {
+                    for (uint i = 3; i < bytes; i += 4) CHECK(buf[i] == 0, "%s: W channel not 0", pattern_table[pat].name);
+                }
+                memset(again, 0xee, sizeof(again));
+                pattern_render(pat, again, four, NUM_PIXELS, t);
+                CHECK(!memcmp(buf, again, sizeof(buf)), "%s is not repeatable at t=%u", pattern_table[pat].name, t);
+            }
+        }
+    }
+    report("patterns", before);
+}
+
+// ----------------------------------------------------------------------------
+// 量測
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef void (*bench_fn)(uint32_t iter);
+
+//! 次數加倍直到總時間超過 BENCH_MIN_NS
+static void run_bench(const char *name, bench_fn fn)
+{
+    uint32_t iters = 1;
+    double ns;
+    for (;;) {
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < iters; i++) fn(i);
+        ns = now_ns() - t0;
+        if (ns >= BENCH_MIN_NS || iters >= (1u << 30)) break;
+        iters *= ns < BENCH_MIN_NS / 100 ? 10 : 2;
+    }
+    printf("BM_%-26s %12.1f ns %12u\n", name, ns / iters, (uint) iters);
+}
+
+static volatile uint32_t sink;
+static uint8_t page_buf[EEPROM_PAGE_SIZE];
+
+static void bm_checksum(uint32_t i) { (void) i; sink = calc_checksum(&current_settings); }
+static void bm_write_buffer(uint32_t i) { eeprom_write_buffer((uint16_t) (0x100 + 32 + (i & 7)), page_buf, sizeof(page_buf)); }
+static void bm_read_buffer(uint32_t i) { (void) i; eeprom_read_buffer(0x100, page_buf, sizeof(page_buf)); }
+static void bm_add_error(uint32_t i) { add_error(&states[i & 1][0], &colors[0], &states[(i & 1) ^ 1][0]); }
+static void bm_dither(uint32_t i) { dither_values(colors, states[i & 1], states[(i & 1) ^ 1], NUM_PIXELS * 4); }
+static void bm_transform(uint32_t i) { transform_strips(strips, count_of(strips), colors, NUM_PIXELS * 4, i & 0x1ff); }
+static void bm_snakes(uint32_t i) { pattern_render(0, strip1_data, true, NUM_PIXELS, i); }
+static void bm_random(uint32_t i) { pattern_render(1, strip1_data, true, NUM_PIXELS, i); }
+static void bm_sparkle(uint32_t i) { pattern_render(2, strip1_data, true, NUM_PIXELS, i); }
+static void bm_greys(uint32_t i) { pattern_render(3, strip1_data, true, NUM_PIXELS, i); }
+static void bm_plasma(uint32_t i) { pattern_render(4, strip1_data, true, NUM_PIXELS, i); }
+static void bm_noise(uint32_t i) { pattern_render(5, strip1_data, true, NUM_PIXELS, i); }
+
+int main(int argc, char **argv)
+{
+    bool bench = !(argc > 1 && !strcmp(argv[1], "--no-bench"));
+    eeprom_init(&i2c_model, EEPROM_ADDRESS);
+
+    check_checksum();
+    check_page_split();
+    check_add_error();
+    check_dither();
+    check_transform();
+    check_patterns();
+    printf("%u failure(s)\n", (uint) failures);
+
+    if (bench && !failures) {
+        // EEPROM 模型不會忙碌，只量驅動本身的開銷
+        printf("\n%-29s %15s %12s\n", "Benchmark", "Time", "Iterations");
+        run_bench("calc_checksum", bm_checksum);
+        run_bench("eeprom_write_buffer_64", bm_write_buffer);
+        run_bench("eeprom_read_buffer_64", bm_read_buffer);
+        run_bench("add_error", bm_add_error);
+        run_bench("dither_values", bm_dither);
+        run_bench("transform_strips", bm_transform);
+        run_bench("pattern_snakes", bm_snakes);
+        run_bench("pattern_random", bm_random);
+        run_bench("pattern_sparkle", bm_sparkle);
+        run_bench("pattern_greys", bm_greys);
+        run_bench("pattern_plasma", bm_plasma);
+        run_bench("pattern_noise", bm_noise);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,19 @@
+/*!
+  \brief 電腦上用的最小 lwIP pbuf 定義
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  欄位順序和名稱跟 lwIP 的 struct pbuf 相同，只保留 artnet_rx.c 用到的部分。
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef uint16_t u16_t;
+
+struct pbuf {
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;      //<! 這個 pbuf 加上後面所有 pbuf 的長度
+    u16_t len;          //<! 這個 pbuf 的長度
+};
@@ -0,0 +1,73 @@
+/*!
+  \brief 在電腦上比對像素運算核心 (SWAR 寫法) 與逐 byte 參考實作，並量測執行時間
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  有任何不一致時回傳 1。M33 DSP 版本要在板子上用 pio_ws2812_kernels 比對。
+ */
+#include <stdio.h>
+#include <time.h>
+
+#include "pixel_kernels.h"
+#include "pixel_kernels_ref.h"
+#include "ws2812_planes.h"
+
+#define WORDS 4096
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t src[WORDS], src2[WORDS], dst[WORDS];
+static volatile uint32_t sink;
+
+//! 每個 byte 花幾 ns
+#define TIME(label, ...) do { \
+        const int loops_ = 2000; \
+        double t0_ = now_ns(); \
+        for (int l_ = 0; l_ < loops_; l_++) { __VA_ARGS__; sink = dst[l_ % WORDS]; } \
+        printf("  %-22s %7.3f ns/byte\n", label, (now_ns() - t0_) / loops_ / (WORDS * 4)); \
+    } while (0)
+
+int main(void)
+{
+    uint32_t errors = pk_verify(2000000);
+    printf("pixel kernels (%s): %u mismatches in 2000000 rounds\n",
+           PIXEL_KERNELS_DSP ? "DSP" : "SWAR", (unsigned) errors);
+    uint32_t plane_errors = planes_verify(200000);
+    printf("bit planes (%s): %u mismatches in 200000 rounds\n\n", planes_arch_name(), (unsigned) plane_errors);
+    errors += plane_errors;
+
+    for (uint32_t i = 0; i < WORDS; i++) {
+        src[i] = i * 0x9e3779b9u;
+        src2[i] = i * 0x85ebca6bu;
+    }
+    uint8_t lut[256];
+    pk_gamma_table(lut, 2.2f);
+
+    printf("kernel\n");
+    TIME("scale", pk_scale_buffer(dst, src, WORDS, 0x80));
+    TIME("scale (ref)", for (int i = 0; i < WORDS; i++) dst[i] = ref_scale(src[i], 0x80));
+    TIME("add_sat", pk_add_sat_buffer(dst, src, WORDS));
+    TIME("add_sat (ref)", for (int i = 0; i < WORDS; i++) dst[i] = ref_add_sat(dst[i], src[i]));
+    TIME("blend", pk_blend_buffer(dst, src, src2, WORDS, 0x40));
+    TIME("blend (ref)", for (int i = 0; i < WORDS; i++) dst[i] = ref_blend(src[i], src2[i], 0x40));
+    TIME("gamma", pk_gamma_buffer(dst, src, WORDS, lut));
+    TIME("power", dst[0] = pk_power_buffer(src, WORDS, 0x00100014, 0x000c0000));
+
+    // 每個 byte 就是 ws2812_parallel 的一個顏色值
+    static value_bits_t planes[WORDS * 4];
+    TIME("planes (2 strips)",
+         for (int i = 0; i < WORDS * 4; i++) planes_from_values2(&planes[i], src[i / 4] & 0xfff, src2[i / 4] & 0xfff));
+    TIME("planes (generic)",
+         for (int i = 0; i < WORDS * 4; i++) {
+             uint32_t v[2] = {src[i / 4] & 0xfff, src2[i / 4] & 0xfff};
+             planes_from_values(&planes[i], v, 2);
+         });
+    TIME("dither", dither_values(planes, planes, planes + 1, WORDS * 4 - 1));
+
+    return errors ? 1 : 0;
+}
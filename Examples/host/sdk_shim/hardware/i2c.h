@@ -0,0 +1,41 @@
+/*!
+  \brief 電腦上用的最小 Pico SDK hardware/i2c.h
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  i2c_write_blocking / i2c_read_blocking 由使用的程式實作 (例如 logic_check.c 的 EEPROM 模型)。
+  暫存器結構只保留 at24c256.c 非同步讀取用到的欄位，電腦上不會執行到。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    volatile uint32_t enable;
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t dma_cr;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_tx_abrt;
+    volatile uint32_t status;
+    volatile uint32_t rxflr;
+} i2c_hw_t;
+
+typedef struct {
+    i2c_hw_t hw;
+} i2c_inst_t;
+
+#define I2C_IC_DATA_CMD_CMD_BITS            0x00000100u
+#define I2C_IC_DATA_CMD_STOP_BITS           0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS        0x00000400u
+#define I2C_IC_DMA_CR_RDMAE_BITS            0x00000001u
+#define I2C_IC_DMA_CR_TDMAE_BITS            0x00000002u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS   0x00000040u
+#define I2C_IC_ENABLE_ENABLE_BITS           0x00000001u
+#define I2C_IC_ENABLE_ABORT_BITS            0x00000002u
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) { return &i2c->hw; }
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) { (void) i2c; return is_tx ? 0 : 1; }
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
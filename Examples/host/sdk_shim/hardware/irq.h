@@ -0,0 +1,27 @@
+/*!
+  \brief 電腦上用的最小 Pico SDK hardware/irq.h
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  沒有中斷：irq_set_exclusive_handler 記下處理函式，由使用的程式自己呼叫 (host_irq_handler)。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define SIO_IRQ_FIFO    25
+
+typedef void (*irq_handler_t)(void);
+
+extern irq_handler_t host_irq_handler[2];
+
+static inline void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+    (void) num;
+    host_irq_handler[get_core_num()] = handler;
+}
+
+static inline void irq_set_enabled(uint num, bool enabled)
+{
+    (void) num, (void) enabled;
+}
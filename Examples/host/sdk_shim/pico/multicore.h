@@ -0,0 +1,47 @@
+/*!
+  \brief 電腦上用的最小 Pico SDK pico/multicore.h (只有 SIO FIFO)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  每個核心 (執行緒，get_core_num()) 一個深度 4 的 FIFO，push 寫進另一個核心的 FIFO。
+  只記錄筆數，不保存資料；event_bus.c 的門鈴只用到「有沒有」。
+ */
+#pragma once
+
+#include <stdatomic.h>
+
+#include "pico/stdlib.h"
+
+#define HOST_FIFO_DEPTH     4
+
+extern atomic_uint host_fifo_count[2];
+extern atomic_uint host_fifo_pushes;
+
+static inline bool multicore_fifo_rvalid(void)
+{
+    return atomic_load(&host_fifo_count[get_core_num()]) > 0;
+}
+
+static inline bool multicore_fifo_wready(void)
+{
+    return atomic_load(&host_fifo_count[get_core_num() ^ 1]) < HOST_FIFO_DEPTH;
+}
+
+static inline void multicore_fifo_push_blocking(uint32_t data)
+{
+    (void) data;
+    atomic_uint *count = &host_fifo_count[get_core_num() ^ 1];
+    uint n = atomic_load(count);
+    while (n >= HOST_FIFO_DEPTH || !atomic_compare_exchange_weak(count, &n, n + 1)) n = atomic_load(count);
+    atomic_fetch_add(&host_fifo_pushes, 1);
+}
+
+static inline uint32_t multicore_fifo_pop_blocking(void)
+{
+    atomic_uint *count = &host_fifo_count[get_core_num()];
+    uint n = atomic_load(count);
+    while (!n || !atomic_compare_exchange_weak(count, &n, n - 1)) n = atomic_load(count);
+    return 0;
+}
+
+static inline void multicore_fifo_clear_irq(void) {}
@@ -0,0 +1,64 @@
+/*!
+  \brief 電腦上用的最小 Pico SDK pico/stdlib.h
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  只保留 logic_check 與 event_bus_stress 編譯的檔案 (settings.c、at24c256.c、event_bus.c ...) 用到的部分，
+  名稱和行為跟 SDK 相同。
+ */
+#pragma once
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+typedef unsigned int uint;
+
+#define count_of(a)     (sizeof(a) / sizeof((a)[0]))
+#ifndef MIN
+#define MIN(a, b)       ((b) > (a) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b)       ((a) > (b) ? (a) : (b))
+#endif
+
+#define __unused                    __attribute__((unused))
+#define __not_in_flash_func(f)      f
+#define hard_assert(x)              assert(x)
+
+#define PICO_OK                     0
+#define PICO_ERROR_GENERIC          -1
+
+static inline void tight_loop_contents(void) {}
+
+//! EEPROM 模型的寫入週期是立刻完成，不需要真的等
+static inline void sleep_us(uint64_t us) { (void) us; }
+static inline void sleep_ms(uint32_t ms) { (void) ms; }
+
+static inline uint32_t time_us_32(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) ((uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+typedef uint64_t absolute_time_t;
+
+static inline absolute_time_t make_timeout_time_us(uint64_t us)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000 + us;
+}
+
+static inline bool time_reached(absolute_time_t t)
+{
+    return make_timeout_time_us(0) >= t;
+}
+
+//! 每個執行緒當成一個核心，由使用的程式定義並設定 (例如 event_bus_stress.c)
+extern _Thread_local uint host_core_num;
+
+static inline uint get_core_num(void) { return host_core_num; }
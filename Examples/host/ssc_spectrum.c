@@ -0,0 +1,179 @@
+/*!
+  \brief 展頻時鐘頻譜：用 clock_generator 的週期表合成 PIO 輸出，計算尖峰降低多少
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+    ./ssc_spectrum                                      4 MHz、2%、8 kHz 三角波、150 MHz PIO (與 clock_generator 的預設值相同)
+    ./ssc_spectrum --depth 0.04 --rate 4k --random      4% 虛擬亂數
+    ./ssc_spectrum --carrier 10M --pio 144M
+
+  開始前先檢查 ssc_dma_reload_count()：每種表格長度都是整數圈，且 RP2350 的 MODE 欄位是 0 (錯了回傳 1)。
+
+  輸出的每個 PIO 週期是一個取樣 (0 或 1)，加 Hann 窗後做 FFT。
+  比較對象是同一個產生器 depth = 0 的輸出 (分頻有小數時一樣會有 sigma-delta 抖動)。
+  除了單一 bin 的尖峰，也用 9 kHz (CISPR 150 kHz ~ 30 MHz) 與 120 kHz (30 MHz ~ 1 GHz)
+  的解析頻寬加總，比較接近 EMI 接收機看到的值。
+ */
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ssc_table.h"
+
+#define LOG2_N      20
+#define N           (1u << LOG2_N)
+#define TABLE_MAX   1024
+
+static double parse_hz(const char *s)
+{
+    char *end;
+    double v = strtod(s, &end);
+    if (*end == 'k' || *end == 'K') v *= 1e3;
+    if (*end == 'M' || *end == 'm') v *= 1e6;
+    return v;
+}
+
+//! 就地 radix-2 FFT
+static void fft(double *re, double *im, uint32_t n)
+{
+    for (uint32_t i = 1, j = 0; i < n; i++) {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= n; len <<= 1) {
+        double a = -2 * M_PI / len;
+        for (uint32_t i = 0; i < n; i += len) {
+            for (uint32_t k = 0; k < len / 2; k++) {
+                double wr = cos(a * k), wi = sin(a * k);
+                double *ur = &re[i + k], *ui = &im[i + k];
+                double *vr = &re[i + k + len / 2], *vi = &im[i + k + len / 2];
+                double tr = *vr * wr - *vi * wi, ti = *vr * wi + *vi * wr;
+                *vr = *ur - tr; *vi = *ui - ti;
+                *ur += tr; *ui += ti;
+            }
+        }
+    }
+}
+
+/*! 依週期表合成 N 個取樣並算功率頻譜 (只留前 N/2 個 bin)
+  \return 表格長度，0 表示設定無法達成
+ */
+static uint32_t spectrum(const ssc_config_t *cfg, double pio_hz, double *power, double *rate_hz)
+{
+    static uint32_t table[TABLE_MAX];
+    uint32_t len = ssc_build_table(table, TABLE_MAX, cfg, pio_hz, rate_hz);
+    if (!len) return 0;
+
+    double *re = malloc(N * sizeof(double));
+    double *im = calloc(N, sizeof(double));
+    uint32_t t = 0;
+    for (uint32_t i = 0; t < N; i = (i + 1) % len) {
+        uint32_t period = ssc_period_cycles(table[i]);
+        uint32_t high = ssc_high_cycles(table[i]);
+        for (uint32_t c = 0; c < period && t < N; c++, t++) {
+            double w = 0.5 - 0.5 * cos(2 * M_PI * t / N);
+            re[t] = (c < high ? 1.0 : 0.0) * w;
+        }
+    }
+    fft(re, im, N);
+    for (uint32_t k = 0; k < N / 2; k++) power[k] = re[k] * re[k] + im[k] * im[k];
+    free(re);
+    free(im);
+    return len;
+}
+
+//! [lo, hi] 之間，連續 width 個 bin 加總的最大值
+static double peak(const double *power, uint32_t lo, uint32_t hi, uint32_t width)
+{
+    if (width < 1) width = 1;
+    double sum = 0, best = 0;
+    for (uint32_t k = lo; k <= hi; k++) {
+        sum += power[k];
+        if (k >= lo + width) sum -= power[k - width];
+        if (k >= lo + width - 1 && sum > best) best = sum;
+    }
+    return best;
+}
+
+//! DMA 重新載入的次數：每種表格長度都要是整數圈，而且 RP2350 的 MODE 欄位 (bits 31:28) 必須是 0
+static bool check_dma_count(void)
+{
+    for (uint32_t len = 1; len <= (1u << 27); len <<= 1) {
+        uint32_t count = ssc_dma_reload_count(len);
+        if ((count >> 28) != 0 || count % len != 0 || count == 0) {
+            fprintf(stderr, "DMA count 0x%08x for table length %u is invalid\n", (unsigned) count, (unsigned) len);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    ssc_config_t cfg = {.carrier_hz = 4e6f, .depth = 0.02f, .rate_hz = 8000, .profile = SSC_TRIANGLE};
+    double pio_hz = 150e6;
+
+    for (int i = 1; i < argc; i++) {
+        const char *v = i + 1 < argc ? argv[i + 1] : "0";
+        if (!strcmp(argv[i], "--depth")) cfg.depth = (float) atof(v), i++;
+        else if (!strcmp(argv[i], "--rate")) cfg.rate_hz = (float) parse_hz(v), i++;
+        else if (!strcmp(argv[i], "--carrier")) cfg.carrier_hz = (float) parse_hz(v), i++;
+        else if (!strcmp(argv[i], "--pio")) pio_hz = parse_hz(v), i++;
+        else if (!strcmp(argv[i], "--random")) cfg.profile = SSC_RANDOM;
+        else if (!strcmp(argv[i], "--triangle")) cfg.profile = SSC_TRIANGLE;
+        else {
+            fprintf(stderr, "usage: %s [--carrier hz] [--depth 0.02] [--rate hz] [--pio hz] [--triangle|--random]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if (!check_dma_count()) return 1;
+
+    double *ref = malloc(N / 2 * sizeof(double));
+    double *ssc = malloc(N / 2 * sizeof(double));
+    ssc_config_t flat = cfg;
+    flat.depth = 0;
+    double rate_hz, flat_rate;
+    uint32_t len = spectrum(&cfg, pio_hz, ssc, &rate_hz);
+    if (!len || !spectrum(&flat, pio_hz, ref, &flat_rate)) {
+        fprintf(stderr, "carrier %.0f Hz cannot be generated from %.0f Hz\n", cfg.carrier_hz, pio_hz);
+        return 1;
+    }
+
+    double bin_hz = pio_hz / N;
+    printf("carrier %.3f MHz, PIO %.3f MHz (%.3f cycles/period), depth %.2f%% %s\n", cfg.carrier_hz / 1e6,
+           pio_hz / 1e6, pio_hz / cfg.carrier_hz, cfg.depth * 100, cfg.profile == SSC_TRIANGLE ? "triangle" : "random");
+    printf("table %u periods, modulation %.1f Hz, FFT %u points, bin %.1f Hz\n\n", (unsigned) len, rate_hz,
+           (unsigned) N, bin_hz);
+    printf("%-10s %14s %14s %14s\n", "harmonic", "peak bin dB", "RBW 9k dB", "RBW 120k dB");
+
+    static const double rbw[] = {0, 9e3, 120e3};
+    for (int h = 1; h <= 5; h += 2) {
+        double f = cfg.carrier_hz * h;
+        if (f >= pio_hz / 2) break;
+        // 搜尋範圍：展頻的寬度再加兩側各 2 個最大 RBW
+        double span = f * cfg.depth / 2 + 2 * rbw[2];
+        uint32_t lo = (uint32_t) fmax(1, (f - span) / bin_hz);
+        uint32_t hi = (uint32_t) fmin(N / 2 - 1, (f + span) / bin_hz);
+        printf("%-10d", h);
+        for (int r = 0; r < 3; r++) {
+            uint32_t width = (uint32_t) (rbw[r] / bin_hz + 0.5);
+            double reduction = 10 * log10(peak(ref, lo, hi, width) / peak(ssc, lo, hi, width));
+            printf(" %14.2f", reduction);
+        }
+        printf("\n");
+    }
+    printf("\n(positive = spread spectrum peak is lower than the unmodulated output)\n");
+
+    free(ref);
+    free(ssc);
+    return 0;
+}
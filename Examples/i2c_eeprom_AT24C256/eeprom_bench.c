@@ -0,0 +1,109 @@
+/*!
+  \brief AT24C256 讀寫路徑與設定檢查碼的週期數 (common/bench)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  讀取與 calc_checksum 關中斷量測；寫入要等 EEPROM 內部寫入週期 (eeprom_wait_ready 會 sleep)，
+  所以開著中斷量，次數也比較少 (每次寫入都會消耗 EEPROM 的寫入壽命)。
+  寫入只用最後一頁，不會動到設定 (SETTINGS_ADDR) 與 pio_ws2812 的場景庫。
+  I2C 是 100 kHz，週期數大部分是匯流排時間，改 I2C_BAUDRATE 可以看出差異。
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "at24c256.h"
+#include "bench.h"
+#include "settings.h"
+
+#define AT24C256_ADDRESS    0x50
+#define I2C_BAUDRATE        100000
+#define SCRATCH_ADDR        (EEPROM_SIZE - EEPROM_PAGE_SIZE)    //<! 寫入測試用的最後一頁
+#define ITERS               101
+#define WRITE_ITERS         10
+
+static uint8_t buf[EEPROM_PAGE_SIZE];
+static volatile uint8_t sink;
+
+static void bench_checksum(void *ctx)
+{
+    sink = calc_checksum(&current_settings);
+}
+
+static void bench_read_byte(void *ctx)
+{
+    sink = eeprom_read_byte(SETTINGS_ADDR);
+}
+
+static void bench_read_buffer(void *ctx)
+{
+    eeprom_read_buffer(SETTINGS_ADDR, buf, (size_t) (uintptr_t) ctx);
+}
+
+static void bench_read_async(void *ctx)
+{
+    if (!eeprom_read_async(SETTINGS_ADDR, buf, (size_t) (uintptr_t) ctx)) return;
+    while (eeprom_async_poll() == EEPROM_ASYNC_BUSY) tight_loop_contents();
+}
+
+static void bench_update_same(void *ctx)
+{
+    // 值一樣時只有讀取，不會寫入
+    eeprom_update_byte(SCRATCH_ADDR, eeprom_read_byte(SCRATCH_ADDR));
+}
+
+static void bench_write_byte(void *ctx)
+{
+    eeprom_write_byte(SCRATCH_ADDR, (uint8_t) buf[0]++);
+}
+
+static void bench_write_page(void *ctx)
+{
+    buf[0]++;
+    eeprom_write_buffer(SCRATCH_ADDR, buf, EEPROM_PAGE_SIZE);
+}
+
+static const bench_case_t cases[] = {
+        BENCH_CASE("calc_checksum", bench_checksum, NULL),
+        BENCH_CASE("eeprom_read_byte", bench_read_byte, NULL),
+        BENCH_CASE("eeprom_read_buffer_16", bench_read_buffer, (void *) 16),
+        BENCH_CASE("eeprom_read_buffer_64", bench_read_buffer, (void *) 64),
+        BENCH_CASE("eeprom_read_async_64", bench_read_async, (void *) 64),
+        BENCH_CASE("eeprom_update_byte_same", bench_update_same, NULL),
+        BENCH_CASE_IRQS_ON("eeprom_write_byte", bench_write_byte, NULL, WRITE_ITERS),
+        BENCH_CASE_IRQS_ON("eeprom_write_page", bench_write_page, NULL, WRITE_ITERS),
+};
+
+int main()
+{
+    stdio_init_all();
+    sleep_ms(2000);     // 等 USB 序列埠連上
+
+#if !defined(i2c_default) || !defined(PICO_DEFAULT_I2C_SDA_PIN) || !defined(PICO_DEFAULT_I2C_SCL_PIN)
+    printf("錯誤: 未定義預設 I2C 引腳 (請檢查 board 設定)\n");
+    return 0;
+#else
+    gpio_set_function(PICO_DEFAULT_I2C_SDA_PIN, GPIO_FUNC_I2C);
+    gpio_set_function(PICO_DEFAULT_I2C_SCL_PIN, GPIO_FUNC_I2C);
+    gpio_pull_up(PICO_DEFAULT_I2C_SDA_PIN);
+    gpio_pull_up(PICO_DEFAULT_I2C_SCL_PIN);
+    i2c_init(i2c_default, I2C_BAUDRATE);
+    eeprom_init(i2c_default, AT24C256_ADDRESS);
+
+    // 沒有 EEPROM 時 I2C 讀取會一直 NAK，量到的只是錯誤路徑
+    uint8_t probe;
+    if (eeprom_read_buffer(SETTINGS_ADDR, &probe, 1) < 0) {
+        printf("No EEPROM at 0x%02x\n", AT24C256_ADDRESS);
+        return 0;
+    }
+    eeprom_read_buffer(SETTINGS_ADDR, (uint8_t *) &current_settings, sizeof(current_settings));
+    memset(buf, 0x5a, sizeof(buf));
+
+    // 寫入會消耗壽命，只跑一次
+    bench_run_all("at24c256", cases, count_of(cases), ITERS);
+    while (1) {
+        tight_loop_contents();
+    }
+#endif
+}
@@ -7,8 +7,16 @@
 #include <pico/i2c_slave.h>
 #include <pico/stdlib.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "at24c256.h"
+#include "clock_notify.h"
+#include "idle.h"
+#include "postmortem.h"
+#include "settings.h"
+#include "shell.h"
+
 /** AT24C256C Spec
  * 
  * 32,768 x 8 (256Kb) = 32KB
@@ -31,7 +39,17 @@ static const uint AT24C256_ADDRESS = 0x50;
 //! I2C 通訊速率 100 kHz
 static const uint I2C_BAUDRATE = 100000;
 
-#define PAGE_SIZE 64 //<! 每頁 64 Bytes
+//! 執行中的 I2C 速率，指令列可以調整 (開機時是 I2C_BAUDRATE)
+static uint i2c_baudrate = I2C_BAUDRATE;
+
+//! 主迴圈超過這個時間沒有 pm_kick() 就記錄現場並重新開機
+#define PM_TIMEOUT_MS   2000
+
+//! 主迴圈每圈之間睡多久 (ms)
+#define LOOP_SLEEP_MS   10
+
+//! clock_notify 的 I2C 註冊編號，變更速率時用 clock_notify_retune() 更新
+static int i2c_notify_id = -1;
 
 #define I2C_PORT    i2c_default                 //<! 使用預設 I2C 埠 (i2c0 或 i2c1)
 #define I2C_SDA     PICO_DEFAULT_I2C_SDA_PIN    //<! GP4
@@ -56,158 +74,12 @@ void setup_i2c()
     gpio_pull_up(I2C_SDA);
     gpio_pull_up(I2C_SCL);
 
-    i2c_init(I2C_PORT, I2C_BAUDRATE);
-}
-
-// -----------------------------------------------------------------------------
-// EEPROM API
-// -----------------------------------------------------------------------------
-
-//! ACK 查詢
-void eeprom_wait_ready();
-//! 連續讀取多個 Byte
-void eeprom_read_buffer(uint16_t addr, uint8_t *buf, size_t len);
-//! 智慧型寫入 (自動分頁)
-void eeprom_write_buffer(uint16_t addr, const uint8_t *data, size_t len);
-//! 寫入之前，先讀取該位址的值。只有當新值跟舊值不一樣時，才執行寫入。
-void eeprom_update_byte(uint16_t addr, uint8_t new_val);
-
-void eeprom_wait_ready() 
-{
-    uint8_t dummy;
-    int ret;
-    // 設定一個較短的 timeout，例如 1ms
-    // 不斷嘗試讀取，直到收到 ACK (ret >= 0)
-    do 
-    {
-        // 嘗試讀取 1 個 byte
-        // 這裡單純用 write 測試 address 是否有 ACK
-        ret = i2c_write_blocking(I2C_PORT, AT24C256_ADDRESS, &dummy, 1, false);
-        if (ret < 0) {
-            sleep_us(100); // 稍微等一下再試，避免佔用太多 Bus 頻寬
-        }
-    } while (ret < 0);
-}
-
-void _eeprom_write_page_raw(uint16_t mem_addr, const uint8_t *data, size_t len) 
-{
-    // 準備 I2C Buffer: 2 bytes Address + Data
-    // 這裡用 stack 宣告陣列，大小為 Page Size + 2
-    uint8_t buf[PAGE_SIZE + 2]; 
-    
-    buf[0] = (mem_addr >> 8) & 0xFF; // High Byte
-    buf[1] = mem_addr & 0xFF;        // Low Byte
-    memcpy(&buf[2], data, len);      // 複製數據
-
-    // 發送 (Address + Data)
-    i2c_write_blocking(I2C_PORT, AT24C256_ADDRESS, buf, len + 2, false);
-    
-    // 等待 EEPROM 寫入完成
-    eeprom_wait_ready(); 
-}
+    i2c_init(I2C_PORT, i2c_baudrate);
+    // 閒置降頻時 clk_sys 會改變，I2C 的分頻要跟著重新計算
+    i2c_notify_id = clock_notify_i2c(I2C_PORT, i2c_baudrate);
 
-void eeprom_write_buffer(uint16_t addr, const uint8_t *data, size_t len) 
-{
-    size_t remaining_len = len;
-    size_t offset = 0;
-    
-    while (remaining_len > 0) 
-    {
-        // 計算這一頁還剩多少空間
-        // (例如 addr=60, 64 - (60%64) = 4 bytes)
-        size_t space_in_page = PAGE_SIZE - (addr % PAGE_SIZE);
-        
-        // 這次要寫多少？取「剩餘資料長度」和「頁面剩餘空間」的最小值
-        size_t chunk_size = (remaining_len < space_in_page) ? remaining_len : space_in_page;
-        
-        // 執行底層寫入
-        _eeprom_write_page_raw(addr, &data[offset], chunk_size);
-        
-        // 更新指標與計數
-        addr += chunk_size;
-        offset += chunk_size;
-        remaining_len -= chunk_size;
-    }
-}
-
-void eeprom_read_buffer(uint16_t addr, uint8_t *buf, size_t len) 
-{
-    // 先寫入要讀取的起始位址 (Dummy Write)
-    uint8_t reg_addr[2];
-    reg_addr[0] = (addr >> 8) & 0xFF;
-    reg_addr[1] = addr & 0xFF;
-    
-    // nostop = true (Repeated Start)
-    i2c_write_blocking(I2C_PORT, AT24C256_ADDRESS, reg_addr, 2, true);
-    
-    // 一口氣讀取所有 bytes
-    // I2C controller 會自動處理 ACK/NACK
-    i2c_read_blocking(I2C_PORT, AT24C256_ADDRESS, buf, len, false);
-}
-
-/*! 寫入一個 Byte
-  \brief 特別注意：AT24C256 的「位址」是 16-bit 跟小的 EEPROM\n
-   (如 AT24C02) 不同，AT24C256 容量大，所以寫入數據時，需要發送 2 個\n
-    byte 的記憶體位址 (High Byte + Low Byte)。
- */
-void eeprom_write_byte(uint16_t mem_addr, uint8_t data) 
-{
-    uint8_t buf[3];
-
-    // AT24C256 需要 16-bit 記憶體位址(大端序)
-    // 假設 mem_addr = 0x1234 (16-bit)
-    // 高位元組 (High Byte/MSB) = 0x12
-    // 低位元組 (Low Byte/LSB)  = 0x34
-    // 發送順序： 先送 buf[0] (0x12)，再送 buf[1] (0x34)
-    // 意義：先送 高位 (High Byte)，後送低位 (Low Byte)。
-
-    // 大端序 (Big-Endian)：高位元組 (MSB) 存放在記憶體低位址，或是在通訊中先被發送。
-    // 就像我們寫阿拉伯數字 "1234"，先寫千位數 (1)，最後寫個位數 (4)。
-    // 小端序 (Little-Endian)： 低位元組 (LSB) 先被發送。
-
-    buf[0] = (mem_addr >> 8) & 0xFF; // 取出 0x12(High)，放入陣列第 0 格
-    buf[1] = mem_addr & 0xFF;        // 取出 0x34(Low)，放入陣列第 1 格
-    buf[2] = data;                   // Data
-
-    // 寫入數據
-    // 注意：nostop = false，表示傳完這 3 個 byte 後發送 STOP 訊號
-    // 這樣 EEPROM 才會開始內部的寫入週期
-    i2c_write_blocking(I2C_PORT, AT24C256_ADDRESS, buf, 3, false);
-    
-    // 【重要】EEPROM 寫入需要時間 (約 5ms)
-    // 如果不加這行，馬上讀取會失敗
-    eeprom_wait_ready();
-}
-
-/*! 讀取一個 Byte
-  \brief 特別注意：AT24C256 的「位址」是 16-bit 跟小的 EEPROM\n
-   (如 AT24C02) 不同，AT24C256 容量大，所以讀取數據時，需要先發送 2 個\n
-    byte 的記憶體位址 (High Byte + Low Byte)，然後再讀取數據。
- */
-uint8_t eeprom_read_byte(uint16_t mem_addr) 
-{
-    uint8_t reg_addr[2];
-    uint8_t rx_data = 0;
-
-    reg_addr[0] = (mem_addr >> 8) & 0xFF;
-    reg_addr[1] = mem_addr & 0xFF;
-
-    // 先寫入我們要讀的記憶體位址 (Dummy Write)
-    // nostop = true，表示先不放手，緊接著要讀取 (Repeated Start)
-    i2c_write_blocking(I2C_PORT, AT24C256_ADDRESS, reg_addr, 2, true);
-
-    // 讀取數據
-    i2c_read_blocking(I2C_PORT, AT24C256_ADDRESS, &rx_data, 1, false);
-
-    return rx_data;
-}
-
-void eeprom_update_byte(uint16_t addr, uint8_t new_val) 
-{
-    uint8_t old_val = eeprom_read_byte(addr);
-    if (old_val != new_val) {
-        eeprom_write_byte(addr, new_val); // 只有變更時才寫，節省壽命
-    }
+    // EEPROM 讀寫 API 放在 common/at24c256.c
+    eeprom_init(I2C_PORT, AT24C256_ADDRESS);
 }
 
 // -----------------------------------------------------------------------------
@@ -221,6 +93,7 @@ bool reserved_addr(uint8_t addr)
 }
 
 //! 工具函式，掃描 I2C Bus 上的設備
+//! 這是回應 scan 指令的文字，直接 printf 到指令列 (DLOG 的二進位封包會跟 shell 的輸出混在一起)
 void scan_i2c_bus()
 {
     printf("\nScanning I2C Bus...\n");
@@ -264,92 +137,159 @@ void scan_i2c_bus()
 }
 
 // -----------------------------------------------------------------------------
-// 使用範例
+// 指令列
 // -----------------------------------------------------------------------------
 
-#define SETTINGS_ADDR   0x0000    //<! 系統設定儲存位址
-#define MAGIC_CODE      0xA55A    //<! 魔術數字，用來判斷資料有效性
+static bool apply_baudrate(const shell_param_t *p)
+{
+    // clock_notify 記住新的速率 (閒置降頻、恢復時鐘後都維持)，並用目前的 clk_sys 設定一次
+    if (clock_notify_retune(i2c_notify_id, (float) i2c_baudrate) != PICO_OK) return false;
+    uint actual = i2c_set_baudrate(I2C_PORT, i2c_baudrate);
+    printf("實際速率 %u Hz\n", actual);
+    return true;
+}
+
+static const shell_param_t params[] = {
+        SHELL_PARAM("baud", i2c_baudrate, 10000, 1000000, apply_baudrate, "I2C 速率 (Hz)，AT24C256 最高 1 MHz (2.5V 以上)"),
+};
 
-/*! 系統設定結構體範例(共 40 bytes)
-  \brief 包含馬達位置校正值、WiFi SSID、音量設定等
-  \note 結構體大小需注意對齊 (padding) 問題，建議使用 sizeof() 檢查\n
-        實際大小是否符合預期。最好是把結構體成員依照大小順序排列，\n
-        減少對齊浪費的空間。
- */
-typedef struct 
+static int cmd_scan(int argc, char **argv)
 {
-    int32_t  motor_offset;  //<! 馬達位置校正值
-    uint16_t magic;         //<! 魔術數字，用來判斷資料是否有效
-    uint8_t  wifi_ssid[32]; //<! WiFi SSID
-    uint8_t  volume;        //<! 音量設定 (0-100)
-    uint8_t  checksum;      //<! 簡單的校驗和
-} SystemSettings;
-
-//! 全域系統設定變數
-SystemSettings current_settings;
-
-//! 計算 Checksum (簡單累加法)
-uint8_t calc_checksum(SystemSettings *s) 
+    PM_TRACE("scan", i2c_baudrate);
+    scan_i2c_bus();
+    return 0;
+}
+
+//! 以 16 進位顯示 EEPROM 的內容
+static int cmd_dump(int argc, char **argv)
 {
-    uint8_t sum = 0;
-    uint8_t *ptr = (uint8_t*)s;
-    // 計算除了最後一個 byte (checksum 本身) 以外的所有 bytes
-    for (size_t i = 0; i < sizeof(SystemSettings) - 1; i++) 
-    {
-        sum += ptr[i];
+    if (argc < 2) {
+        printf("用法: dump 位址 [長度]\n");
+        return 1;
     }
-    return sum;
+    uint addr = strtoul(argv[1], NULL, 0) % EEPROM_SIZE;
+    uint len = argc > 2 ? MIN(strtoul(argv[2], NULL, 0), 256) : 64;
+    PM_TRACE("dump", addr);
+    uint8_t buf[16];
+    for (uint off = 0; off < len; off += sizeof(buf)) {
+        uint n = MIN(len - off, sizeof(buf));
+        if (eeprom_read_buffer((addr + off) % EEPROM_SIZE, buf, n) < 0) return PICO_ERROR_GENERIC;
+        printf("%04x:", (addr + off) % EEPROM_SIZE);
+        for (uint i = 0; i < n; i++) printf(" %02x", buf[i]);
+        printf("\n");
+    }
+    return 0;
 }
 
-// 儲存設定 (包含 Update 機制，這裡簡化為全寫，建議配合上面的 Update 邏輯)
-void settings_save() 
+static int cmd_settings(int argc, char **argv)
 {
-    // 更新 Checksum
-    current_settings.checksum = calc_checksum(&current_settings);
-    
-    // 寫入 EEPROM
-    eeprom_write_buffer(SETTINGS_ADDR, (uint8_t*)&current_settings, sizeof(SystemSettings));
-    
-    printf("設定已儲存。\n");
+    printf("  Magic: 0x%04X\n", current_settings.magic);
+    printf("  Motor Offset: %d\n", (int) current_settings.motor_offset);
+    printf("  WiFi SSID: %s\n", current_settings.wifi_ssid);
+    printf("  Volume: %d\n", current_settings.volume);
+    printf("  Checksum: %d\n", current_settings.checksum);
+    return 0;
 }
 
-// 初始化設定
-void settings_init() 
+//! 顯示 EEPROM 裡最後一筆當機紀錄
+static int cmd_pm(int argc, char **argv)
 {
-    // 從 EEPROM 讀取整個結構體
-    eeprom_read_buffer(SETTINGS_ADDR, (uint8_t*)&current_settings, sizeof(SystemSettings));
+    static pm_record_t r;
+    if (!pm_load(&r)) {
+        printf("EEPROM 裡沒有紀錄\n");
+        return 0;
+    }
+    pm_print(&r);
+    return 0;
+}
 
-    // 檢查 Magic Number 和 Checksum
-    uint8_t calced_sum = calc_checksum(&current_settings);
-    
-    if (current_settings.magic != MAGIC_CODE || current_settings.checksum != calced_sum) 
-    {
-        printf("EEPROM 空白或資料損毀，載入預設值...\n");
-        
-        // 載入預設值
-        current_settings.magic = MAGIC_CODE;
-        strcpy((char*)current_settings.wifi_ssid, "MyWifi");
-        current_settings.volume = 50;
-        current_settings.motor_offset = 0;
-        
-        // 寫入 EEPROM (格式化)
-        settings_save(); 
-    } 
-    else 
-    {
-        printf("設定載入成功！Wifi: %s\n", current_settings.wifi_ssid);
+/*! 閒置模式：沒有參數時印出統計；指定模式後切換；再加上秒數則只在這段時間使用該模式，
+    結束後印出統計並恢復原本的模式 (搭配電流表比較各模式的耗電)
+ */
+static int cmd_idle(int argc, char **argv)
+{
+    if (argc < 2) {
+        idle_report();
+        return 0;
     }
+    idle_mode_t mode = IDLE_MODE_COUNT;
+    for (idle_mode_t m = 0; m < IDLE_MODE_COUNT; m++) {
+        if (!strcmp(argv[1], idle_mode_name(m))) mode = m;
+    }
+    if (mode == IDLE_MODE_COUNT) {
+        printf("用法: idle [spin|wfe|low] [秒]\n");
+        return 1;
+    }
+    if (argc < 3) {
+        idle_set_mode(mode);
+        idle_reset_stats();
+        return 0;
+    }
+
+    uint32_t seconds = strtoul(argv[2], NULL, 0);
+    printf("%s 模式 %u 秒...\n", idle_mode_name(mode), (uint) seconds);
+    idle_mode_t old = idle_set_mode(mode);
+    idle_reset_stats();
+    absolute_time_t end = make_timeout_time_ms(seconds * 1000);
+    while (!time_reached(end)) {
+        pm_kick();
+        idle_sleep_ms(100);
+    }
+    idle_report();
+    idle_set_mode(old);
+    idle_reset_stats();
+    return 0;
+}
+
+//! 模擬現場的狀況：EEPROM 沒有回應時 eeprom_wait_ready() 會一直等下去
+static int cmd_hang(int argc, char **argv)
+{
+    PM_TRACE("hang: wait_ready on", 0x57);
+    eeprom_init(I2C_PORT, 0x57);
+    eeprom_wait_ready();
+    return 0;
 }
 
+//! 寫入不存在的位址，產生 HardFault
+static int cmd_fault(int argc, char **argv)
+{
+    PM_TRACE("fault: write to", 0xf0000000);
+    *(volatile uint32_t *) 0xf0000000 = 0;
+    return 0;
+}
+
+static const shell_cmd_t cmds[] = {
+        {"scan",     cmd_scan,     "掃描 I2C Bus"},
+        {"dump",     cmd_dump,     "位址 [長度] 顯示 EEPROM 內容"},
+        {"settings", cmd_settings, "顯示目前的設定"},
+        {"pm",       cmd_pm,       "顯示 EEPROM 裡最後一筆當機紀錄"},
+        {"idle",     cmd_idle,     "[spin|wfe|low] [秒] 閒置模式與喚醒延遲統計"},
+        {"hang",     cmd_hang,     "測試：讓主迴圈卡在 eeprom_wait_ready()"},
+        {"fault",    cmd_fault,    "測試：產生 HardFault"},
+};
+
+// -----------------------------------------------------------------------------
+// 使用範例
+// -----------------------------------------------------------------------------
+
 int main() 
 {
     // 測試從 EEPROM 讀取的設定
     SystemSettings test_read_settings;
 
+    // 最先執行：上次當機的紀錄在 RAM 裡，其他初始化之前先取出來
+    pm_init(PM_TIMEOUT_MS);
+
     stdio_init_all();
+#if defined(uart_default)
+    clock_notify_uart(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+#endif
 
     setup_i2c();
 
+    // 有紀錄時寫進 EEPROM，USB 連上後在主迴圈印出
+    pm_save();
+
     #if !defined(i2c_default) || !defined(PICO_DEFAULT_I2C_SDA_PIN) || !defined(PICO_DEFAULT_I2C_SCL_PIN)
         printf("錯誤: 未定義預設 I2C 引腳 (請檢查 board 設定)\n");
         return 0;
@@ -363,6 +303,7 @@ int main()
         // 一般應用的做法是先 current_settings 初始化設定，之後都透過 current_settings 操作
         // 直到需要儲存時，才呼叫 settings_save() 寫回 EEPROM
         settings_init();
+        PM_TRACE("settings_init", current_settings.magic);
 
         // 這裡為了測試，所以直接讀取 EEPROM 的內容到另一個變數
         eeprom_read_buffer(SETTINGS_ADDR, (uint8_t*)&test_read_settings, sizeof(SystemSettings));
@@ -396,9 +337,15 @@ int main()
             printf("測試失敗，讀到的值不對。\n");
         }
 
+        shell_init("AT24C256", params, count_of(params), cmds, count_of(cmds));
+        // 主迴圈大部分時間在等，降到 48 MHz 睡覺 (USB 由 PLL_USB 供應，不受影響)
+        idle_init(IDLE_LOW_CLOCK);
         while (1) 
         {
-            tight_loop_contents();
+            pm_kick();
+            pm_report();
+            shell_poll();
+            idle_sleep_ms(LOOP_SLEEP_MS);
         }
 
     #endif
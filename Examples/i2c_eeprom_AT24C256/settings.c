@@ -0,0 +1,66 @@
+/*!
+  \brief 系統設定存放在 EEPROM 的範例
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "at24c256.h"
+#include "settings.h"
+
+//! 全域系統設定變數
+SystemSettings current_settings;
+
+//! 計算 Checksum (簡單累加法)
+uint8_t calc_checksum(SystemSettings *s) 
+{
+    uint8_t sum = 0;
+    uint8_t *ptr = (uint8_t*)s;
+    // 計算除了最後一個 byte (checksum 本身) 以外的所有 bytes
+    for (size_t i = 0; i < sizeof(SystemSettings) - 1; i++) 
+    {
+        sum += ptr[i];
+    }
+    return sum;
+}
+
+// 儲存設定 (包含 Update 機制，這裡簡化為全寫，建議配合上面的 Update 邏輯)
+void settings_save() 
+{
+    // 更新 Checksum
+    current_settings.checksum = calc_checksum(&current_settings);
+    
+    // 寫入 EEPROM
+    eeprom_write_buffer(SETTINGS_ADDR, (uint8_t*)&current_settings, sizeof(SystemSettings));
+    
+    printf("設定已儲存。\n");
+}
+
+// 初始化設定
+void settings_init() 
+{
+    // 從 EEPROM 讀取整個結構體
+    eeprom_read_buffer(SETTINGS_ADDR, (uint8_t*)&current_settings, sizeof(SystemSettings));
+
+    // 檢查 Magic Number 和 Checksum
+    uint8_t calced_sum = calc_checksum(&current_settings);
+    
+    if (current_settings.magic != MAGIC_CODE || current_settings.checksum != calced_sum) 
+    {
+        printf("EEPROM 空白或資料損毀，載入預設值...\n");
+        
+        // 載入預設值
+        current_settings.magic = MAGIC_CODE;
+        strcpy((char*)current_settings.wifi_ssid, "MyWifi");
+        current_settings.volume = 50;
+        current_settings.motor_offset = 0;
+        
+        // 寫入 EEPROM (格式化)
+        settings_save(); 
+    } 
+    else 
+    {
+        printf("設定載入成功！Wifi: %s\n", current_settings.wifi_ssid);
+    }
+}
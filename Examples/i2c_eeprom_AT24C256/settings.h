@@ -0,0 +1,38 @@
+/*!
+  \brief 系統設定存放在 EEPROM 的範例 (從 main.c 抽出，at24c256_bench 也會用到)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#pragma once
+
+#include <pico/stdlib.h>
+
+#define SETTINGS_ADDR   0x0000    //<! 系統設定儲存位址
+#define MAGIC_CODE      0xA55A    //<! 魔術數字，用來判斷資料有效性
+
+/*! 系統設定結構體範例(共 40 bytes)
+  \brief 包含馬達位置校正值、WiFi SSID、音量設定等
+  \note 結構體大小需注意對齊 (padding) 問題，建議使用 sizeof() 檢查\n
+        實際大小是否符合預期。最好是把結構體成員依照大小順序排列，\n
+        減少對齊浪費的空間。
+ */
+typedef struct 
+{
+    int32_t  motor_offset;  //<! 馬達位置校正值
+    uint16_t magic;         //<! 魔術數字，用來判斷資料是否有效
+    uint8_t  wifi_ssid[32]; //<! WiFi SSID
+    uint8_t  volume;        //<! 音量設定 (0-100)
+    uint8_t  checksum;      //<! 簡單的校驗和
+} SystemSettings;
+
+//! 全域系統設定變數
+extern SystemSettings current_settings;
+
+//! 計算 Checksum (簡單累加法)
+uint8_t calc_checksum(SystemSettings *s);
+
+//! 儲存設定
+void settings_save();
+
+//! 從 EEPROM 載入設定，資料無效時寫入預設值
+void settings_init();
@@ -5,11 +5,14 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "pico/stdlib.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "blink.pio.h"
+#include "clock_notify.h"
+#include "shell.h"
 
 #define LED_1       6   //<! 第一顆 LED
 #define LED_2       7   //<! 第二顆 LED
@@ -30,6 +33,61 @@ PIO pio[2];     //<! 宣告二個 PIO 執行個體
 uint sm[2];     //<! 宣告二個狀態機
 uint offset[2]; //<! 宣告二個 PIO 程式偏移量
 
+//! 每顆 LED 的設定，系統主頻改變時用來重新計算延遲
+typedef struct {
+    PIO pio;
+    uint sm;
+    uint offset;
+    uint freq;
+} blink_t;
+
+static blink_t blinks[4];
+static uint blink_count;
+
+//! 輪流切換的系統主頻 (kHz)，LED 閃爍的頻率應該不變
+static const uint32_t sys_khz[] = {150000, 48000};
+
+static void blink_clock_changed(clock_change_t change, uint32_t old_hz, uint32_t new_hz, void *ctx);
+
+// ----------------------------------------------------------------------------
+// 指令列：執行中調整閃爍頻率
+
+static uint cycle_s = 5;    //<! 幾秒切換一次系統主頻，0 表示不切換
+
+//! 閃爍頻率改變：跟系統主頻改變一樣，讓狀態機重新載入延遲值
+static bool apply_freq(const shell_param_t *p)
+{
+    for (uint i = 0; i < blink_count; i++) {
+        if (p->value == &blinks[i].freq) {
+            blink_clock_changed(CLOCK_CHANGE_PRE, 0, 0, &blinks[i]);
+            blink_clock_changed(CLOCK_CHANGE_POST, 0, 0, &blinks[i]);
+        }
+    }
+    return true;
+}
+
+static const shell_param_t params[] = {
+        SHELL_PARAM("led1", blinks[0].freq, 1, 10000, apply_freq, "LED_1 閃爍頻率 (Hz)"),
+        SHELL_PARAM("led2", blinks[1].freq, 1, 10000, apply_freq, "LED_2 閃爍頻率 (Hz)"),
+        SHELL_PARAM("led3", blinks[2].freq, 1, 10000, apply_freq, "LED_3 閃爍頻率 (Hz)"),
+        SHELL_PARAM("led4", blinks[3].freq, 1, 10000, apply_freq, "LED_4 閃爍頻率 (Hz)"),
+        SHELL_PARAM("cycle", cycle_s, 0, 3600, NULL, "幾秒切換一次系統主頻，0 不切換"),
+};
+
+static int cmd_sys(int argc, char **argv)
+{
+    if (argc == 2 && !clock_notify_set_sys_khz((uint32_t) atoi(argv[1]))) {
+        printf("無法設定 %s kHz\n", argv[1]);
+        return 1;
+    }
+    printf("clk_sys %u kHz\n", (uint) (clock_get_hz(clk_sys) / 1000));
+    return 0;
+}
+
+static const shell_cmd_t cmds[] = {
+        {"sys", cmd_sys, "[kHz] 顯示 / 設定系統主頻 (建議先 set cycle 0)"},
+};
+
 int main() 
 {
     stdio_init_all();
@@ -91,10 +149,49 @@ int main()
     pio_sm_unclaim(pio[1], sm[1] + 1);
     pio_sm_unclaim(pio[1], sm[1]);
     pio_sm_unclaim(pio[0], sm[0] + 1);
-    pio_remove_program_and_unclaim_sm(&blink_program, pio[0], sm[0], offset[0]);
+    // PIO 程式碼要留著：系統主頻改變時狀態機會跳回 offset 重新執行
+    pio_sm_unclaim(pio[0], sm[0]);
     
     // 利用了 PIO 程式碼的特性，即使沒有無窗迴圈，PIO 狀態機仍會持續運作
     printf("All leds should be flashing\n");
+
+    // 延遲值是用系統主頻算的，主頻改變時由 blink_clock_changed() 重新計算
+    clock_notify_uart(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+    shell_init("PIO blink", params, count_of(params), cmds, count_of(cmds));
+    absolute_time_t next = make_timeout_time_ms(cycle_s * 1000);
+    for (uint i = 1; ; ) {
+        shell_poll();
+        sleep_ms(10);
+        if (!cycle_s || !time_reached(next)) continue;
+        next = make_timeout_time_ms(cycle_s * 1000);
+        if (clock_notify_set_sys_khz(sys_khz[i++ % count_of(sys_khz)])) {
+            printf("clk_sys %u MHz\n", (uint) (clock_get_hz(clk_sys) / 1000000));
+        }
+    }
+}
+
+//! 半個週期要延遲的 PIO 週期數，-3 的原因請看 blink_pin_forever()
+static inline uint32_t blink_delay(uint freq)
+{
+    return (clock_get_hz(clk_sys) / (2 * freq)) - 3;
+}
+
+/*!
+  \brief 系統主頻改變時重新設定延遲值
+  延遲值在程式開頭就被放進 Y 暫存器，所以要讓狀態機從頭 (pull block) 重新執行才能換掉
+ */
+static void blink_clock_changed(clock_change_t change, uint32_t old_hz, uint32_t new_hz, void *ctx)
+{
+    blink_t *b = ctx;
+    if (change == CLOCK_CHANGE_PRE) {
+        pio_sm_set_enabled(b->pio, b->sm, false);
+        return;
+    }
+    pio_sm_clear_fifos(b->pio, b->sm);
+    pio_sm_restart(b->pio, b->sm);
+    pio_sm_exec(b->pio, b->sm, pio_encode_jmp(b->offset));
+    b->pio->txf[b->sm] = blink_delay(b->freq);
+    pio_sm_set_enabled(b->pio, b->sm, true);
 }
 
 void blink_pin_forever(PIO pio, uint sm, uint offset, uint pin, uint freq) 
@@ -127,5 +224,10 @@ void blink_pin_forever(PIO pio, uint sm, uint offset, uint pin, uint freq)
      * 所以為了精確的計時，我們需要從總目標週期數中扣除這些額外的開銷
      */
     
-    pio->txf[sm] = (clock_get_hz(clk_sys) / (2 * freq)) - 3;
+    pio->txf[sm] = blink_delay(freq);
+
+    if (blink_count < count_of(blinks)) {
+        blinks[blink_count] = (blink_t) {pio, sm, offset, freq};
+        clock_notify_register(blink_clock_changed, &blinks[blink_count++]);
+    }
 }
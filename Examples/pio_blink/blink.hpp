@@ -0,0 +1,46 @@
+/*!
+  \brief blink.pio 的 C++ 包裝：腳位與閃爍頻率是模板參數，延遲值在編譯時算好
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+    blink_pin<LED_1, 4> led1;       // GPIO 6，4 Hz
+    led1.init(pio, sm, offset);
+
+  延遲值的算法跟 blink.c 的 blink_delay() 一樣 (半個週期的 clk_sys 週期數 - 3)，
+  頻率太高 (半個週期不到 3 個週期) 或腳位不存在時編譯失敗。
+  狀態機不分頻，所以 frequency 只會被取整，actual_hz 是實際的閃爍頻率。
+
+  \note 系統主頻預設是 SYS_CLK_HZ；blink.c 會輪流改主頻，所以那裡仍用執行時計算的版本
+ */
+#pragma once
+
+#include "pio_clkdiv.hpp"
+#include "hardware/pio.h"
+#include "blink.pio.h"
+
+template <uint Pin, uint32_t FreqHz, uint32_t SysHz = SYS_CLK_HZ>
+class blink_pin {
+    static_assert(Pin < NUM_BANK0_GPIOS, "no such GPIO");
+    static_assert(FreqHz > 0, "blink frequency must be positive");
+    static_assert(SysHz / (2 * (uint64_t) FreqHz) >= 3, "blink frequency too high for the PIO loop overhead");
+
+public:
+    //! 放進 Y 暫存器的延遲值，-3 是 mov、set 與最後一次 jmp 的週期
+    static constexpr uint32_t delay = SysHz / (2 * FreqHz) - 3;
+    static constexpr double actual_hz = (double) SysHz / (2.0 * (delay + 3));
+
+    //! 設定並啟動狀態機，送出延遲值 (程式已經用 pio_add_program() 載入到 offset)
+    void init(PIO p, uint state_machine, uint offset)
+    {
+        pio_assert_sys_hz<SysHz>();
+        pio = p;
+        sm = state_machine;
+        blink_program_init(pio, sm, offset, Pin);
+        pio_sm_set_enabled(pio, sm, true);
+        pio->txf[sm] = delay;
+    }
+
+private:
+    PIO pio = nullptr;
+    uint sm = 0;
+};
@@ -0,0 +1,46 @@
+/*!
+  \brief blink.c 的 C++ 版本：用 blink.hpp 在編譯時決定腳位與頻率
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  跟 blink.c 一樣讓 4 顆 LED 以 4、3、2、1 Hz 閃爍 (不含指令列與主頻切換)。
+  把任一個頻率改成 100000000 試試看，編譯時就會失敗。
+ */
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "blink.hpp"
+
+#define LED_1       6   //<! 第一顆 LED
+#define LED_2       7   //<! 第二顆 LED
+#define LED_3       8   //<! 第三顆 LED
+#define LED_4       9   //<! 第四顆 LED
+
+static blink_pin<LED_1, 4> led1;
+static blink_pin<LED_2, 3> led2;
+static blink_pin<LED_3, 2> led3;
+static blink_pin<LED_4, 1> led4;
+
+int main()
+{
+    stdio_init_all();
+
+    PIO pio;
+    uint sm;
+    uint offset;
+    bool rc = pio_claim_free_sm_and_add_program_for_gpio_range(&blink_program, &pio, &sm, &offset, LED_1, 4, true);
+    hard_assert(rc);
+
+    // 同一個 PIO 的其他 3 個狀態機
+    led1.init(pio, sm, offset);
+    led2.init(pio, pio_claim_unused_sm(pio, true), offset);
+    led3.init(pio, pio_claim_unused_sm(pio, true), offset);
+    led4.init(pio, pio_claim_unused_sm(pio, true), offset);
+
+    printf("LED_1 %.3f Hz (延遲值 %u)\n", decltype(led1)::actual_hz, (uint) decltype(led1)::delay);
+    printf("LED_4 %.3f Hz (延遲值 %u)\n", decltype(led4)::actual_hz, (uint) decltype(led4)::delay);
+
+    while (true) tight_loop_contents();
+}
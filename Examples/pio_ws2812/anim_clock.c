@@ -0,0 +1,48 @@
+/*!
+  \brief 以實際時間驅動的動畫時基
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include "pico/stdlib.h"
+
+#include "anim_clock.h"
+
+void anim_clock_init(anim_clock_t *clock, uint32_t budget_us)
+{
+    clock->now_us = time_us_64();
+    clock->dt_us = 0;
+    clock->budget_us = budget_us;
+    clock->load_us = 0;
+    clock->divider = 1;
+    clock->frame = 0;
+}
+
+uint32_t anim_clock_tick(anim_clock_t *clock)
+{
+    uint64_t now = time_us_64();
+    uint64_t dt = now - clock->now_us;
+    clock->now_us = now;
+    clock->dt_us = dt > ANIM_MAX_DT_US ? ANIM_MAX_DT_US : (uint32_t) dt;
+    clock->frame++;
+    return clock->dt_us;
+}
+
+void anim_clock_report_load(anim_clock_t *clock, uint32_t busy_us)
+{
+    // 1/8 的指數移動平均
+    clock->load_us = clock->load_us - (clock->load_us >> 3) + (busy_us >> 3);
+
+    if (clock->load_us > clock->budget_us && clock->divider < ANIM_MAX_DIVIDER) {
+        clock->divider *= 2;
+        clock->load_us = clock->budget_us * 3 / 4;
+    } else if (clock->load_us < clock->budget_us / 2 && clock->divider > 1) {
+        clock->divider /= 2;
+        clock->load_us = clock->budget_us * 3 / 4;
+    }
+}
+
+void anim_phase_set_rate(anim_phase_t *phase, int units_per_s)
+{
+    // Q0.32 單位 / us，誤差約百萬分之一
+    phase->inc = ((int64_t) units_per_s << 32) / 1000000;
+}
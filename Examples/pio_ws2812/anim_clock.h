@@ -0,0 +1,89 @@
+/*!
+  \brief 以實際時間驅動的動畫時基
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  燈效原本用 frame 計數器 t 做動畫，frame rate 一變 (燈條變長、運算變多) 速度就跟著變。
+  這裡改成：
+  - anim_clock_t：每個 frame 開始時讀 time_us_64()，算出經過的時間 dt
+  - anim_phase_t：每個燈效一個相位累加器 (Q32.32)，依 dt 前進，
+    整數部分就是餵給燈效的 t，所以動畫速度固定是「每秒幾個單位」
+  - 負載太重時降低燈效重畫的頻率 (每 2 或 4 個 frame 畫一次)，
+    因為相位還是照實際時間前進，動畫不會變慢，只是變得比較不連續
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define ANIM_MAX_DT_US 100000   //<! dt 上限，避免中斷點、除錯暫停後動畫一次跳太多
+#define ANIM_MAX_DIVIDER 4      //<! 降載時最多每 4 個 frame 重畫一次
+
+//! frame 時基
+typedef struct {
+    uint64_t now_us;        //<! 這個 frame 開始的時間
+    uint32_t dt_us;         //<! 跟上一個 frame 相差的時間
+    uint32_t budget_us;     //<! 每個 frame 可用的運算時間
+    uint32_t load_us;       //<! 運算時間的移動平均
+    uint divider;           //<! 每幾個 frame 重畫一次燈效 (1, 2, 4)
+    uint frame;             //<! frame 計數
+} anim_clock_t;
+
+//! 燈效相位，Q32.32 的時間單位
+typedef struct {
+    uint64_t phase;
+    int64_t inc;            //<! 每 us 前進多少 (Q0.32)，負數表示倒著播
+} anim_phase_t;
+
+//! 初始化時基
+void anim_clock_init(anim_clock_t *clock, uint32_t budget_us);
+
+//! frame 開始時呼叫，回傳 dt (us)
+uint32_t anim_clock_tick(anim_clock_t *clock);
+
+//! 這個 frame 要不要重畫燈效
+static inline bool anim_clock_render_due(const anim_clock_t *clock)
+{
+    return (clock->frame % clock->divider) == 0;
+}
+
+/*! 回報這個 frame 花了多少運算時間，依此調整 divider
+  \note 超過預算就加倍 divider，低於預算的一半才減半，避免來回跳動
+ */
+void anim_clock_report_load(anim_clock_t *clock, uint32_t busy_us);
+
+/*! 設定相位速度
+  \param units_per_s 每秒前進幾個 t 單位，負數倒著播，0 表示靜止
+ */
+void anim_phase_set_rate(anim_phase_t *phase, int units_per_s);
+
+//! 相位歸零
+static inline void anim_phase_reset(anim_phase_t *phase)
+{
+    phase->phase = 0;
+}
+
+//! 依 dt 前進，回傳目前的整數 t
+static inline uint anim_phase_advance(anim_phase_t *phase, uint32_t dt_us)
+{
+    phase->phase += (uint64_t) (phase->inc * (int64_t) dt_us);
+    return (uint) (phase->phase >> 32);
+}
+
+//! 目前的整數 t
+static inline uint anim_phase_t_value(const anim_phase_t *phase)
+{
+    return (uint) (phase->phase >> 32);
+}
+
+/*! 整數雜湊，給隨機類的燈效用
+  同一個 t 算出來的結果固定，重畫幾次都一樣，不用依賴 frame 剛好落在某個 t 上
+ */
+static inline uint32_t anim_hash(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
@@ -0,0 +1,130 @@
+/*!
+  \brief Art-Net / sACN 接收範例：燈光控台透過 Wi-Fi 控制 WS2812
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  pico2_w 連上 Wi-Fi (編譯時指定 -DWIFI_SSID=... -DWIFI_PASSWORD=...)，
+  在 UDP 6454 (Art-Net) 與 5568 (sACN) 接收 universe FIRST_UNIVERSE 開始的 UNIVERSES 個 universe，
+  每個 universe 170 顆 RGB，全部接在同一條燈上。
+
+  使用 pico_cyw43_arch_lwip_poll：封包只在 cyw43_arch_poll() 裡處理，
+  所以送出畫面的期間燈條緩衝區不會被改寫，不需要第二份緩衝區也不會撕裂。
+  資料路徑：pbuf -> strip_data (artnet_rx_input 唯一的一次複製) -> render_rgb 轉成線上格式 -> DMA。
+ */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/pio.h"
+#include "lwip/igmp.h"
+#include "lwip/udp.h"
+#include "ws2812.pio.h"
+
+#include "artnet_rx.h"
+#include "ws2812_stream.h"
+
+#define WS2812_PIN      16      //<! 連接到 WS2812 的 GPIO 腳位
+#define FIRST_UNIVERSE  1       //<! sACN 從 1 開始；Art-Net 控台送 0 開始時改成 0
+#define UNIVERSES       4
+#define UNIVERSE_PIXELS 170
+#define NUM_PIXELS      (UNIVERSES * UNIVERSE_PIXELS)   //<! 燈珠數量
+
+static uint8_t strip_data[NUM_PIXELS * 3];      //<! DMX 順序 (R, G, B)
+static const artnet_strip_t strip = {strip_data, sizeof(strip_data)};
+static artnet_map_t map[UNIVERSES];
+static artnet_rx_t rx;
+
+//! lwIP 收到 UDP 封包
+static void udp_received(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    artnet_rx_input(&rx, p, time_us_64());
+    pbuf_free(p);
+}
+
+static bool udp_listen(uint16_t port)
+{
+    struct udp_pcb *pcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+    if (!pcb || udp_bind(pcb, IP_ANY_TYPE, port) != ERR_OK) return false;
+    udp_recv(pcb, udp_received, NULL);
+    return true;
+}
+
+//! RGB bytes 轉成線上格式 (GRB << 8)
+static void render_rgb(uint32_t *out, uint first, uint count, void *ctx)
+{
+    const uint8_t *rgb = (const uint8_t *) ctx + first * 3;
+    for (uint i = 0; i < count; i++, rgb += 3) {
+        out[i] = ((uint32_t) rgb[1] << 24) | ((uint32_t) rgb[0] << 16) | ((uint32_t) rgb[2] << 8);
+    }
+}
+
+int main()
+{
+    stdio_init_all();
+
+    PIO pio;
+    uint sm;
+    uint offset;
+    bool success = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_program, &pio, &sm, &offset, WS2812_PIN, 1, true);
+    hard_assert(success);
+    ws2812_program_init(pio, sm, offset, WS2812_PIN, 800000, false);
+    ws2812_stream_init(pio, sm);
+
+    if (cyw43_arch_init()) {
+        printf("cyw43 init failed\n");
+        return 1;
+    }
+    cyw43_arch_enable_sta_mode();
+    printf("connecting to %s...\n", WIFI_SSID);
+    while (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000)) {
+        printf("connect failed, retrying\n");
+    }
+    printf("IP %s\n", ip4addr_ntoa(netif_ip4_addr(netif_list)));
+
+    for (uint u = 0; u < UNIVERSES; u++) {
+        map[u] = (artnet_map_t) {
+            .universe = FIRST_UNIVERSE + u,
+            .dmx_offset = 0,
+            .length = UNIVERSE_PIXELS * 3,
+            .strip = 0,
+            .strip_offset = u * UNIVERSE_PIXELS * 3,
+        };
+        // sACN multicast 239.255.<universe 高位>.<universe 低位>
+        ip4_addr_t group;
+        IP4_ADDR(&group, 239, 255, map[u].universe >> 8, map[u].universe & 0xff);
+        igmp_joingroup(IP4_ADDR_ANY4, &group);
+    }
+    artnet_rx_init(&rx, map, UNIVERSES, &strip, 1);
+    hard_assert(udp_listen(ARTNET_PORT) && udp_listen(E131_PORT));
+    printf("Art-Net / sACN universes %d-%d -> %d pixels on pin %d\n",
+           FIRST_UNIVERSE, FIRST_UNIVERSE + UNIVERSES - 1, NUM_PIXELS, WS2812_PIN);
+
+    uint64_t report_us = time_us_64() + 1000000;
+    while (true) {
+        cyw43_arch_poll();
+
+        if (artnet_rx_take_frame(&rx)) {
+            // 送出期間不呼叫 cyw43_arch_poll()，封包留在 cyw43 晶片裡等下一輪
+            ws2812_stream_start(NUM_PIXELS, render_rgb, strip_data);
+            while (!ws2812_stream_poll()) {
+                tight_loop_contents();
+            }
+            while (!ws2812_stream_done()) {
+                tight_loop_contents();
+            }
+            sleep_us(400);  // reset
+        }
+
+        if (time_us_64() >= report_us) {
+            report_us += 1000000;
+            artnet_stats_t s;
+            ws2812_stream_stats_t ss;
+            artnet_rx_get_stats(&rx, &s, true);
+            ws2812_stream_get_stats(&ss, true);
+            printf("packets/s %u (dmx %u sync %u invalid %u) latches %u latency avg %u max %u us, seq err %u, underruns %u\n",
+                   (uint) s.packets, (uint) s.dmx_packets, (uint) s.sync_packets, (uint) s.invalid,
+                   (uint) s.latches, s.latches ? (uint) (s.latency_us_sum / s.latches) : 0,
+                   (uint) s.latency_us_max, (uint) s.sequence_errors, (uint) ss.underruns);
+        }
+    }
+}
@@ -0,0 +1,274 @@
+/*!
+  \brief Art-Net / sACN (E1.31) 接收
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <string.h>
+
+#include "artnet_rx.h"
+
+// Art-Net
+#define ARTNET_ID_LEN       8
+#define ARTNET_OP_DMX       0x5000
+#define ARTNET_OP_SYNC      0x5200
+#define ARTNET_DMX_HEADER   18
+
+// E1.31 (ANSI E1.31-2018)
+#define E131_ROOT_VECTOR_DATA       0x00000004
+#define E131_ROOT_VECTOR_EXTENDED   0x00000008
+#define E131_FRAME_VECTOR_DATA      0x00000002
+#define E131_EXT_VECTOR_SYNC        0x00000001
+#define E131_DMP_VECTOR             0x02
+#define E131_DMP_ADDRESS_TYPE       0xa1
+#define E131_OPTION_TERMINATED      0x40
+#define E131_DATA_HEADER            126     //<! 含 START code
+#define E131_CID                    22      //<! 來源的 CID (16 bytes)
+#define E131_SYNC_LENGTH            49
+
+static const uint8_t artnet_id[ARTNET_ID_LEN] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+static const uint8_t acn_id[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+
+static inline uint16_t be16(const uint8_t *b)
+{
+    return (uint16_t) ((b[0] << 8) | b[1]);
+}
+
+static inline uint32_t be32(const uint8_t *b)
+{
+    return ((uint32_t) b[0] << 24) | ((uint32_t) b[1] << 16) | ((uint32_t) b[2] << 8) | b[3];
+}
+
+//! E1.31 來源 CID 的 FNV-1a 雜湊 (只用來區分序號)
+static uint32_t cid_hash(const uint8_t *cid)
+{
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 16; i++) h = (h ^ cid[i]) * 16777619u;
+    return h;
+}
+
+uint32_t artnet_pbuf_read(const struct pbuf *p, uint32_t offset, void *dst, uint32_t len)
+{
+    uint8_t *out = (uint8_t *) dst;
+    uint32_t done = 0;
+    for (; p && done < len; p = p->next) {
+        if (offset >= p->len) {
+            offset -= p->len;
+            continue;
+        }
+        uint32_t n = p->len - offset;
+        if (n > len - done) n = len - done;
+        memcpy(out + done, (const uint8_t *) p->payload + offset, n);
+        done += n;
+        offset = 0;
+    }
+    return done;
+}
+
+void artnet_rx_init(artnet_rx_t *rx, const artnet_map_t *map, uint32_t map_count,
+                    const artnet_strip_t *strips, uint32_t strip_count)
+{
+    memset(rx, 0, sizeof(*rx));
+    if (map_count > ARTNET_MAX_MAPS) map_count = ARTNET_MAX_MAPS;
+    rx->map = map;
+    rx->map_count = map_count;
+    rx->strips = strips;
+    rx->strip_count = strip_count;
+    rx->all_mask = map_count == 32 ? 0xffffffffu : (1u << map_count) - 1;
+}
+
+static void latch(artnet_rx_t *rx, uint64_t now_us)
+{
+    if (!rx->frame_open) return;
+
+    uint32_t latency = (uint32_t) (now_us - rx->frame_start_us);
+    rx->stats.latency_us_sum += latency;
+    if (latency > rx->stats.latency_us_max) rx->stats.latency_us_max = latency;
+    rx->stats.latches++;
+
+    rx->latched = true;
+    rx->frame_open = false;
+    rx->received_mask = 0;
+}
+
+static inline bool sync_mode(const artnet_rx_t *rx, uint64_t now_us)
+{
+    return rx->last_sync_us && now_us - rx->last_sync_us < ARTNET_SYNC_TIMEOUT_US;
+}
+
+//! 序號檢查方式
+typedef enum {
+    SEQUENCE_NONE,      //<! 不檢查 (Art-Net 序號 0)
+    SEQUENCE_COUNT,     //<! 只記錄不連續的次數 (Art-Net)
+    SEQUENCE_STRICT,    //<! 亂序的封包丟掉 (E1.31 6.7.2)
+} sequence_check_t;
+
+//! 找到 universe + 來源的序號記錄，沒有時配置一個 (滿了就依序覆蓋最舊的)
+static artnet_sequence_t *find_sequence(artnet_rx_t *rx, uint16_t universe, uint32_t source)
+{
+    artnet_sequence_t *free_slot = NULL;
+    for (uint32_t i = 0; i < ARTNET_MAX_MAPS; i++) {
+        artnet_sequence_t *s = &rx->sequence[i];
+        if (!s->valid) {
+            if (!free_slot) free_slot = s;
+        } else if (s->universe == universe && s->source == source) {
+            return s;
+        }
+    }
+    if (!free_slot) {
+        free_slot = &rx->sequence[rx->sequence_next];
+        rx->sequence_next = (rx->sequence_next + 1) % ARTNET_MAX_MAPS;
+    }
+    *free_slot = (artnet_sequence_t) {.universe = universe, .source = source};
+    return free_slot;
+}
+
+//! 檢查並更新序號，封包要丟掉時回傳 false
+static bool check_sequence(artnet_rx_t *rx, uint16_t universe, uint32_t source, uint8_t sequence,
+                           sequence_check_t check)
+{
+    if (check == SEQUENCE_NONE) return true;
+    artnet_sequence_t *s = find_sequence(rx, universe, source);
+    uint8_t expected = (uint8_t) (s->last + 1);
+    if (check == SEQUENCE_COUNT && !expected) expected = 1;    // Art-Net 的序號 255 之後是 1
+    int8_t diff = (int8_t) (sequence - s->last);
+    if (s->valid && sequence != expected) {
+        rx->stats.sequence_errors++;
+        // 往回 1 ~ 19 表示亂序 (或重複)
+        if (check == SEQUENCE_STRICT && diff <= 0 && diff > -20) return false;
+    }
+    s->last = sequence;
+    s->valid = true;
+    return true;
+}
+
+/*! 把一個 universe 的資料寫進所有對應的燈條
+  序號在複製之前檢查一次：同一個 universe 的所有對照項一起套用或一起丟掉
+  \param data_offset DMX channel 0 在封包裡的位置
+  \param source 來源識別 (同一個 universe 可能有好幾個控台在送)
+ */
+static artnet_packet_t apply_universe(artnet_rx_t *rx, const struct pbuf *p, uint16_t universe,
+                                      uint32_t data_offset, uint32_t data_len, uint8_t sequence, uint32_t source,
+                                      sequence_check_t check, bool wants_sync, uint64_t now_us)
+{
+    uint32_t maps = 0;
+    for (uint32_t m = 0; m < rx->map_count; m++) {
+        const artnet_map_t *map = &rx->map[m];
+        if (map->universe == universe && map->strip < rx->strip_count) maps |= 1u << m;
+    }
+    if (!maps) return ARTNET_PACKET_IGNORED;
+    if (!check_sequence(rx, universe, source, sequence, check)) return ARTNET_PACKET_IGNORED;
+
+    for (uint32_t m = 0; m < rx->map_count; m++) {
+        const artnet_map_t *map = &rx->map[m];
+        if (!(maps & (1u << m))) continue;
+
+        if (map->dmx_offset < data_len) {
+            const artnet_strip_t *strip = &rx->strips[map->strip];
+            uint32_t len = map->length;
+            if (len > data_len - map->dmx_offset) len = data_len - map->dmx_offset;
+            if (map->strip_offset >= strip->length) continue;
+            if (len > strip->length - map->strip_offset) len = strip->length - map->strip_offset;
+            // 唯一的一次複製：pbuf -> 燈條緩衝區
+            artnet_pbuf_read(p, data_offset + map->dmx_offset, strip->data + map->strip_offset, len);
+        }
+    }
+    rx->received_mask |= maps;
+
+    if (!rx->frame_open) {
+        rx->frame_open = true;
+        rx->frame_start_us = now_us;
+    }
+    // 資料封包指定了同步位址：第一次就先進入同步模式，之後的逾時由同步封包本身決定
+    if (wants_sync && !rx->last_sync_us) rx->last_sync_us = now_us;
+    if (!sync_mode(rx, now_us) && (rx->received_mask & rx->all_mask) == rx->all_mask) {
+        latch(rx, now_us);
+    }
+    return ARTNET_PACKET_DMX;
+}
+
+static artnet_packet_t input_artnet(artnet_rx_t *rx, const struct pbuf *p, uint64_t now_us)
+{
+    uint8_t h[ARTNET_DMX_HEADER];
+    uint32_t n = artnet_pbuf_read(p, 0, h, sizeof(h));
+    if (n < 12) return ARTNET_PACKET_INVALID;
+
+    uint16_t op = (uint16_t) (h[8] | (h[9] << 8));     // opcode 是 little endian
+    if (op == ARTNET_OP_SYNC) {
+        rx->last_sync_us = now_us;
+        latch(rx, now_us);
+        return ARTNET_PACKET_SYNC;
+    }
+    if (op != ARTNET_OP_DMX) return ARTNET_PACKET_IGNORED;
+    if (n < ARTNET_DMX_HEADER) return ARTNET_PACKET_INVALID;
+
+    uint16_t universe = (uint16_t) (((h[15] & 0x7f) << 8) | h[14]);
+    uint32_t len = be16(&h[16]);
+    if (len > 512 || ARTNET_DMX_HEADER + len > p->tot_len) return ARTNET_PACKET_INVALID;
+
+    return apply_universe(rx, p, universe, ARTNET_DMX_HEADER, len, h[12], 0,
+                          h[12] ? SEQUENCE_COUNT : SEQUENCE_NONE, false, now_us);
+}
+
+static artnet_packet_t input_e131(artnet_rx_t *rx, const struct pbuf *p, uint64_t now_us)
+{
+    uint8_t h[E131_DATA_HEADER];
+    uint32_t n = artnet_pbuf_read(p, 0, h, sizeof(h));
+    if (n < E131_SYNC_LENGTH) return ARTNET_PACKET_INVALID;
+
+    uint32_t root_vector = be32(&h[18]);
+    if (root_vector == E131_ROOT_VECTOR_EXTENDED) {
+        if (be32(&h[40]) != E131_EXT_VECTOR_SYNC) return ARTNET_PACKET_IGNORED;
+        rx->last_sync_us = now_us;
+        latch(rx, now_us);
+        return ARTNET_PACKET_SYNC;
+    }
+    if (root_vector != E131_ROOT_VECTOR_DATA) return ARTNET_PACKET_IGNORED;
+    if (n < E131_DATA_HEADER || be32(&h[40]) != E131_FRAME_VECTOR_DATA ||
+        h[117] != E131_DMP_VECTOR || h[118] != E131_DMP_ADDRESS_TYPE) {
+        return ARTNET_PACKET_INVALID;
+    }
+    if (h[112] & E131_OPTION_TERMINATED) return ARTNET_PACKET_IGNORED;
+    if (h[125] != 0) return ARTNET_PACKET_IGNORED;      // 只處理 START code 0 (一般 DMX)
+
+    uint32_t count = be16(&h[123]);     // 含 START code
+    if (count < 1 || count > 513 || E131_DATA_HEADER - 1 + count > p->tot_len) return ARTNET_PACKET_INVALID;
+
+    uint16_t sync_address = be16(&h[109]);
+    return apply_universe(rx, p, be16(&h[113]), E131_DATA_HEADER, count - 1, h[111], cid_hash(&h[E131_CID]),
+                          SEQUENCE_STRICT, sync_address != 0, now_us);
+}
+
+artnet_packet_t artnet_rx_input(artnet_rx_t *rx, const struct pbuf *p, uint64_t now_us)
+{
+    uint8_t id[16];
+    uint32_t n = artnet_pbuf_read(p, 0, id, sizeof(id));
+    artnet_packet_t kind = ARTNET_PACKET_INVALID;
+
+    if (n >= ARTNET_ID_LEN && !memcmp(id, artnet_id, ARTNET_ID_LEN)) {
+        kind = input_artnet(rx, p, now_us);
+    } else if (n >= 16 && be16(&id[0]) == 0x0010 && !memcmp(&id[4], acn_id, sizeof(acn_id))) {
+        kind = input_e131(rx, p, now_us);
+    }
+
+    switch (kind) {
+        case ARTNET_PACKET_INVALID: rx->stats.invalid++; return kind;
+        case ARTNET_PACKET_IGNORED: rx->stats.ignored++; break;
+        case ARTNET_PACKET_DMX: rx->stats.dmx_packets++; break;
+        case ARTNET_PACKET_SYNC: rx->stats.sync_packets++; break;
+    }
+    rx->stats.packets++;
+    return kind;
+}
+
+bool artnet_rx_take_frame(artnet_rx_t *rx)
+{
+    bool latched = rx->latched;
+    rx->latched = false;
+    return latched;
+}
+
+void artnet_rx_get_stats(artnet_rx_t *rx, artnet_stats_t *stats, bool reset)
+{
+    *stats = rx->stats;
+    if (reset) memset(&rx->stats, 0, sizeof(rx->stats));
+}
@@ -0,0 +1,117 @@
+/*!
+  \brief Art-Net / sACN (E1.31) 接收：UDP 封包直接寫進燈條緩衝區
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  燈光控台用 Art-Net (UDP 6454) 或 sACN (UDP 5568) 送 DMX universe，
+  每個 universe 最多 512 個 channel (170 顆 RGB)。
+
+  - 直接從 lwIP 的 pbuf 串列讀取，DMX 資料只複製一次：從 pbuf 到燈條緩衝區
+  - 對照表 (artnet_map_t) 決定每個 universe 的哪一段寫到哪條燈的哪個位置
+  - 收到同步封包 (ArtSync / E1.31 Synchronization) 才鎖存 (latch) 一個畫面；
+    沒有使用同步封包時，對照表裡所有 universe 都收到一次就鎖存
+
+  只用到 pbuf 的 next / payload / len / tot_len 欄位，不依賴 Pico SDK，
+  電腦上用 host/lwip_shim 的 pbuf 定義就能編譯 (host/artnet_replay)。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lwip/pbuf.h"
+
+#define ARTNET_PORT             6454
+#define E131_PORT               5568
+#define ARTNET_MAX_MAPS         32          //<! 對照表最多幾項
+#define ARTNET_SYNC_TIMEOUT_US  4000000     //<! 超過 4 秒沒收到同步封包就回到「收齊就鎖存」
+
+//! 封包種類
+typedef enum {
+    ARTNET_PACKET_INVALID,      //<! 不是 Art-Net / E1.31，或格式錯誤
+    ARTNET_PACKET_IGNORED,      //<! 格式正確但不需要處理 (其他 opcode、沒對應的 universe…)
+    ARTNET_PACKET_DMX,          //<! DMX 資料，已經寫進燈條緩衝區
+    ARTNET_PACKET_SYNC,         //<! 同步封包
+} artnet_packet_t;
+
+/*! 對照表的一項：universe 裡 [dmx_offset, dmx_offset + length) 的資料
+  寫到 strips[strip] 的 strip_offset 位置
+  \note Art-Net 的 universe 是 15-bit Port-Address (Net << 8 | Sub-Net << 4 | Universe)，
+        sACN 是 1 ~ 63999，兩種協定用同一個欄位，請依控台設定填寫
+ */
+typedef struct {
+    uint16_t universe;
+    uint16_t dmx_offset;    //<! 第一個 channel (從 0 開始)
+    uint16_t length;        //<! bytes
+    uint8_t strip;
+    uint32_t strip_offset;  //<! bytes
+} artnet_map_t;
+
+//! 燈條緩衝區，內容是 DMX 的順序 (通常是 RGB)，輸出時再轉成線上格式
+typedef struct {
+    uint8_t *data;
+    uint32_t length;
+} artnet_strip_t;
+
+//! 統計資料
+typedef struct {
+    uint32_t packets;           //<! 有效封包
+    uint32_t dmx_packets;
+    uint32_t sync_packets;
+    uint32_t latches;           //<! 鎖存的畫面數
+    uint32_t ignored;
+    uint32_t invalid;
+    uint32_t sequence_errors;   //<! 序號不連續 (E1.31 亂序的封包會被丟掉)
+    uint64_t latency_us_sum;    //<! 畫面第一個封包到鎖存的時間總和
+    uint32_t latency_us_max;
+} artnet_stats_t;
+
+//! 一個 universe + 來源最後的序號
+typedef struct {
+    uint16_t universe;
+    bool valid;
+    uint8_t last;
+    uint32_t source;        //<! E1.31 的 CID 雜湊，Art-Net 是 0
+} artnet_sequence_t;
+
+//! 接收器狀態
+typedef struct {
+    const artnet_map_t *map;
+    uint32_t map_count;
+    const artnet_strip_t *strips;
+    uint32_t strip_count;
+
+    uint32_t all_mask;          //<! 所有對照項
+    uint32_t received_mask;     //<! 這個畫面已經收到的對照項
+    bool frame_open;            //<! 這個畫面已經收到資料
+    uint64_t frame_start_us;
+    uint64_t last_sync_us;      //<! 最後一次收到同步封包的時間，0 表示沒收過
+    bool latched;               //<! 有新畫面還沒被 artnet_rx_take_frame() 取走
+    artnet_sequence_t sequence[ARTNET_MAX_MAPS];    //<! 每個 universe + 來源各一份 (同一個 universe 的對照項共用)
+    uint32_t sequence_next;                         //<! 滿了的時候下一個要覆蓋的位置
+
+    artnet_stats_t stats;
+} artnet_rx_t;
+
+/*! 初始化
+  \param map 對照表，最多 ARTNET_MAX_MAPS 項，要在 rx 使用期間保持有效
+  \param strips 燈條緩衝區
+ */
+void artnet_rx_init(artnet_rx_t *rx, const artnet_map_t *map, uint32_t map_count,
+                    const artnet_strip_t *strips, uint32_t strip_count);
+
+/*! 處理一個 UDP payload (Art-Net 或 E1.31，依內容判斷)
+  \param now_us 收到的時間，用來算鎖存延遲與同步逾時
+ */
+artnet_packet_t artnet_rx_input(artnet_rx_t *rx, const struct pbuf *p, uint64_t now_us);
+
+//! 有新鎖存的畫面時回傳 true (每個畫面只回傳一次)
+bool artnet_rx_take_frame(artnet_rx_t *rx);
+
+//! 讀取統計資料，reset 為 true 時歸零
+void artnet_rx_get_stats(artnet_rx_t *rx, artnet_stats_t *stats, bool reset);
+
+/*! 從 pbuf 串列的 offset 開始複製 len bytes 到 dst
+  \return 實際複製的 bytes (封包不夠長時會比 len 少)
+ */
+uint32_t artnet_pbuf_read(const struct pbuf *p, uint32_t offset, void *dst, uint32_t len);
@@ -0,0 +1,178 @@
+/*!
+  \brief 音訊分析：ADC 擷取、頻帶能量與節拍偵測
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+
+#include "audio_analysis.h"
+
+// -----------------------------------------------------------------------------
+// ADC 擷取
+// -----------------------------------------------------------------------------
+
+#define RING_BYTES (AUDIO_RING_SAMPLES * sizeof(uint16_t))
+
+// DMA write ring 要求緩衝區對齊到自己的大小
+static uint16_t audio_ring[AUDIO_RING_SAMPLES] __attribute__((aligned(RING_BYTES)));
+static uint audio_chan[2];
+
+static uint ring_bits(void)
+{
+    uint bits = 0;
+    while ((1u << bits) < RING_BYTES) bits++;
+    return bits;
+}
+
+void audio_capture_init(uint adc_input)
+{
+    adc_init();
+    adc_gpio_init(26 + adc_input);
+    adc_select_input(adc_input);
+
+    // 每個樣本要 96 個 ADC clock (48 MHz)，除頻值 = 48 MHz / fs - 1
+    adc_set_clkdiv(48000000.0f / AUDIO_SAMPLE_RATE - 1.0f);
+    adc_fifo_setup(true,    // 寫入 FIFO
+                   true,    // 啟用 DREQ
+                   1,       // 有 1 個樣本就送 DREQ
+                   false,   // 不要錯誤旗標
+                   false);  // 保持 12 bits
+
+    audio_chan[0] = dma_claim_unused_channel(true);
+    audio_chan[1] = dma_claim_unused_channel(true);
+
+    // 兩個通道都寫滿整個 ring 之後 chain 給對方，寫入位址靠 ring 自動繞回起點
+    for (uint i = 0; i < 2; i++) {
+        dma_channel_config c = dma_channel_get_default_config(audio_chan[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_ring(&c, true, ring_bits());
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, audio_chan[i ^ 1]);
+        dma_channel_configure(audio_chan[i], &c, audio_ring, &adc_hw->fifo, AUDIO_RING_SAMPLES, false);
+    }
+
+    dma_channel_start(audio_chan[0]);
+    adc_run(true);
+}
+
+void audio_capture_latest(int16_t *dst, uint n)
+{
+    if (n > AUDIO_RING_SAMPLES) n = AUDIO_RING_SAMPLES;
+
+    // 正在跑的那個通道的寫入位址就是最新的位置
+    uint ch = dma_channel_is_busy(audio_chan[0]) ? audio_chan[0] : audio_chan[1];
+    uint head = (dma_channel_hw_addr(ch)->write_addr - (uintptr_t) audio_ring) / sizeof(uint16_t);
+
+    int32_t sum = 0;
+    for (uint i = 0; i < n; i++) {
+        int32_t s = audio_ring[(head - n + i) & (AUDIO_RING_SAMPLES - 1)];
+        dst[i] = (int16_t) s;
+        sum += s;
+    }
+
+    // 去除直流後由 12 bits 放大成 Q15
+    int32_t dc = sum / (int32_t) n;
+    for (uint i = 0; i < n; i++) {
+        int32_t v = ((int32_t) dst[i] - dc) << 4;
+        if (v > 32767) v = 32767;
+        if (v < -32768) v = -32768;
+        dst[i] = (int16_t) v;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// 頻帶能量與節拍
+// -----------------------------------------------------------------------------
+
+//! 各頻帶的起始 bin (對數分佈)，最後一個是結束；跳過 DC，其餘依 AUDIO_FFT_BINS 等比例縮放
+//! (256 點 FFT 時是 1, 2, 4, 8, 16, 32, 64, 96, 128)
+#if AUDIO_NUM_BANDS != 8
+#error band_edges assumes AUDIO_NUM_BANDS == 8
+#endif
+#if AUDIO_FFT_LOG2 < 8
+#error band_edges needs AUDIO_FFT_LOG2 >= 8 (the lowest bands would be empty)
+#endif
+static const uint16_t band_edges[AUDIO_NUM_BANDS + 1] = {
+    1,
+    AUDIO_FFT_BINS >> 6, AUDIO_FFT_BINS >> 5, AUDIO_FFT_BINS >> 4,
+    AUDIO_FFT_BINS >> 3, AUDIO_FFT_BINS >> 2, AUDIO_FFT_BINS >> 1,
+    AUDIO_FFT_BINS * 3 / 4, AUDIO_FFT_BINS,
+};
+
+static uint32_t beat_history[AUDIO_BEAT_HISTORY];
+static uint32_t beat_sum;
+static uint beat_pos;
+static uint beat_holdoff;
+static uint32_t frame_count;
+
+void audio_analysis_reset(void)
+{
+    memset(beat_history, 0, sizeof(beat_history));
+    beat_sum = 0;
+    beat_pos = 0;
+    beat_holdoff = 0;
+    frame_count = 0;
+}
+
+/*! 對數刻度：整數部分用最高位元位置，小數部分取下面 3 個 bits
+  \return 每 2 倍能量 (+3 dB) 增加 8
+ */
+static uint log2_q3(uint32_t v)
+{
+    if (v == 0) return 0;
+    uint msb = 31 - __builtin_clz(v);
+    uint frac = msb >= 3 ? (v >> (msb - 3)) & 7 : (v << (3 - msb)) & 7;
+    return msb * 8 + frac;
+}
+
+static uint8_t to_level(uint32_t energy)
+{
+    // 單一 bin 滿刻度約 2^28，扣掉雜訊底線後對應到 0 ~ 255
+    int v = (int) log2_q3(energy) - 8 * 8;
+    if (v < 0) v = 0;
+    v *= 2;
+    return v > 255 ? 255 : (uint8_t) v;
+}
+
+void audio_analysis_update(const cq15_t *spectrum, audio_features_t *out)
+{
+    uint32_t total = 0;
+
+    for (uint b = 0; b < AUDIO_NUM_BANDS; b++) {
+        uint32_t e = 0;
+        for (uint k = band_edges[b]; k < band_edges[b + 1]; k++) {
+            int32_t re = spectrum[k].re, im = spectrum[k].im;
+            uint32_t p = (uint32_t) (re * re) + (uint32_t) (im * im);
+            // 飽和相加，避免大聲時繞回
+            e = (e + p < e) ? UINT32_MAX : e + p;
+        }
+        out->band[b] = to_level(e);
+        total = (total + e < total) ? UINT32_MAX : total + e;
+    }
+    out->level = to_level(total);
+
+    // 低音 (前兩個頻帶) 能量明顯高於最近平均就算一拍
+    uint32_t bass = ((uint32_t) out->band[0] + out->band[1]) / 2;
+    uint32_t avg = beat_sum / AUDIO_BEAT_HISTORY;
+    out->beat = false;
+    if (beat_holdoff) {
+        beat_holdoff--;
+    } else if (bass > 32 && bass * 8 > avg * 10) {
+        // 門檻：平均的 1.25 倍 (對數刻度，相當於能量明顯跳升)
+        out->beat = true;
+        beat_holdoff = 8;
+    }
+
+    beat_sum -= beat_history[beat_pos];
+    beat_history[beat_pos] = bass;
+    beat_sum += bass;
+    beat_pos = (beat_pos + 1) % AUDIO_BEAT_HISTORY;
+
+    out->frame = frame_count++;
+}
@@ -0,0 +1,46 @@
+/*!
+  \brief 音訊分析：ADC 擷取、頻帶能量與節拍偵測
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  流程 (建議放在 core1 上跑)：
+
+      audio_capture_latest() -> audio_fft_load() -> audio_fft()
+          -> audio_analysis_update() -> audio_features_t
+
+  ADC 以自由執行模式 (free-running) 取樣，兩個 DMA 通道互相 chain，
+  輪流寫入同一個環狀緩衝區，完全不需要 CPU 介入。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+#include "audio_fft.h"
+
+#define AUDIO_SAMPLE_RATE   20000   //<! 取樣率 (Hz)
+#define AUDIO_RING_SAMPLES  512     //<! 環狀緩衝區樣本數 (必須是 2 的次方)
+#define AUDIO_NUM_BANDS     8       //<! 頻帶數量
+#define AUDIO_BEAT_HISTORY  32      //<! 節拍偵測的平均長度 (frame)
+
+//! 每個 frame 的分析結果
+typedef struct {
+    uint8_t band[AUDIO_NUM_BANDS];  //<! 各頻帶強度 (0 ~ 255，對數刻度)
+    uint8_t level;                  //<! 整體強度 (0 ~ 255)
+    bool beat;                      //<! 這個 frame 是否偵測到節拍
+    uint32_t frame;                 //<! frame 編號
+} audio_features_t;
+
+/*! 開始 ADC 擷取
+  \param adc_input ADC 通道 (0 = GPIO26)
+ */
+void audio_capture_init(uint adc_input);
+
+/*! 取出最新的 n 個樣本，去除直流並轉成 Q15
+  \param n 不能超過 AUDIO_RING_SAMPLES
+ */
+void audio_capture_latest(int16_t *dst, uint n);
+
+//! 重設節拍偵測的歷史資料
+void audio_analysis_reset(void);
+
+//! 以一個 FFT 結果更新分析狀態，輸出到 out
+void audio_analysis_update(const cq15_t *spectrum, audio_features_t *out);
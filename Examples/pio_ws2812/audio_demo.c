@@ -0,0 +1,191 @@
+/*!
+  \brief 音樂律動 WS2812 範例
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  core1：ADC 擷取 + FFT + 頻帶/節拍分析，每 20 ms 一個 frame
+  core0：依照最新的分析結果畫燈條
+
+  頻帶強度是「最新的狀態」，用 seq 計數讀寫；節拍與分析超時是「發生過的事」，
+  經過 event_bus 送到 core0，core0 來不及讀的 frame 也不會漏掉節拍。
+
+  麥克風模組 (例如 MAX4466) 的輸出接到 GPIO26 (ADC0)，偏壓在 VCC/2。
+ */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/pio.h"
+#include "ws2812.pio.h"
+
+#include "audio_fft.h"
+#include "audio_analysis.h"
+#include "event_bus.h"
+
+#define NUM_PIXELS      60      //<! 燈珠數量
+#define WS2812_PIN      16      //<! 連接到 WS2812 的 GPIO 腳位
+#define AUDIO_ADC_INPUT 0       //<! ADC0 = GPIO26
+#define AUDIO_FRAME_US  20000   //<! 分析週期 (50 fps)
+#define REPORT_MS       10000   //<! 多久印一次 event bus 的統計
+
+//! event bus 的主題
+enum {
+    EV_BEAT,            //<! arg0 = frame 編號，arg1 = 最低頻帶的強度
+    EV_OVERRUN,         //<! 分析超過 AUDIO_FRAME_US，arg0 = 花了多少 us
+    EV_COUNT
+};
+
+static const char *const event_names[EV_COUNT] = {"beat", "overrun"};
+
+// -----------------------------------------------------------------------------
+// core1：音訊分析
+// -----------------------------------------------------------------------------
+
+//! 給 core0 讀的最新結果，seq 為奇數表示正在寫入
+static volatile uint32_t features_seq;
+static audio_features_t features_shared;
+
+static void core1_entry(void)
+{
+    static int16_t samples[AUDIO_FFT_SIZE];
+    static cq15_t spectrum[AUDIO_FFT_SIZE];
+    audio_features_t f;
+
+    audio_fft_init();
+    audio_analysis_reset();
+    audio_capture_init(AUDIO_ADC_INPUT);
+
+    absolute_time_t next = make_timeout_time_us(AUDIO_FRAME_US);
+    uint32_t worst_us = 0;
+
+    while (true) {
+        sleep_until(next);
+        next = delayed_by_us(next, AUDIO_FRAME_US);
+
+        uint64_t t0 = time_us_64();
+        audio_capture_latest(samples, AUDIO_FFT_SIZE);
+        audio_fft_load(spectrum, samples);
+        audio_fft(spectrum);
+        audio_analysis_update(spectrum, &f);
+        uint32_t us = (uint32_t) (time_us_64() - t0);
+        if (us > worst_us) worst_us = us;
+        if (f.beat) event_publish(EV_BEAT, f.frame, f.band[0]);
+        if (us > AUDIO_FRAME_US) event_publish(EV_OVERRUN, us, f.frame);
+
+        features_seq++;
+        __dmb();
+        features_shared = f;
+        __dmb();
+        features_seq++;
+
+        if ((f.frame % 250) == 0) {
+            printf("audio frame %u: %u us (worst %u us)\n", (uint) f.frame, (uint) us, (uint) worst_us);
+        }
+    }
+}
+
+static bool read_features(audio_features_t *f)
+{
+    uint32_t seq = features_seq;
+    if (seq & 1u) return false;
+    __dmb();
+    *f = features_shared;
+    __dmb();
+    return seq == features_seq;
+}
+
+// -----------------------------------------------------------------------------
+// core0：燈效
+// -----------------------------------------------------------------------------
+
+static inline void put_pixel(PIO pio, uint sm, uint32_t pixel_grb)
+{
+    pio_sm_put_blocking(pio, sm, pixel_grb << 8u);
+}
+
+static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b)
+{
+    return
+            ((uint32_t) (r) << 8) |
+            ((uint32_t) (g) << 16) |
+            (uint32_t) (b);
+}
+
+//! 每個頻帶的顏色 (低音紅 -> 高音藍)
+static const uint8_t band_rgb[AUDIO_NUM_BANDS][3] = {
+    {255, 0, 0}, {255, 80, 0}, {255, 200, 0}, {80, 255, 0},
+    {0, 255, 120}, {0, 160, 255}, {0, 40, 255}, {120, 0, 255},
+};
+
+/*! 頻譜燈效：燈條平均分給各頻帶，亮度跟著頻帶強度，節拍時整條閃白
+  \param flash 節拍閃光強度 (0 ~ 255)，由呼叫端衰減
+ */
+void pattern_spectrum(PIO pio, uint sm, uint len, const audio_features_t *f, uint flash)
+{
+    for (uint i = 0; i < len; ++i) {
+        uint b = i * AUDIO_NUM_BANDS / len;
+        uint level = f->band[b] / 4;   // let's not draw too much current!
+        uint r = band_rgb[b][0] * level / 255 + flash;
+        uint g = band_rgb[b][1] * level / 255 + flash;
+        uint bl = band_rgb[b][2] * level / 255 + flash;
+        put_pixel(pio, sm, urgb_u32(MIN(r, 255), MIN(g, 255), MIN(bl, 255)));
+    }
+}
+
+static uint flash;
+
+static void on_event(const event_t *ev, void *ctx)
+{
+    switch (ev->topic) {
+        case EV_BEAT:
+            flash = 64;
+            break;
+        case EV_OVERRUN:
+            printf("audio frame %u: analysis took %u us\n", (uint) ev->arg[1], (uint) ev->arg[0]);
+            break;
+    }
+}
+
+int main()
+{
+    stdio_init_all();
+
+    printf("WS2812 audio reactive, using pin %d\n", WS2812_PIN);
+
+    PIO pio;
+    uint sm;
+    uint offset;
+    bool success = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_program, &pio, &sm, &offset, WS2812_PIN, 1, true);
+    hard_assert(success);
+    ws2812_program_init(pio, sm, offset, WS2812_PIN, 800000, false);
+
+    static event_queue_t ui_events;
+    event_bus_init(event_names, EV_COUNT);
+    event_queue_init(&ui_events, "ui", EVENT_MASK(EV_BEAT) | EVENT_MASK(EV_OVERRUN), on_event, NULL);
+
+    multicore_launch_core1(core1_entry);
+    // FIFO 用完 (core1 已經啟動) 才能當門鈴
+    event_bus_doorbell_init();
+
+    audio_features_t f = {0};
+    uint32_t last_frame = 0;
+    absolute_time_t next_report = make_timeout_time_ms(REPORT_MS);
+
+    while (true) {
+        audio_features_t n;
+        if (read_features(&n) && n.frame != last_frame) {
+            f = n;
+            last_frame = n.frame;
+        }
+        event_queue_drain(&ui_events, 0);
+
+        pattern_spectrum(pio, sm, NUM_PIXELS, &f, flash);
+        flash = flash > 4 ? flash - 4 : 0;
+        if (time_reached(next_report)) {
+            next_report = make_timeout_time_ms(REPORT_MS);
+            event_bus_report();
+            event_bus_reset_stats();
+        }
+        sleep_ms(10);
+    }
+}
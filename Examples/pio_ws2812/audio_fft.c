@@ -0,0 +1,107 @@
+/*!
+  \brief 定點 (Q15) FFT
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <math.h>
+
+#include "audio_fft.h"
+
+#if AUDIO_FFT_LOG2 < 2 || AUDIO_FFT_LOG2 > 12
+#error AUDIO_FFT_LOG2 must be between 2 and 12
+#endif
+
+static int16_t tw_cos[AUDIO_FFT_SIZE / 2];  //<! cos(2*pi*k/N) Q15
+static int16_t tw_sin[AUDIO_FFT_SIZE / 2];  //<! sin(2*pi*k/N) Q15
+static int16_t window[AUDIO_FFT_SIZE];      //<! Hann 視窗 Q15
+static uint16_t bitrev[AUDIO_FFT_SIZE];     //<! bit reversal 索引
+
+static int16_t to_q15(double v)
+{
+    long q = lround(v * 32767.0);
+    if (q > 32767) q = 32767;
+    if (q < -32768) q = -32768;
+    return (int16_t) q;
+}
+
+void audio_fft_init(void)
+{
+    const double pi = 3.14159265358979323846;
+
+    for (uint32_t k = 0; k < AUDIO_FFT_SIZE / 2; k++) {
+        tw_cos[k] = to_q15(cos(2.0 * pi * k / AUDIO_FFT_SIZE));
+        tw_sin[k] = to_q15(sin(2.0 * pi * k / AUDIO_FFT_SIZE));
+    }
+    for (uint32_t i = 0; i < AUDIO_FFT_SIZE; i++) {
+        window[i] = to_q15(0.5 - 0.5 * cos(2.0 * pi * i / AUDIO_FFT_SIZE));
+
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < AUDIO_FFT_LOG2; b++) {
+            if (i & (1u << b)) r |= 1u << (AUDIO_FFT_LOG2 - 1 - b);
+        }
+        bitrev[i] = (uint16_t) r;
+    }
+}
+
+void audio_fft_load(cq15_t *x, const int16_t *samples)
+{
+    for (uint32_t i = 0; i < AUDIO_FFT_SIZE; i++) {
+        cq15_t *d = &x[bitrev[i]];
+        d->re = (int16_t) (((int32_t) samples[i] * window[i]) >> 15);
+        d->im = 0;
+    }
+}
+
+void audio_fft(cq15_t *x)
+{
+    // 第 1、2 級合併成 radix-4：旋轉因子只有 1 與 -j，整體除以 4
+    for (uint32_t i = 0; i < AUDIO_FFT_SIZE; i += 4) {
+        int32_t ar = x[i].re,     ai = x[i].im;
+        int32_t br = x[i + 1].re, bi = x[i + 1].im;
+        int32_t cr = x[i + 2].re, ci = x[i + 2].im;
+        int32_t dr = x[i + 3].re, di = x[i + 3].im;
+
+        int32_t t0r = ar + br, t0i = ai + bi;
+        int32_t t1r = ar - br, t1i = ai - bi;
+        int32_t t2r = cr + dr, t2i = ci + di;
+        int32_t t3r = cr - dr, t3i = ci - di;
+
+        // (-j) * t3 = (t3i, -t3r)
+        x[i].re     = (int16_t) ((t0r + t2r) >> 2);
+        x[i].im     = (int16_t) ((t0i + t2i) >> 2);
+        x[i + 1].re = (int16_t) ((t1r + t3i) >> 2);
+        x[i + 1].im = (int16_t) ((t1i - t3r) >> 2);
+        x[i + 2].re = (int16_t) ((t0r - t2r) >> 2);
+        x[i + 2].im = (int16_t) ((t0i - t2i) >> 2);
+        x[i + 3].re = (int16_t) ((t1r - t3i) >> 2);
+        x[i + 3].im = (int16_t) ((t1i + t3r) >> 2);
+    }
+
+    // 其餘各級 radix-2，W = cos - j*sin
+    for (uint32_t span = 4; span < AUDIO_FFT_SIZE; span <<= 1) {
+        uint32_t step = AUDIO_FFT_SIZE / (2 * span);
+        for (uint32_t k = 0; k < span; k++) {
+            int32_t wr = tw_cos[k * step];
+            int32_t wi = tw_sin[k * step];
+            for (uint32_t i = k; i < AUDIO_FFT_SIZE; i += 2 * span) {
+                cq15_t *a = &x[i];
+                cq15_t *b = &x[i + span];
+                int32_t tr = (wr * b->re + wi * b->im + (1 << 14)) >> 15;
+                int32_t ti = (wr * b->im - wi * b->re + (1 << 14)) >> 15;
+                int32_t ar = a->re, ai = a->im;
+                a->re = (int16_t) ((ar + tr) >> 1);
+                a->im = (int16_t) ((ai + ti) >> 1);
+                b->re = (int16_t) ((ar - tr) >> 1);
+                b->im = (int16_t) ((ai - ti) >> 1);
+            }
+        }
+    }
+}
+
+void audio_fft_power(const cq15_t *x, uint32_t *power)
+{
+    for (uint32_t k = 0; k < AUDIO_FFT_BINS; k++) {
+        int32_t re = x[k].re, im = x[k].im;
+        power[k] = (uint32_t) (re * re) + (uint32_t) (im * im);
+    }
+}
@@ -0,0 +1,37 @@
+/*!
+  \brief 定點 (Q15) FFT，給音樂律動燈效用
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  - 不依賴 Pico SDK，可以直接在電腦上編譯做比對與效能測試 (見 Examples/host)
+  - 載入資料時順便乘上 Hann 視窗並做 bit reversal，FFT 本體不再搬資料
+  - 前兩級合併成 radix-4 (旋轉因子只有 ±1, ±j，不用乘法)，其餘是 radix-2
+  - 每一級都除以 2 避免溢位，所以輸出 = DFT / N
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define AUDIO_FFT_LOG2  8                       //<! FFT 點數 (log2)
+#define AUDIO_FFT_SIZE  (1u << AUDIO_FFT_LOG2)  //<! FFT 點數
+#define AUDIO_FFT_BINS  (AUDIO_FFT_SIZE / 2)    //<! 實數輸入的有效頻譜數
+
+//! Q15 複數
+typedef struct {
+    int16_t re;
+    int16_t im;
+} cq15_t;
+
+//! 建立旋轉因子、視窗與 bit reversal 表，只需要呼叫一次
+void audio_fft_init(void);
+
+/*! 載入 AUDIO_FFT_SIZE 個 Q15 實數樣本
+  \note 會乘上 Hann 視窗並依 bit reversal 順序寫入 x
+ */
+void audio_fft_load(cq15_t *x, const int16_t *samples);
+
+//! 原地 FFT，x 必須是 audio_fft_load() 的結果
+void audio_fft(cq15_t *x);
+
+//! 前 AUDIO_FFT_BINS 個 bin 的功率 (re^2 + im^2)
+void audio_fft_power(const cq15_t *x, uint32_t *power);
@@ -0,0 +1,106 @@
+/*!
+  \brief LED 矩陣 blitter 範例：DMA 背景複製 + 捲動文字 + alpha 方塊
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "ws2812.pio.h"
+
+#include "led_blit.h"
+
+#define WS2812_PIN      16  //<! 連接到 WS2812 矩陣的 GPIO 腳位
+#define MATRIX_WIDTH    16  //<! 矩陣寬度
+#define MATRIX_HEIGHT   16  //<! 矩陣高度
+
+#define NUM_PIXELS (MATRIX_WIDTH * MATRIX_HEIGHT)
+
+static uint32_t frame[NUM_PIXELS];          //<! 輸出用的畫面
+static uint32_t background[NUM_PIXELS];     //<! 背景圖，每個畫面用 DMA 還原
+static uint32_t box[4 * 4];                 //<! 半透明方塊
+static uint32_t heart[5 * 5];               //<! 透明色 (0) 的圖塊
+
+static const char heart_bits[5][6] = {
+    ".#.#.",
+    "#####",
+    "#####",
+    ".###.",
+    "..#..",
+};
+
+static void make_sprites(void)
+{
+    for (uint y = 0; y < MATRIX_HEIGHT; y++) {
+        for (uint x = 0; x < MATRIX_WIDTH; x++) {
+            background[y * MATRIX_WIDTH + x] = led_rgb(x * 2, 0, y * 2);
+        }
+    }
+    for (uint i = 0; i < count_of(box); i++) {
+        box[i] = led_rgb(0, 0x40, 0);
+    }
+    for (uint y = 0; y < 5; y++) {
+        for (uint x = 0; x < 5; x++) {
+            heart[y * 5 + x] = heart_bits[y][x] == '#' ? led_rgb(0x60, 0, 0x10) : 0;
+        }
+    }
+}
+
+int main()
+{
+    stdio_init_all();
+    sleep_ms(2000);
+
+    blit_init();
+    blit_benchmark();
+
+    PIO pio;
+    uint sm;
+    uint offset;
+    bool success = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_program, &pio, &sm, &offset, WS2812_PIN, 1, true);
+    hard_assert(success);
+    ws2812_program_init(pio, sm, offset, WS2812_PIN, 800000, false);
+
+    // 畫面本身就是線上格式，整張用 DMA 送進 PIO
+    int out_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(out_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(out_chan, &c, &pio->txf[sm], frame, NUM_PIXELS, false);
+
+    make_sprites();
+
+    led_fb_t fb = {frame, MATRIX_WIDTH, MATRIX_HEIGHT, MATRIX_WIDTH};
+    led_sprite_t bg = {background, MATRIX_WIDTH, MATRIX_HEIGHT, MATRIX_WIDTH};
+    led_sprite_t box_spr = {box, 4, 4, 4};
+    led_sprite_t heart_spr = {heart, 5, 5, 5};
+
+    const char *text = "HELLO PICO!";
+    int text_width = 11 * BLIT_FONT_ADVANCE;
+    int scroll = MATRIX_WIDTH;
+    uint t = 0;
+
+    while (true) {
+        // 上一個畫面送完才能改
+        dma_channel_wait_for_finish_blocking(out_chan);
+
+        // DMA 還原背景，這段時間 CPU 先算下一步的位置
+        blit_copy_async(&fb, 0, 0, &bg);
+        int box_x = (t / 4) % (MATRIX_WIDTH + 4) - 4;
+        int heart_y = MATRIX_HEIGHT - 5 - (int) ((t / 8) % 4);
+        if (--scroll < -text_width) scroll = MATRIX_WIDTH;
+        blit_wait();
+
+        blit_text(&fb, scroll, 1, text, led_rgb(0x30, 0x30, 0x30), 0, true);
+        blit_keyed(&fb, MATRIX_WIDTH - 6, heart_y, &heart_spr, 0);
+        blit_alpha(&fb, box_x, 10, &box_spr, 128);
+
+        dma_channel_set_read_addr(out_chan, frame, true);
+        sleep_ms(30);
+        t++;
+    }
+}
@@ -0,0 +1,276 @@
+/*!
+  \brief 燈效用的定點數學
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include "fixmath.h"
+
+#define SIN_TABLE_BITS  8                       //<! 四分之一週期分成 256 格
+#define SIN_FRAC_BITS   (14 - SIN_TABLE_BITS)   //<! 每格之間內插用的位元
+
+//! round(sin(i / 256 * pi / 2) * 65535)，多一格給內插用
+static const uint16_t sin_quarter[(1u << SIN_TABLE_BITS) + 1] = {
+            0,   402,   804,  1206,  1608,  2010,  2412,  2814,  3216,  3617,  4019,  4420,
+         4821,  5222,  5623,  6023,  6424,  6824,  7223,  7623,  8022,  8421,  8820,  9218,
+         9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391, 12785, 13179, 13573, 13966,
+        14359, 14751, 15142, 15533, 15924, 16313, 16703, 17091, 17479, 17866, 18253, 18639,
+        19024, 19408, 19792, 20175, 20557, 20939, 21319, 21699, 22078, 22456, 22834, 23210,
+        23586, 23960, 24334, 24707, 25079, 25450, 25820, 26189, 26557, 26925, 27291, 27656,
+        28020, 28383, 28745, 29106, 29465, 29824, 30181, 30538, 30893, 31247, 31600, 31952,
+        32302, 32651, 32999, 33346, 33692, 34036, 34379, 34721, 35061, 35400, 35738, 36074,
+        36409, 36743, 37075, 37406, 37736, 38064, 38390, 38715, 39039, 39361, 39682, 40001,
+        40319, 40635, 40950, 41263, 41575, 41885, 42194, 42500, 42806, 43109, 43411, 43712,
+        44011, 44308, 44603, 44897, 45189, 45479, 45768, 46055, 46340, 46624, 46905, 47185,
+        47464, 47740, 48014, 48287, 48558, 48827, 49095, 49360, 49624, 49885, 50145, 50403,
+        50659, 50913, 51166, 51416, 51664, 51911, 52155, 52398, 52638, 52877, 53113, 53348,
+        53580, 53811, 54039, 54266, 54490, 54713, 54933, 55151, 55367, 55582, 55794, 56003,
+        56211, 56417, 56620, 56822, 57021, 57218, 57413, 57606, 57797, 57985, 58171, 58356,
+        58537, 58717, 58895, 59070, 59243, 59414, 59582, 59749, 59913, 60075, 60234, 60391,
+        60546, 60699, 60850, 60998, 61144, 61287, 61429, 61567, 61704, 61838, 61970, 62100,
+        62227, 62352, 62475, 62595, 62713, 62829, 62942, 63053, 63161, 63267, 63371, 63472,
+        63571, 63668, 63762, 63853, 63943, 64030, 64114, 64196, 64276, 64353, 64428, 64500,
+        64570, 64638, 64703, 64765, 64826, 64883, 64939, 64992, 65042, 65090, 65136, 65179,
+        65219, 65258, 65293, 65327, 65357, 65386, 65412, 65435, 65456, 65475, 65491, 65504,
+        65515, 65524, 65530, 65534, 65535,
+};
+
+fx16_t __not_in_flash_func(fx_sin)(uint16_t angle)
+{
+    uint x = angle & 0x3fff;
+    // 第 2、4 象限把角度鏡射回第 1 象限 (x 可能是 0x4000，所以表多一格)
+    if (angle & 0x4000) x = 0x4000 - x;
+    uint i = x >> SIN_FRAC_BITS;
+    uint f = x & ((1u << SIN_FRAC_BITS) - 1);
+    int32_t s = sin_quarter[i] << SIN_FRAC_BITS;
+    if (f) s += (sin_quarter[i + 1] - sin_quarter[i]) * (int32_t) f;
+    // 65535 放大成 65536 (sin(90°) 剛好是 FX16_ONE)，再四捨五入
+    s = (s + (s >> 16) + (1 << (SIN_FRAC_BITS - 1))) >> SIN_FRAC_BITS;
+    return (angle & 0x8000) ? -s : s;
+}
+
+// ----------------------------------------------------------------------------
+// 緩動曲線
+
+static inline fx16_t cube(fx16_t t)
+{
+    return fx_mul(fx_mul(t, t), t);
+}
+
+//! 3t^2 - 2t^3，t 在 0 ~ FX16_ONE；中間值用 64 位元，避免連續截斷讓曲線不單調
+static inline fx16_t smoothstep(fx16_t t)
+{
+    int64_t t2 = (int64_t) t * t;                       // Q32
+    return (fx16_t) ((t2 * (3 * FX16_ONE - 2 * t) + (1ll << 31)) >> 32);
+}
+
+//! 6t^5 - 15t^4 + 10t^3，t 在 0 ~ FX16_ONE
+static inline fx16_t fade(fx16_t t)
+{
+    int64_t t3 = ((int64_t) t * t * t) >> 24;           // Q24
+    int64_t k = (int64_t) t * (6 * t - 15 * FX16_ONE) + (10ll << 32);
+    return (fx16_t) ((t3 * (k >> 8) + (1ll << 31)) >> 32);
+}
+
+fx16_t fx_ease(fx_ease_t kind, fx16_t t)
+{
+    if (t <= 0) return 0;
+    if (t >= FX16_ONE) return FX16_ONE;
+    fx16_t r = FX16_ONE - t;
+    bool first_half = t < FX16_ONE / 2;
+    switch (kind) {
+    case FX_EASE_IN_QUAD:       return fx_mul(t, t);
+    case FX_EASE_OUT_QUAD:      return FX16_ONE - fx_mul(r, r);
+    case FX_EASE_IN_OUT_QUAD:   return first_half ? 2 * fx_mul(t, t) : FX16_ONE - 2 * fx_mul(r, r);
+    case FX_EASE_IN_CUBIC:      return cube(t);
+    case FX_EASE_OUT_CUBIC:     return FX16_ONE - cube(r);
+    case FX_EASE_IN_OUT_CUBIC:  return first_half ? 4 * cube(t) : FX16_ONE - 4 * cube(r);
+    // t = FX16_ONE 對應 90° (角度 16384)
+    case FX_EASE_IN_SINE:       return FX16_ONE - fx_cos((uint16_t) ((t + 2) >> 2));
+    case FX_EASE_OUT_SINE:      return fx_sin((uint16_t) ((t + 2) >> 2));
+    case FX_EASE_IN_OUT_SINE:   return (FX16_ONE - fx_cos((uint16_t) ((t + 1) >> 1))) >> 1;
+    case FX_EASE_SMOOTHSTEP:    return smoothstep(t);
+    case FX_EASE_SMOOTHERSTEP:  return fade(t);
+    default:                    return t;
+    }
+}
+
+const char *fx_ease_name(fx_ease_t kind)
+{
+    static const char *const names[FX_EASE_COUNT] = {
+        "linear",
+        "in_quad", "out_quad", "in_out_quad",
+        "in_cubic", "out_cubic", "in_out_cubic",
+        "in_sine", "out_sine", "in_out_sine",
+        "smoothstep", "smootherstep",
+    };
+    return (uint) kind < FX_EASE_COUNT ? names[kind] : "?";
+}
+
+// ----------------------------------------------------------------------------
+// noise
+//
+// 固定 y、z 時，一格裡面每個格點的貢獻是 x 的一次式 (梯度的 x 分量 * x + 其他分量的內積)，
+// 所以先把 y、z 方向的內插做完，只留下左右兩個格點的一次式 (noise_cell_t)，
+// 每個像素只剩 x 方向的 fade 與一次內插；fx_noise*() 也走同一條路，結果跟 span 版本完全一樣
+
+//! Ken Perlin 的排列表
+static const uint8_t perm[256] = {
+        151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225,
+        140,  36, 103,  30,  69, 142,   8,  99,  37, 240,  21,  10,  23, 190,   6, 148,
+        247, 120, 234,  75,   0,  26, 197,  62,  94, 252, 219, 203, 117,  35,  11,  32,
+         57, 177,  33,  88, 237, 149,  56,  87, 174,  20, 125, 136, 171, 168,  68, 175,
+         74, 165,  71, 134, 139,  48,  27, 166,  77, 146, 158, 231,  83, 111, 229, 122,
+         60, 211, 133, 230, 220, 105,  92,  41,  55,  46, 245,  40, 244, 102, 143,  54,
+         65,  25,  63, 161,   1, 216,  80,  73, 209,  76, 132, 187, 208,  89,  18, 169,
+        200, 196, 135, 130, 116, 188, 159,  86, 164, 100, 109, 198, 173, 186,   3,  64,
+         52, 217, 226, 250, 124, 123,   5, 202,  38, 147, 118, 126, 255,  82,  85, 212,
+        207, 206,  59, 227,  47,  16,  58,  17, 182, 189,  28,  42, 223, 183, 170, 213,
+        119, 248, 152,   2,  44, 154, 163,  70, 221, 153, 101, 155, 167,  43, 172,   9,
+        129,  22,  39, 253,  19,  98, 108, 110,  79, 113, 224, 232, 178, 185, 112, 104,
+        218, 246,  97, 228, 251,  34, 242, 193, 238, 210, 144,  12, 191, 179, 162, 241,
+         81,  51, 145, 235, 249,  14, 239, 107,  49, 192, 214,  31, 181, 199, 106, 157,
+        184,  84, 204, 176, 115, 121,  50,  45, 127,   4, 150, 254, 138, 236, 205,  93,
+        222, 114,  67,  29,  24,  72, 243, 141, 128, 195,  78,  66, 215,  61, 156, 180,
+};
+
+#define P(i)    perm[(i) & 0xff]
+
+//! improved noise 的 12 個邊的方向 (補到 16 個)
+static const int8_t grad3[16][3] = {
+    { 1,  1,  0}, {-1,  1,  0}, { 1, -1,  0}, {-1, -1,  0},
+    { 1,  0,  1}, {-1,  0,  1}, { 1,  0, -1}, {-1,  0, -1},
+    { 0,  1,  1}, { 0, -1,  1}, { 0,  1, -1}, { 0, -1, -1},
+    { 1,  1,  0}, { 0, -1,  1}, {-1,  1,  0}, { 0, -1, -1},
+};
+
+typedef struct {
+    fx16_t g0, c0;          //<! 左邊格點：g0 * xf + c0
+    fx16_t g1, c1;          //<! 右邊格點：g1 * (xf - 1) + c1
+} noise_cell_t;
+
+static inline fx16_t noise_eval(const noise_cell_t *c, fx16_t xf)
+{
+    fx16_t a = fx_mul(c->g0, xf) + c->c0;
+    fx16_t b = fx_mul(c->g1, xf - FX16_ONE) + c->c1;
+    fx16_t n = a + fx_mul(b - a, fade(xf));
+    return n > FX16_ONE ? FX16_ONE : n < -FX16_ONE ? -FX16_ONE : n;
+}
+
+//! 1D 梯度 ±1 ~ ±8，除以 4 讓輸出大約在 -1 ~ 1
+static inline fx16_t grad1(uint h)
+{
+    fx16_t g = (fx16_t) ((h & 7) + 1) << 14;
+    return h & 8 ? -g : g;
+}
+
+static void noise_cell1(noise_cell_t *c, uint x)
+{
+    c->g0 = grad1(P(x));
+    c->g1 = grad1(P(x + 1));
+    c->c0 = c->c1 = 0;
+}
+
+//! 2D 用四個對角方向 (±1, ±1)
+static void noise_cell2(noise_cell_t *c, uint x, uint32_t y)
+{
+    uint yi = y >> 16;
+    fx16_t yf = y & 0xffff;
+    fx16_t v = fade(yf);
+    for (uint i = 0; i < 2; i++) {
+        uint h0 = P(P(x + i) + yi);
+        uint h1 = P(P(x + i) + yi + 1);
+        fx16_t g = fx_lerp(h0 & 1 ? -FX16_ONE : FX16_ONE, h1 & 1 ? -FX16_ONE : FX16_ONE, v);
+        fx16_t k = fx_lerp(h0 & 2 ? -yf : yf, h1 & 2 ? FX16_ONE - yf : yf - FX16_ONE, v);
+        if (i) {
+            c->g1 = g;
+            c->c1 = k;
+        } else {
+            c->g0 = g;
+            c->c0 = k;
+        }
+    }
+}
+
+static void noise_cell3(noise_cell_t *c, uint x, uint32_t y, uint32_t z)
+{
+    uint yi = y >> 16, zi = z >> 16;
+    fx16_t yf = y & 0xffff, zf = z & 0xffff;
+    fx16_t v = fade(yf), w = fade(zf);
+    for (uint i = 0; i < 2; i++) {
+        fx16_t g[2], k[2];
+        for (uint kz = 0; kz < 2; kz++) {
+            fx16_t zr = kz ? zf - FX16_ONE : zf;
+            fx16_t gy[2], ky[2];
+            for (uint jy = 0; jy < 2; jy++) {
+                const int8_t *d = grad3[P(P(P(x + i) + yi + jy) + zi + kz) & 15];
+                fx16_t yr = jy ? yf - FX16_ONE : yf;
+                gy[jy] = d[0] * FX16_ONE;
+                ky[jy] = d[1] * yr + d[2] * zr;
+            }
+            g[kz] = fx_lerp(gy[0], gy[1], v);
+            k[kz] = fx_lerp(ky[0], ky[1], v);
+        }
+        if (i) {
+            c->g1 = fx_lerp(g[0], g[1], w);
+            c->c1 = fx_lerp(k[0], k[1], w);
+        } else {
+            c->g0 = fx_lerp(g[0], g[1], w);
+            c->c0 = fx_lerp(k[0], k[1], w);
+        }
+    }
+}
+
+fx16_t fx_noise1(uint32_t x)
+{
+    noise_cell_t c;
+    noise_cell1(&c, x >> 16);
+    return noise_eval(&c, x & 0xffff);
+}
+
+fx16_t fx_noise2(uint32_t x, uint32_t y)
+{
+    noise_cell_t c;
+    noise_cell2(&c, x >> 16, y);
+    return noise_eval(&c, x & 0xffff);
+}
+
+fx16_t fx_noise3(uint32_t x, uint32_t y, uint32_t z)
+{
+    noise_cell_t c;
+    noise_cell3(&c, x >> 16, y, z);
+    return noise_eval(&c, x & 0xffff);
+}
+
+// 跨到下一格才重算格點
+void __not_in_flash_func(fx_noise1_span)(fx16_t *out, uint n, uint32_t x, uint32_t dx)
+{
+    noise_cell_t c;
+    uint cell = x >> 16;
+    noise_cell1(&c, cell);
+    for (uint i = 0; i < n; i++, x += dx) {
+        if ((x >> 16) != cell) noise_cell1(&c, cell = x >> 16);
+        out[i] = noise_eval(&c, x & 0xffff);
+    }
+}
+
+void __not_in_flash_func(fx_noise2_span)(fx16_t *out, uint n, uint32_t x, uint32_t dx, uint32_t y)
+{
+    noise_cell_t c;
+    uint cell = x >> 16;
+    noise_cell2(&c, cell, y);
+    for (uint i = 0; i < n; i++, x += dx) {
+        if ((x >> 16) != cell) noise_cell2(&c, cell = x >> 16, y);
+        out[i] = noise_eval(&c, x & 0xffff);
+    }
+}
+
+void __not_in_flash_func(fx_noise3_span)(fx16_t *out, uint n, uint32_t x, uint32_t dx, uint32_t y, uint32_t z)
+{
+    noise_cell_t c;
+    uint cell = x >> 16;
+    noise_cell3(&c, cell, y, z);
+    for (uint i = 0; i < n; i++, x += dx) {
+        if ((x >> 16) != cell) noise_cell3(&c, cell = x >> 16, y, z);
+        out[i] = noise_eval(&c, x & 0xffff);
+    }
+}
@@ -0,0 +1,104 @@
+/*!
+  \brief 燈效用的定點數學：sin / cos 查表、Q16 緩動曲線、整數 Perlin noise
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  每個像素呼叫 sinf / powf 會吃掉整個 frame 的預算 (RP2040 沒有 FPU，M33 的 libm 也不快)，
+  這裡全部用整數：
+
+  - 角度：uint16_t，65536 = 一圈 (溢位剛好繞回來)
+  - 數值：fx16_t (Q16.16)，FX16_ONE = 1.0
+  - fx_sin / fx_cos：四分之一週期 256 格的表 + 線性內插，誤差約 1 / 65536
+  - fx_ease()：t 在 0 ~ FX16_ONE，回傳 0 ~ FX16_ONE 的緩動曲線
+  - fx_noise1 / 2 / 3：improved Perlin noise，座標是 Q16.16 (整數部分是格點)，回傳約 -1 ~ 1；
+    fx_noise*_span() 一次算一整排像素，同一格內的雜湊與梯度只算一次
+
+  精度與速度跟 libm 的比較：host/fixmath_bench
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+typedef int32_t fx16_t;
+
+#define FX16_ONE            65536
+#define FX16(x)             ((fx16_t) ((x) * 65536.0 + ((x) < 0 ? -0.5 : 0.5)))   //<! 常數轉換
+#define FX_ANGLE_QUARTER    16384u
+
+//! Q16.16 乘法
+static inline fx16_t fx_mul(fx16_t a, fx16_t b)
+{
+    return (fx16_t) (((int64_t) a * b) >> 16);
+}
+
+//! a + (b - a) * t，t 在 0 ~ FX16_ONE
+static inline fx16_t fx_lerp(fx16_t a, fx16_t b, fx16_t t)
+{
+    return a + fx_mul(b - a, t);
+}
+
+//! sin，回傳 -FX16_ONE ~ FX16_ONE
+fx16_t fx_sin(uint16_t angle);
+
+static inline fx16_t fx_cos(uint16_t angle)
+{
+    return fx_sin((uint16_t) (angle + FX_ANGLE_QUARTER));
+}
+
+//! 0 ~ 255 的正弦波 (sin 的 -1 ~ 1 對應到 0 ~ 255)，給亮度用
+static inline uint8_t fx_wave8(uint16_t angle)
+{
+    return (uint8_t) (((fx_sin(angle) + FX16_ONE) * 255 + FX16_ONE) / (2 * FX16_ONE));
+}
+
+// ----------------------------------------------------------------------------
+// 緩動曲線
+
+typedef enum {
+    FX_EASE_LINEAR,
+    FX_EASE_IN_QUAD,
+    FX_EASE_OUT_QUAD,
+    FX_EASE_IN_OUT_QUAD,
+    FX_EASE_IN_CUBIC,
+    FX_EASE_OUT_CUBIC,
+    FX_EASE_IN_OUT_CUBIC,
+    FX_EASE_IN_SINE,
+    FX_EASE_OUT_SINE,
+    FX_EASE_IN_OUT_SINE,
+    FX_EASE_SMOOTHSTEP,     //<! 3t^2 - 2t^3
+    FX_EASE_SMOOTHERSTEP,   //<! 6t^5 - 15t^4 + 10t^3 (noise 的 fade 也是這個)
+    FX_EASE_COUNT
+} fx_ease_t;
+
+/*! 緩動曲線
+  \param t 0 ~ FX16_ONE，超出範圍會先限制在範圍內
+ */
+fx16_t fx_ease(fx_ease_t kind, fx16_t t);
+
+const char *fx_ease_name(fx_ease_t kind);
+
+// ----------------------------------------------------------------------------
+// noise
+
+//! 1D noise，x 是 Q16.16
+fx16_t fx_noise1(uint32_t x);
+
+fx16_t fx_noise2(uint32_t x, uint32_t y);
+
+fx16_t fx_noise3(uint32_t x, uint32_t y, uint32_t z);
+
+//! out[i] = fx_noise1(x + i * dx)
+void fx_noise1_span(fx16_t *out, uint n, uint32_t x, uint32_t dx);
+
+//! out[i] = fx_noise2(x + i * dx, y)
+void fx_noise2_span(fx16_t *out, uint n, uint32_t x, uint32_t dx, uint32_t y);
+
+//! out[i] = fx_noise3(x + i * dx, y, z)
+void fx_noise3_span(fx16_t *out, uint n, uint32_t x, uint32_t dx, uint32_t y, uint32_t z);
+
+//! noise 的 -1 ~ 1 對應到 0 ~ 255
+static inline uint8_t fx_noise_u8(fx16_t n)
+{
+    int32_t v = (n + FX16_ONE) * 255 / (2 * FX16_ONE);
+    return (uint8_t) (v < 0 ? 0 : v > 255 ? 255 : v);
+}
@@ -0,0 +1,102 @@
+/*!
+  \brief 像素運算核心在板子上的比對與效能測試
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  先跟逐 byte 參考實作比對 (M33 上比對的就是 DSP 指令版本)，
+  再量測每個核心處理一個像素 (4 bytes) 要幾個 CPU 週期。
+  後半段量測 ws2812_parallel 每個 frame 的 bit plane 運算 (轉置 + dither)。
+  同一份程式分別用 Arm (預設) 和 RISC-V (-DPICO_PLATFORM=rp2350-riscv) 編譯，
+  就能直接比較兩種核心的結果。
+ */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+
+#include "pixel_kernels.h"
+#include "pixel_kernels_ref.h"
+#include "ws2812_planes.h"
+
+#define WORDS 1024      //<! 一次處理 1024 個像素
+#define LOOPS 200
+#define FRAME_VALUES (64 * 4)   //<! ws2812_parallel 一個 frame：64 顆 RGBW
+
+static uint32_t src[WORDS], src2[WORDS], dst[WORDS];
+static uint8_t lut[256];
+static volatile uint32_t sink;
+
+//! 換算成每個像素幾個 CPU 週期
+static void report(const char *name, uint32_t us)
+{
+    float cycles = (float) us * (clock_get_hz(clk_sys) / 1e6f) / ((float) LOOPS * WORDS);
+    printf("  %-16s %6.2f cycles/pixel\n", name, cycles);
+}
+
+#define TIME(name, ...) do { \
+        uint32_t t0_ = time_us_32(); \
+        for (int l_ = 0; l_ < LOOPS; l_++) { __VA_ARGS__; } \
+        sink = dst[0]; \
+        report(name, time_us_32() - t0_); \
+    } while (0)
+
+static value_bits_t colors[FRAME_VALUES];
+static value_bits_t states[2][FRAME_VALUES];
+
+//! 換算成每個 frame 幾個 CPU 週期
+static void report_frame(const char *name, uint32_t us, uint loops)
+{
+    uint32_t cycles = (uint32_t) ((uint64_t) us * (clock_get_hz(clk_sys) / 1000000) / loops);
+    printf("  %-16s %8u cycles/frame\n", name, (uint) cycles);
+}
+
+#define TIME_FRAME(name, ...) do { \
+        const uint loops_ = 1000; \
+        uint32_t t0_ = time_us_32(); \
+        for (uint l_ = 0; l_ < loops_; l_++) { __VA_ARGS__; } \
+        report_frame(name, time_us_32() - t0_, loops_); \
+    } while (0)
+
+int main()
+{
+    stdio_init_all();
+    sleep_ms(2000);     // 等 USB 序列埠連上
+
+    printf("Pixel kernels (%s), clk_sys %u MHz\n", PIXEL_KERNELS_DSP ? "M33 DSP" : "portable SWAR",
+           (uint) (clock_get_hz(clk_sys) / 1000000));
+
+    uint32_t errors = pk_verify(200000);
+    printf("verify: %u mismatches\n", (uint) errors);
+
+    for (uint i = 0; i < WORDS; i++) {
+        src[i] = i * 0x9e3779b9u;
+        src2[i] = i * 0x85ebca6bu;
+    }
+    pk_gamma_table(lut, 2.2f);
+
+    TIME("scale", pk_scale_buffer(dst, src, WORDS, 0x80));
+    TIME("scale (ref)", for (uint i = 0; i < WORDS; i++) dst[i] = ref_scale(src[i], 0x80));
+    TIME("add_sat", pk_add_sat_buffer(dst, src, WORDS));
+    TIME("add_sat (ref)", for (uint i = 0; i < WORDS; i++) dst[i] = ref_add_sat(dst[i], src[i]));
+    TIME("blend", pk_blend_buffer(dst, src, src2, WORDS, 0x40));
+    TIME("blend (ref)", for (uint i = 0; i < WORDS; i++) dst[i] = ref_blend(src[i], src2[i], 0x40));
+    TIME("gamma", pk_gamma_buffer(dst, src, WORDS, lut));
+    TIME("power", dst[0] = pk_power_buffer(src, WORDS, 0x00100014, 0x000c0000));
+
+    uint32_t plane_errors = planes_verify(20000);
+    printf("\nBit planes (%s), verify: %u mismatches\n", planes_arch_name(), (uint) plane_errors);
+    const uint8_t *bytes0 = (const uint8_t *) src;
+    const uint8_t *bytes1 = (const uint8_t *) src2;
+    TIME_FRAME("transpose x2", for (uint v = 0; v < FRAME_VALUES; v++) {
+        planes_from_values2(&colors[v], bytes0[v] * 5u, bytes1[v] * 3u);
+    });
+    TIME_FRAME("transpose", for (uint v = 0; v < FRAME_VALUES; v++) {
+        uint32_t values[2] = {bytes0[v] * 5u, bytes1[v] * 3u};
+        planes_from_values(&colors[v], values, 2);
+    });
+    TIME_FRAME("dither", dither_values(colors, states[l_ & 1], states[(l_ & 1) ^ 1], FRAME_VALUES));
+
+    while (1) {
+        tight_loop_contents();
+    }
+}
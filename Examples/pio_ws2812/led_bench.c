@@ -0,0 +1,89 @@
+/*!
+  \brief ws2812_parallel 每個 frame 的運算在板子上的週期數 (common/bench)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  量測的都是 ws2812_parallel 實際用的函式與資料大小 (兩條 64 顆的燈)：
+  燈效繪製、亮度 + bit plane 轉置 (transform_strips)、dither (add_error / dither_values)。
+  結果從 USB 送出，用 host/bench_diff.py 比較兩個版本：
+
+    python3 bench_diff.py before.txt after.txt
+ */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "bench.h"
+#include "pixel_kernels.h"
+#include "ws2812_patterns.h"
+
+#define ITERS 201
+
+static uint8_t strip0_data[NUM_PIXELS * 3] __attribute__((aligned(4)));
+static uint8_t strip1_data[NUM_PIXELS * 4] __attribute__((aligned(4)));
+static strip_t strip0 = {.data = strip0_data, .data_len = sizeof(strip0_data), .frac_brightness = 0x40};
+static strip_t strip1 = {.data = strip1_data, .data_len = sizeof(strip1_data), .frac_brightness = 0x100};
+static strip_t *strips[] = {&strip0, &strip1};
+
+static value_bits_t colors[NUM_PIXELS * 4];
+static value_bits_t states[2][NUM_PIXELS * 4];
+static uint t;
+
+static void bench_pattern(void *ctx)
+{
+    pattern_render((int) (uintptr_t) ctx, strip1_data, true, NUM_PIXELS, t++);
+}
+
+static void bench_transform(void *ctx)
+{
+    transform_strips(strips, count_of(strips), colors, NUM_PIXELS * 4, 0x10 << FRAC_BITS);
+}
+
+static void bench_add_error(void *ctx)
+{
+    add_error(&states[0][0], &colors[0], &states[1][0]);
+}
+
+static void bench_dither(void *ctx)
+{
+    dither_values(colors, states[0], states[1], NUM_PIXELS * 4);
+}
+
+static void bench_planes2(void *ctx)
+{
+    for (uint v = 0; v < NUM_PIXELS * 4; v++) planes_from_values2(&colors[v], strip0_data[v % sizeof(strip0_data)], v);
+}
+
+static void bench_scale(void *ctx)
+{
+    static uint32_t scaled[NUM_PIXELS];
+    pk_scale_buffer(scaled, (const uint32_t *) strip1_data, NUM_PIXELS, 0x80);
+}
+
+static const bench_case_t cases[] = {
+        BENCH_CASE("pattern_snakes", bench_pattern, (void *) 0),
+        BENCH_CASE("pattern_random", bench_pattern, (void *) 1),
+        BENCH_CASE("pattern_sparkle", bench_pattern, (void *) 2),
+        BENCH_CASE("pattern_greys", bench_pattern, (void *) 3),
+        BENCH_CASE("pattern_plasma", bench_pattern, (void *) 4),
+        BENCH_CASE("pattern_noise", bench_pattern, (void *) 5),
+        BENCH_CASE("pk_scale_buffer", bench_scale, NULL),
+        BENCH_CASE("planes_from_values2", bench_planes2, NULL),
+        BENCH_CASE("transform_strips", bench_transform, NULL),
+        BENCH_CASE("add_error", bench_add_error, NULL),
+        BENCH_CASE("dither_values", bench_dither, NULL),
+};
+
+int main()
+{
+    stdio_init_all();
+    sleep_ms(2000);     // 等 USB 序列埠連上
+
+    // 燈效的內容會影響 transform 的分支，先填一個真實的畫面
+    pattern_render(0, strip0_data, false, NUM_PIXELS, 0);
+    pattern_render(1, strip1_data, true, NUM_PIXELS, 0);
+
+    while (1) {
+        bench_run_all("pio_ws2812", cases, count_of(cases), ITERS);
+        sleep_ms(5000);
+    }
+}
@@ -0,0 +1,426 @@
+/*!
+  \brief LED 矩陣用的 Sprite / 字型 blitter
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/interp.h"
+
+#include "led_blit.h"
+
+// -----------------------------------------------------------------------------
+// 5x7 字型，每個字 5 個 column，bit0 是最上面那一列
+// -----------------------------------------------------------------------------
+
+#define FONT_FIRST  0x20
+#define FONT_LAST   0x5A
+
+static const uint8_t font5x7[FONT_LAST - FONT_FIRST + 1][BLIT_FONT_WIDTH] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+    {0x00, 0x00, 0x5F, 0x00, 0x00}, // '!'
+    {0x00, 0x07, 0x00, 0x07, 0x00}, // '"'
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // '#'
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // '$'
+    {0x23, 0x13, 0x08, 0x64, 0x62}, // '%'
+    {0x36, 0x49, 0x55, 0x22, 0x50}, // '&'
+    {0x00, 0x05, 0x03, 0x00, 0x00}, // '''
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, // '('
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, // ')'
+    {0x08, 0x2A, 0x1C, 0x2A, 0x08}, // '*'
+    {0x08, 0x08, 0x3E, 0x08, 0x08}, // '+'
+    {0x00, 0x50, 0x30, 0x00, 0x00}, // ','
+    {0x08, 0x08, 0x08, 0x08, 0x08}, // '-'
+    {0x00, 0x60, 0x60, 0x00, 0x00}, // '.'
+    {0x20, 0x10, 0x08, 0x04, 0x02}, // '/'
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // '0'
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, // '1'
+    {0x42, 0x61, 0x51, 0x49, 0x46}, // '2'
+    {0x21, 0x41, 0x45, 0x4B, 0x31}, // '3'
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, // '4'
+    {0x27, 0x45, 0x45, 0x45, 0x39}, // '5'
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // '6'
+    {0x01, 0x71, 0x09, 0x05, 0x03}, // '7'
+    {0x36, 0x49, 0x49, 0x49, 0x36}, // '8'
+    {0x06, 0x49, 0x49, 0x29, 0x1E}, // '9'
+    {0x00, 0x36, 0x36, 0x00, 0x00}, // ':'
+    {0x00, 0x56, 0x36, 0x00, 0x00}, // ';'
+    {0x00, 0x08, 0x14, 0x22, 0x41}, // '<'
+    {0x14, 0x14, 0x14, 0x14, 0x14}, // '='
+    {0x41, 0x22, 0x14, 0x08, 0x00}, // '>'
+    {0x02, 0x01, 0x51, 0x09, 0x06}, // '?'
+    {0x32, 0x49, 0x79, 0x41, 0x3E}, // '@'
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, // 'A'
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, // 'B'
+    {0x3E, 0x41, 0x41, 0x41, 0x22}, // 'C'
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // 'D'
+    {0x7F, 0x49, 0x49, 0x49, 0x41}, // 'E'
+    {0x7F, 0x09, 0x09, 0x01, 0x01}, // 'F'
+    {0x3E, 0x41, 0x41, 0x51, 0x32}, // 'G'
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // 'H'
+    {0x00, 0x41, 0x7F, 0x41, 0x00}, // 'I'
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, // 'J'
+    {0x7F, 0x08, 0x14, 0x22, 0x41}, // 'K'
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, // 'L'
+    {0x7F, 0x02, 0x04, 0x02, 0x7F}, // 'M'
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // 'N'
+    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // 'O'
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, // 'P'
+    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // 'Q'
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, // 'R'
+    {0x46, 0x49, 0x49, 0x49, 0x31}, // 'S'
+    {0x01, 0x01, 0x7F, 0x01, 0x01}, // 'T'
+    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // 'U'
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // 'V'
+    {0x7F, 0x20, 0x18, 0x20, 0x7F}, // 'W'
+    {0x63, 0x14, 0x08, 0x14, 0x63}, // 'X'
+    {0x03, 0x04, 0x78, 0x04, 0x03}, // 'Y'
+    {0x61, 0x51, 0x49, 0x45, 0x43}, // 'Z'
+};
+
+// -----------------------------------------------------------------------------
+// DMA control block
+// -----------------------------------------------------------------------------
+
+/*! 一個 control block 剛好對應 DMA alias 3 的四個暫存器
+  (CTRL, WRITE_ADDR, TRANS_COUNT, READ_ADDR_TRIG)，寫到最後一個就觸發。
+ */
+typedef struct {
+    uint32_t ctrl;
+    uint32_t write_addr;
+    uint32_t trans_count;
+    uint32_t read_addr;
+} blit_cb_t;
+
+// control channel 的 write ring 是 16 bytes，所以 control block 陣列也要對齊
+static blit_cb_t blit_cbs[BLIT_MAX_ROWS + 1] __attribute__((aligned(16)));
+
+static uint blit_data_chan;     //<! 實際搬資料的通道
+static uint blit_ctrl_chan;     //<! 把 control block 寫進 data 通道的通道
+static uint32_t blit_ctrl_copy; //<! 讀寫位址都遞增 (列複製)
+static uint32_t blit_ctrl_fill; //<! 只有寫入位址遞增 (填色)
+static uint32_t blit_fill_color;
+static bool blit_active;        //<! 有 blit 已經啟動但還沒確認完成
+
+void blit_init(void)
+{
+    blit_data_chan = dma_claim_unused_channel(true);
+    blit_ctrl_chan = dma_claim_unused_channel(true);
+
+    // data 通道：記憶體到記憶體，每個 block 結束就 chain 回 control 通道
+    // quiet 模式下只有寫入 NULL 觸發時才會舉起中斷旗標，剛好當作「整串做完」
+    dma_channel_config c = dma_channel_get_default_config(blit_data_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_chain_to(&c, blit_ctrl_chan);
+    channel_config_set_irq_quiet(&c, true);
+    blit_ctrl_copy = channel_config_get_ctrl_value(&c);
+
+    channel_config_set_read_increment(&c, false);
+    blit_ctrl_fill = channel_config_get_ctrl_value(&c);
+
+    // control 通道：每次搬 4 個 word 到 data 通道的 alias 3，write ring = 16 bytes
+    dma_channel_config cc = dma_channel_get_default_config(blit_ctrl_chan);
+    channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+    channel_config_set_read_increment(&cc, true);
+    channel_config_set_write_increment(&cc, true);
+    channel_config_set_ring(&cc, true, 4);
+    dma_channel_configure(blit_ctrl_chan,
+                          &cc,
+                          &dma_channel_hw_addr(blit_data_chan)->al3_ctrl,
+                          blit_cbs,
+                          4,
+                          false);
+
+    // INTERP0：lane0 取 bit2，lane1 取 bit3 (shift 1 之後的 bit2)，
+    // 都加上 base = 調色盤位址，一次寫入就能讀出兩個像素的顏色指標
+    interp_config ic = interp_default_config();
+    interp_config_set_shift(&ic, 0);
+    interp_config_set_mask(&ic, 2, 2);
+    interp_set_config(interp0, 0, &ic);
+    interp_config_set_shift(&ic, 1);
+    interp_config_set_cross_input(&ic, true);
+    interp_set_config(interp0, 1, &ic);
+}
+
+bool blit_busy(void)
+{
+    if (!blit_active) return false;
+    if (dma_hw->intr & (1u << blit_data_chan)) {
+        dma_hw->intr = 1u << blit_data_chan;
+        blit_active = false;
+        return false;
+    }
+    return true;
+}
+
+void blit_wait(void)
+{
+    while (blit_busy()) {
+        tight_loop_contents();
+    }
+}
+
+/*! 裁切
+  \return 裁切後還有像素要畫就回傳 true，並更新所有參數
+ */
+static bool blit_clip(const led_fb_t *fb, int *x, int *y, uint *w, uint *h, uint *sx, uint *sy)
+{
+    *sx = 0;
+    *sy = 0;
+    if (*x < 0) {
+        if ((uint) -*x >= *w) return false;
+        *sx = -*x;
+        *w += *x;
+        *x = 0;
+    }
+    if (*y < 0) {
+        if ((uint) -*y >= *h) return false;
+        *sy = -*y;
+        *h += *y;
+        *y = 0;
+    }
+    if ((uint) *x >= fb->width || (uint) *y >= fb->height) return false;
+    if (*x + *w > fb->width) *w = fb->width - *x;
+    if (*y + *h > fb->height) *h = fb->height - *y;
+    return true;
+}
+
+static void blit_start(uint num_cbs)
+{
+    // NULL 觸發：ctrl 仍然要帶 IRQ_QUIET，不然不會舉旗標
+    blit_cbs[num_cbs] = (blit_cb_t) {blit_ctrl_copy, 0, 0, 0};
+
+    dma_hw->intr = 1u << blit_data_chan;
+    blit_active = true;
+    dma_channel_set_read_addr(blit_ctrl_chan, blit_cbs, true);
+}
+
+bool blit_copy_async(led_fb_t *fb, int x, int y, const led_sprite_t *spr)
+{
+    uint w = spr->width, h = spr->height, sx, sy;
+    blit_wait();
+    if (!blit_clip(fb, &x, &y, &w, &h, &sx, &sy)) return true;
+
+    const uint32_t *src = spr->pixels + sy * spr->stride + sx;
+    uint32_t *dst = fb->pixels + y * fb->stride + x;
+
+    // 來源和目的都是連續的整列，合併成一個 block
+    if (w == spr->stride && w == fb->stride) {
+        blit_cbs[0] = (blit_cb_t) {blit_ctrl_copy, (uintptr_t) dst, w * h, (uintptr_t) src};
+        blit_start(1);
+        return true;
+    }
+
+    // 每列一個 control block，只有這裡受 BLIT_MAX_ROWS 限制
+    bool complete = h <= BLIT_MAX_ROWS;
+    if (!complete) h = BLIT_MAX_ROWS;
+    for (uint r = 0; r < h; r++) {
+        blit_cbs[r] = (blit_cb_t) {blit_ctrl_copy, (uintptr_t) dst, w, (uintptr_t) src};
+        src += spr->stride;
+        dst += fb->stride;
+    }
+    blit_start(h);
+    return complete;
+}
+
+bool blit_fill_async(led_fb_t *fb, int x, int y, uint w, uint h, uint32_t color)
+{
+    uint sx, sy;
+    blit_wait();
+    if (!blit_clip(fb, &x, &y, &w, &h, &sx, &sy)) return true;
+
+    blit_fill_color = color;
+    uint32_t *dst = fb->pixels + y * fb->stride + x;
+
+    if (w == fb->stride) {
+        blit_cbs[0] = (blit_cb_t) {blit_ctrl_fill, (uintptr_t) dst, w * h, (uintptr_t) &blit_fill_color};
+        blit_start(1);
+        return true;
+    }
+
+    bool complete = h <= BLIT_MAX_ROWS;
+    if (!complete) h = BLIT_MAX_ROWS;
+    for (uint r = 0; r < h; r++) {
+        blit_cbs[r] = (blit_cb_t) {blit_ctrl_fill, (uintptr_t) dst, w, (uintptr_t) &blit_fill_color};
+        dst += fb->stride;
+    }
+    blit_start(h);
+    return complete;
+}
+
+void blit_keyed(led_fb_t *fb, int x, int y, const led_sprite_t *spr, uint32_t key)
+{
+    uint w = spr->width, h = spr->height, sx, sy;
+    if (!blit_clip(fb, &x, &y, &w, &h, &sx, &sy)) return;
+
+    const uint32_t *src = spr->pixels + sy * spr->stride + sx;
+    uint32_t *dst = fb->pixels + y * fb->stride + x;
+    for (uint r = 0; r < h; r++) {
+        for (uint i = 0; i < w; i++) {
+            uint32_t p = src[i];
+            if (p != key) dst[i] = p;
+        }
+        src += spr->stride;
+        dst += fb->stride;
+    }
+}
+
+void blit_alpha(led_fb_t *fb, int x, int y, const led_sprite_t *spr, uint alpha)
+{
+    uint w = spr->width, h = spr->height, sx, sy;
+    if (alpha > 256) alpha = 256;
+    if (!blit_clip(fb, &x, &y, &w, &h, &sx, &sy)) return;
+
+    const uint32_t *src = spr->pixels + sy * spr->stride + sx;
+    uint32_t *dst = fb->pixels + y * fb->stride + x;
+    for (uint r = 0; r < h; r++) {
+        for (uint i = 0; i < w; i++) {
+            dst[i] = led_blend(dst[i], src[i], alpha);
+        }
+        src += spr->stride;
+        dst += fb->stride;
+    }
+}
+
+// 用 INTERP0 把一個 column 的 bits 展開成顏色，一次寫入 accum 讀出兩列
+static inline void blit_glyph_column(led_fb_t *fb, int x, int y, uint8_t bits)
+{
+    uint32_t *dst = fb->pixels + y * fb->stride + x;
+    const uint stride = fb->stride;
+
+    for (uint r = 0; r < BLIT_FONT_HEIGHT; r += 2) {
+        // 把 row r 的 bit 移到 bit2
+        interp0->accum[0] = ((uint32_t) bits << 2) >> r;
+        const uint32_t *p0 = (const uint32_t *) (uintptr_t) interp0->peek[0];
+        const uint32_t *p1 = (const uint32_t *) (uintptr_t) interp0->peek[1];
+        dst[r * stride] = *p0;
+        if (r + 1 < BLIT_FONT_HEIGHT) dst[(r + 1) * stride] = *p1;
+    }
+}
+
+int blit_text(led_fb_t *fb, int x, int y, const char *s, uint32_t fg, uint32_t bg, bool transparent)
+{
+    uint32_t palette[2] = {bg, fg};
+    interp0->base[0] = (uintptr_t) palette;
+    interp0->base[1] = (uintptr_t) palette;
+
+    for (; *s; s++, x += BLIT_FONT_ADVANCE) {
+        char ch = *s;
+        if (ch >= 'a' && ch <= 'z') ch -= 'a' - 'A';
+        if (ch < FONT_FIRST || ch > FONT_LAST) ch = '?';
+        const uint8_t *glyph = font5x7[ch - FONT_FIRST];
+
+        // 整個字都在畫面內，而且不透明：走插補器快速路徑
+        bool inside = x >= 0 && y >= 0 &&
+                      (uint) x + BLIT_FONT_WIDTH <= fb->width &&
+                      (uint) y + BLIT_FONT_HEIGHT <= fb->height;
+        if (inside && !transparent) {
+            for (uint c = 0; c < BLIT_FONT_WIDTH; c++) {
+                blit_glyph_column(fb, x + c, y, glyph[c]);
+            }
+            continue;
+        }
+
+        // 部分超出畫面或透明背景，逐點處理
+        for (uint c = 0; c < BLIT_FONT_WIDTH; c++) {
+            int px = x + (int) c;
+            if (px < 0 || (uint) px >= fb->width) continue;
+            for (uint r = 0; r < BLIT_FONT_HEIGHT; r++) {
+                int py = y + (int) r;
+                if (py < 0 || (uint) py >= fb->height) continue;
+                bool on = (glyph[c] >> r) & 1u;
+                if (on || !transparent) {
+                    fb->pixels[py * fb->stride + px] = on ? fg : bg;
+                }
+            }
+        }
+    }
+    return x;
+}
+
+// -----------------------------------------------------------------------------
+// 效能測試
+// -----------------------------------------------------------------------------
+
+#define BENCH_W     32
+#define BENCH_H     32
+#define BENCH_LOOPS 200
+
+static uint32_t bench_fb_pixels[BENCH_W * BENCH_H];
+static uint32_t bench_sprite_pixels[BENCH_W * BENCH_H];
+
+static void bench_report(const char *name, uint64_t pixels, uint64_t us)
+{
+    if (us == 0) us = 1;
+    printf("  %-18s %8.2f px/us\n", name, (double) pixels / (double) us);
+}
+
+void blit_benchmark(void)
+{
+    led_fb_t fb = {bench_fb_pixels, BENCH_W, BENCH_H, BENCH_W};
+    // 寬度比畫面小 1，強迫走逐列的 control block 路徑
+    led_sprite_t rows = {bench_sprite_pixels, BENCH_W - 1, BENCH_H, BENCH_W};
+    led_sprite_t full = {bench_sprite_pixels, BENCH_W, BENCH_H, BENCH_W};
+
+    for (uint i = 0; i < count_of(bench_sprite_pixels); i++) {
+        bench_sprite_pixels[i] = (i & 3) ? led_rgb(i, i >> 2, 0x40) : 0;
+    }
+
+    printf("blit benchmark (%ux%u, %u loops)\n", BENCH_W, BENCH_H, BENCH_LOOPS);
+
+    uint64_t t0 = time_us_64();
+    for (uint i = 0; i < BENCH_LOOPS; i++) {
+        blit_copy_async(&fb, 0, 0, &full);
+        blit_wait();
+    }
+    bench_report("copy (DMA, 1 cb)", (uint64_t) BENCH_LOOPS * BENCH_W * BENCH_H, time_us_64() - t0);
+
+    t0 = time_us_64();
+    for (uint i = 0; i < BENCH_LOOPS; i++) {
+        blit_copy_async(&fb, 1, 0, &rows);
+        blit_wait();
+    }
+    bench_report("copy (DMA, rows)", (uint64_t) BENCH_LOOPS * (BENCH_W - 1) * BENCH_H, time_us_64() - t0);
+
+    t0 = time_us_64();
+    for (uint i = 0; i < BENCH_LOOPS; i++) {
+        blit_fill_async(&fb, 0, 0, BENCH_W, BENCH_H, led_rgb(1, 2, 3));
+        blit_wait();
+    }
+    bench_report("fill (DMA)", (uint64_t) BENCH_LOOPS * BENCH_W * BENCH_H, time_us_64() - t0);
+
+    t0 = time_us_64();
+    for (uint i = 0; i < BENCH_LOOPS; i++) {
+        blit_keyed(&fb, 0, 0, &full, 0);
+    }
+    bench_report("color key (CPU)", (uint64_t) BENCH_LOOPS * BENCH_W * BENCH_H, time_us_64() - t0);
+
+    t0 = time_us_64();
+    for (uint i = 0; i < BENCH_LOOPS; i++) {
+        blit_alpha(&fb, 0, 0, &full, 96);
+    }
+    bench_report("alpha (CPU)", (uint64_t) BENCH_LOOPS * BENCH_W * BENCH_H, time_us_64() - t0);
+
+    // 5 個字 * 35 像素
+    t0 = time_us_64();
+    for (uint i = 0; i < BENCH_LOOPS; i++) {
+        blit_text(&fb, 0, 0, "HELLO", led_rgb(255, 255, 255), 0, false);
+    }
+    bench_report("text (interp)", (uint64_t) BENCH_LOOPS * 5 * BLIT_FONT_WIDTH * BLIT_FONT_HEIGHT, time_us_64() - t0);
+
+    // DMA 與 CPU 同時工作：DMA 複製上半部，CPU 混色下半部
+    led_sprite_t top = {bench_sprite_pixels, BENCH_W, BENCH_H / 2, BENCH_W};
+    led_sprite_t bottom = {bench_sprite_pixels + BENCH_W * BENCH_H / 2, BENCH_W, BENCH_H / 2, BENCH_W};
+    t0 = time_us_64();
+    for (uint i = 0; i < BENCH_LOOPS; i++) {
+        blit_copy_async(&fb, 0, 0, &top);
+        blit_alpha(&fb, 0, BENCH_H / 2, &bottom, 128);
+        blit_wait();
+    }
+    bench_report("copy || alpha", (uint64_t) BENCH_LOOPS * BENCH_W * BENCH_H, time_us_64() - t0);
+}
@@ -0,0 +1,101 @@
+/*!
+  \brief LED 矩陣用的 Sprite / 字型 blitter
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  畫面緩衝區 (framebuffer) 直接存「線上格式」的像素：GRB 放在高 24 bits
+  (也就是 ws2812.c 的 put_pixel() 送進 FIFO 前 <<8 的那個值)，這樣整張畫面
+  可以直接用 DMA 丟給 ws2812 狀態機，不必再逐點轉換。
+
+  - 不透明的列複製 / 填色：用兩個 DMA 通道跑 control block 鏈，CPU 只負責排程
+  - 透明色 (color key)、alpha 混色：CPU 處理，alpha 一次算兩個 8-bit 通道
+  - 1-bit 字型：用 SIO 插補器 (INTERP0) 把 bit 展開成前景/背景色
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+//! 一次 DMA blit 最多幾列 (control block 數量)，超過的列不畫；CPU 的 blit_keyed / blit_alpha 不受限
+#ifndef BLIT_MAX_ROWS
+#define BLIT_MAX_ROWS 64
+#endif
+
+//! 字型寬高 (5x7，另外留一行間距)
+#define BLIT_FONT_WIDTH     5
+#define BLIT_FONT_HEIGHT    7
+#define BLIT_FONT_ADVANCE   (BLIT_FONT_WIDTH + 1)
+
+/*! 畫面緩衝區
+  \note stride 以「像素」為單位，可以大於 width (例如在大畫面中開一個視窗)
+ */
+typedef struct {
+    uint32_t *pixels;   //<! 線上格式像素 (GRB << 8)
+    uint width;         //<! 寬度 (像素)
+    uint height;        //<! 高度 (像素)
+    uint stride;        //<! 每列間距 (像素)
+} led_fb_t;
+
+//! 來源圖塊，格式同 led_fb_t
+typedef struct {
+    const uint32_t *pixels;
+    uint width;
+    uint height;
+    uint stride;
+} led_sprite_t;
+
+//! RGB 轉成線上格式 (GRB << 8)
+static inline uint32_t led_rgb(uint8_t r, uint8_t g, uint8_t b)
+{
+    return ((uint32_t) g << 24) | ((uint32_t) r << 16) | ((uint32_t) b << 8);
+}
+
+/*! 定點 alpha 混色
+  \param dst 目的像素
+  \param src 來源像素
+  \param alpha 0 ~ 256 (256 = 完全是 src)
+  \note 用 0x00ff00ff 遮罩一次處理兩個通道，每個通道的乘積最大 255*256，
+        不會溢位到隔壁通道。對線上格式的四個 byte 都適用 (含 RGBW 的 W)。
+ */
+static inline uint32_t led_blend(uint32_t dst, uint32_t src, uint alpha)
+{
+    uint inv = 256 - alpha;
+    uint32_t lo = (((src & 0x00ff00ffu) * alpha + (dst & 0x00ff00ffu) * inv) >> 8) & 0x00ff00ffu;
+    uint32_t hi = ((((src >> 8) & 0x00ff00ffu) * alpha + ((dst >> 8) & 0x00ff00ffu) * inv)) & 0xff00ff00u;
+    return lo | hi;
+}
+
+//! 取得 DMA 通道並設定 INTERP0，使用其他 API 前必須先呼叫
+void blit_init(void);
+
+//! DMA blit 是否還在進行
+bool blit_busy(void);
+
+//! 等待 DMA blit 完成
+void blit_wait(void);
+
+/*! 非同步複製圖塊到畫面 (DMA，逐列一個 control block)
+  \return 裁切後超過 BLIT_MAX_ROWS 列 (只畫了前面 BLIT_MAX_ROWS 列) 時回傳 false，完全在畫面外不算
+  \note 呼叫後立即返回，CPU 可以同時處理其他區域。
+        在 blit_wait() 之前不要修改來源圖塊或同一塊畫面區域。
+ */
+bool blit_copy_async(led_fb_t *fb, int x, int y, const led_sprite_t *spr);
+
+/*! 非同步以單一顏色填滿矩形 (DMA 讀取位址不遞增)
+  \return 同 blit_copy_async()，有列沒畫到時回傳 false
+ */
+bool blit_fill_async(led_fb_t *fb, int x, int y, uint w, uint h, uint32_t color);
+
+//! 複製圖塊，跳過等於 key 的像素 (CPU)
+void blit_keyed(led_fb_t *fb, int x, int y, const led_sprite_t *spr, uint32_t key);
+
+//! 以固定 alpha (0 ~ 256) 把圖塊混到畫面上 (CPU)
+void blit_alpha(led_fb_t *fb, int x, int y, const led_sprite_t *spr, uint alpha);
+
+/*! 繪製字串 (5x7 字型，支援 ASCII 0x20 ~ 0x5A，小寫會轉成大寫)
+  \param transparent true 時背景不畫，bg 被忽略
+  \return 下一個字元的 x 座標
+ */
+int blit_text(led_fb_t *fb, int x, int y, const char *s, uint32_t fg, uint32_t bg, bool transparent);
+
+//! 各種 blit 的吞吐量測試，結果以 pixels/us 印出
+void blit_benchmark(void);
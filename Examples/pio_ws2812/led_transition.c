@@ -0,0 +1,85 @@
+/*!
+  \brief 燈效之間的轉場 (crossfade / wipe)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <string.h>
+
+#include "pico/stdlib.h"
+
+#include "led_transition.h"
+#include "pixel_kernels.h"
+
+//! wipe 邊緣的漸層長度 (像素)
+#define WIPE_EDGE_PIXELS 8
+
+void transition_start(led_transition_t *tr, transition_kind_t kind, uint frames)
+{
+    tr->kind = kind;
+    tr->frames = frames;
+    tr->frame = 0;
+}
+
+uint transition_alpha(const led_transition_t *tr)
+{
+    if (!transition_active(tr)) return 256;
+
+    // x: 0 ~ 256
+    uint x = (tr->frame * 256) / tr->frames;
+    if (tr->kind == TRANSITION_EASED) {
+        // smoothstep: x^2 * (3 - 2x)，全部在 8.8 定點下計算
+        x = (x * x * (3 * 256 - 2 * x)) >> 16;
+    }
+    return x;
+}
+
+void transition_blend(uint8_t *out, const uint8_t *from, const uint8_t *to, uint len, uint alpha)
+{
+    if (alpha >= 256) {
+        memcpy(out, to, len);
+        return;
+    }
+    if (alpha == 0) {
+        memcpy(out, from, len);
+        return;
+    }
+
+    uint words = len / 4;
+    uint32_t *o = (uint32_t *) out;
+    const uint32_t *f = (const uint32_t *) from;
+    const uint32_t *t = (const uint32_t *) to;
+    for (uint i = 0; i < words; i++) {
+        o[i] = pk_blend(f[i], t[i], alpha);
+    }
+    for (uint i = words * 4; i < len; i++) {
+        out[i] = (uint8_t) ((to[i] * alpha + from[i] * (256 - alpha)) >> 8);
+    }
+}
+
+void transition_render(const led_transition_t *tr, uint8_t *out, const uint8_t *from, const uint8_t *to,
+                       uint len, uint bytes_per_pixel)
+{
+    uint alpha = transition_alpha(tr);
+    if (tr->kind != TRANSITION_WIPE || alpha >= 256) {
+        transition_blend(out, from, to, len, alpha);
+        return;
+    }
+
+    // 掃描線位置從 0 走到 (像素數 + 邊緣長度)，線之前是新的，線之後是舊的
+    uint pixels = len / bytes_per_pixel;
+    uint head = (alpha * (pixels + WIPE_EDGE_PIXELS)) >> 8;
+    uint done = head > WIPE_EDGE_PIXELS ? MIN(head - WIPE_EDGE_PIXELS, pixels) : 0;
+    uint edge_end = MIN(head, pixels);
+
+    memcpy(out, to, done * bytes_per_pixel);
+    for (uint p = done; p < edge_end; p++) {
+        // 邊緣內線性漸層
+        uint a = ((head - p) * 256) / (WIPE_EDGE_PIXELS + 1);
+        for (uint b = 0; b < bytes_per_pixel; b++) {
+            uint i = p * bytes_per_pixel + b;
+            out[i] = (uint8_t) ((to[i] * a + from[i] * (256 - a)) >> 8);
+        }
+    }
+    memcpy(out + edge_end * bytes_per_pixel, from + edge_end * bytes_per_pixel,
+           len - edge_end * bytes_per_pixel);
+}
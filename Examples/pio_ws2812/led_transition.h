@@ -0,0 +1,62 @@
+/*!
+  \brief 燈效之間的轉場 (crossfade / wipe)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  兩個燈效各自畫到自己的緩衝區，轉場期間每個 frame 多畫一次新的燈效，
+  再做一次混色，結果寫到輸出緩衝區。混色一次處理 4 bytes (pixel_kernels.h 的 pk_blend)：
+  把一個 word 拆成兩半，每半同時算兩個 8-bit 通道。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+//! 轉場種類
+typedef enum {
+    TRANSITION_LINEAR,  //<! 線性淡入淡出
+    TRANSITION_EASED,   //<! 頭尾較慢的淡入淡出 (smoothstep)
+    TRANSITION_WIPE,    //<! 從燈條起點往終點掃過去，邊緣有一小段漸層
+} transition_kind_t;
+
+//! 轉場狀態
+typedef struct {
+    transition_kind_t kind;
+    uint frames;    //<! 總 frame 數，0 表示沒有轉場
+    uint frame;     //<! 目前第幾個 frame
+} led_transition_t;
+
+//! 開始轉場
+void transition_start(led_transition_t *tr, transition_kind_t kind, uint frames);
+
+//! 轉場是否進行中
+static inline bool transition_active(const led_transition_t *tr)
+{
+    return tr->frame < tr->frames;
+}
+
+//! 目前的混合比例 (0 = 完全是舊的，256 = 完全是新的)
+uint transition_alpha(const led_transition_t *tr);
+
+/*! 以固定比例混合兩個緩衝區
+  \param alpha 0 ~ 256，256 表示完全是 to
+  \note 三個緩衝區都要 4 bytes 對齊，len 不是 4 的倍數時尾端逐 byte 處理
+ */
+void transition_blend(uint8_t *out, const uint8_t *from, const uint8_t *to, uint len, uint alpha);
+
+/*! 依照轉場種類產生一個 frame
+  \param bytes_per_pixel 3 (RGB) 或 4 (RGBW)，wipe 以像素為單位前進
+ */
+void transition_render(const led_transition_t *tr, uint8_t *out, const uint8_t *from, const uint8_t *to,
+                       uint len, uint bytes_per_pixel);
+
+//! 前進一個 frame
+static inline void transition_step(led_transition_t *tr)
+{
+    if (tr->frame < tr->frames) tr->frame++;
+}
+
+//! 直接跳到某個進度 (以實際時間驅動時，frames 可以當成毫秒來用)
+static inline void transition_seek(led_transition_t *tr, uint frame)
+{
+    tr->frame = frame < tr->frames ? frame : tr->frames;
+}
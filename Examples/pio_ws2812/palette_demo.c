@@ -0,0 +1,99 @@
+/*!
+  \brief 調色盤索引畫面範例：1000 顆 RGBW 燈的彩虹 palette cycling
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "ws2812.pio.h"
+
+#include "palette_fb.h"
+
+#define IS_RGBW     true    //<! 設定為 true 如果你的燈是 RGBW 版本
+#define NUM_PIXELS  1000    //<! 燈珠數量
+#define WS2812_PIN  16      //<! 連接到 WS2812 的 GPIO 腳位
+
+static uint8_t pixel_index[(NUM_PIXELS + 3) & ~3] __attribute__((aligned(4)));
+static palette_fb_t fb = {
+    .index = pixel_index,
+    .num_pixels = NUM_PIXELS,
+};
+
+//! 線上格式：RGB 是 GRB << 8，RGBW 是 GRBW
+static inline uint32_t wire_color(uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+    return ((uint32_t) g << 24) | ((uint32_t) r << 16) | ((uint32_t) b << 8) | (IS_RGBW ? w : 0);
+}
+
+//! 色相 0~255 轉成 RGB，brightness 0~255
+static void make_rainbow(uint brightness)
+{
+    for (uint i = 0; i < PALETTE_SIZE; i++) {
+        uint seg = i / 86, pos = (i % 86) * 3;
+        uint r, g, b;
+        if (seg == 0) {
+            r = 255 - pos; g = pos; b = 0;
+        } else if (seg == 1) {
+            r = 0; g = 255 - pos; b = pos;
+        } else {
+            r = pos; g = 0; b = 255 - pos;
+        }
+        palette_set(&fb, i, wire_color(r * brightness / 255, g * brightness / 255,
+                                       b * brightness / 255, brightness / 8));
+    }
+}
+
+static void benchmark(void)
+{
+    static uint32_t out[NUM_PIXELS];
+    const uint loops = 100;
+    uint n = NUM_PIXELS & ~3u;
+
+    uint64_t t0 = time_us_64();
+    for (uint i = 0; i < loops; i++) palette_expand_c(pixel_index, out, n, fb.palette);
+    uint64_t t_c = time_us_64() - t0;
+
+    t0 = time_us_64();
+    for (uint i = 0; i < loops; i++) palette_expand(pixel_index, out, n, fb.palette);
+    uint64_t t_interp = time_us_64() - t0;
+
+    printf("expand %u pixels: C %.1f us, interp %.1f us\n", n,
+           (double) t_c / loops, (double) t_interp / loops);
+    printf("RAM: index %u bytes + palette %u bytes (full frame would be %u bytes)\n",
+           (uint) sizeof(pixel_index), (uint) sizeof(fb.palette), NUM_PIXELS * 4);
+}
+
+int main()
+{
+    stdio_init_all();
+    printf("WS2812 palette framebuffer, using pin %d\n", WS2812_PIN);
+
+    PIO pio;
+    uint sm;
+    uint offset;
+    bool success = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_program, &pio, &sm, &offset, WS2812_PIN, 1, true);
+    hard_assert(success);
+    ws2812_program_init(pio, sm, offset, WS2812_PIN, 800000, IS_RGBW);
+
+    uint dma_chan = dma_claim_unused_channel(true);
+    palette_interp_init();
+
+    for (uint i = 0; i < NUM_PIXELS; i++) {
+        pixel_index[i] = i * PALETTE_SIZE / NUM_PIXELS;
+    }
+    make_rainbow(32); // let's not draw too much current!
+
+    benchmark();
+
+    while (true) {
+        palette_fb_output(&fb, pio, sm, dma_chan);
+        // 整個畫面的動畫只有這一行
+        fb.rotation++;
+        dma_channel_wait_for_finish_blocking(dma_chan);
+        sleep_us(400);  // reset
+        sleep_ms(10);
+    }
+}
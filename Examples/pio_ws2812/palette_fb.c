@@ -0,0 +1,83 @@
+/*!
+  \brief 8-bit 調色盤索引畫面 (indexed framebuffer)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/interp.h"
+
+#include "palette_fb.h"
+
+#if PALETTE_CHUNK_PIXELS % 4
+#error PALETTE_CHUNK_PIXELS must be a multiple of 4
+#endif
+
+void palette_interp_init(void)
+{
+    // 兩個 lane 都取出 8 bits 索引並放在 bit2~9 (= 索引 * 4)，再加上 base (調色盤位址)
+    // lane0 讀 accum0 的 bit2~9，lane1 透過 cross input 讀 accum0 的 bit10~17
+    interp_config c = interp_default_config();
+    interp_config_set_shift(&c, 0);
+    interp_config_set_mask(&c, 2, 9);
+    interp_set_config(interp1, 0, &c);
+
+    interp_config_set_shift(&c, 8);
+    interp_config_set_cross_input(&c, true);
+    interp_set_config(interp1, 1, &c);
+}
+
+void __not_in_flash_func(palette_expand)(const uint8_t *idx, uint32_t *out, uint n, const uint32_t *palette)
+{
+    const uint32_t *words = (const uint32_t *) idx;
+
+    interp1->base[0] = (uintptr_t) palette;
+    interp1->base[1] = (uintptr_t) palette;
+
+    // 每讀一個 word (4 個索引) 只寫兩次 accum，讀四次結果
+    for (uint i = 0; i < n; i += 4) {
+        uint32_t w = *words++;
+
+        interp1->accum[0] = w << 2;         // byte0 -> bit2~9, byte1 -> bit10~17
+        out[0] = *(const uint32_t *) (uintptr_t) interp1->peek[0];
+        out[1] = *(const uint32_t *) (uintptr_t) interp1->peek[1];
+
+        interp1->accum[0] = w >> 14;        // byte2 -> bit2~9, byte3 -> bit10~17
+        out[2] = *(const uint32_t *) (uintptr_t) interp1->peek[0];
+        out[3] = *(const uint32_t *) (uintptr_t) interp1->peek[1];
+
+        out += 4;
+    }
+}
+
+void palette_expand_c(const uint8_t *idx, uint32_t *out, uint n, const uint32_t *palette)
+{
+    for (uint i = 0; i < n; i++) {
+        out[i] = palette[idx[i]];
+    }
+}
+
+void palette_fb_output(const palette_fb_t *fb, PIO pio, uint sm, uint dma_chan)
+{
+    static uint32_t chunk[2][PALETTE_CHUNK_PIXELS];
+
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+
+    const uint32_t *palette = fb->palette + fb->rotation;
+    uint cur = 0;
+
+    for (uint first = 0; first < fb->num_pixels; first += PALETTE_CHUNK_PIXELS) {
+        uint n = MIN(PALETTE_CHUNK_PIXELS, fb->num_pixels - first);
+
+        // 展開的同時，DMA 正在送上一塊
+        palette_expand(fb->index + first, chunk[cur], (n + 3) & ~3u, palette);
+
+        dma_channel_wait_for_finish_blocking(dma_chan);
+        dma_channel_configure(dma_chan, &c, &pio->txf[sm], chunk[cur], n, true);
+        cur ^= 1;
+    }
+}
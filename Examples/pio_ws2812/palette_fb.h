@@ -0,0 +1,57 @@
+/*!
+  \brief 8-bit 調色盤索引畫面 (indexed framebuffer)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  每個像素只存 1 byte 的調色盤索引，輸出時才用 SIO 插補器 (INTERP1)
+  展開成線上格式的 GRB / GRBW，邊展開邊用 DMA 送進 PIO：
+
+  - 1000 顆 RGBW 燈，雙緩衝的完整畫面要 8 KB，索引畫面只要 1 KB + 調色盤 2 KB
+  - 調色盤存兩份，旋轉 (palette cycling) 只是改一個 base 位址，不用搬資料
+  - 亮度調整只要處理 256 個調色盤項目，不用處理每個像素
+
+  INTERP0 留給 led_blit.c，這裡只用 INTERP1。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#define PALETTE_SIZE        256 //<! 調色盤項目數
+#define PALETTE_CHUNK_PIXELS 64 //<! 輸出時每次展開的像素數 (必須是 4 的倍數)
+
+//! 索引畫面
+typedef struct {
+    uint8_t *index;         //<! 像素索引，4 bytes 對齊，長度為 num_pixels 進位到 4 的倍數
+    uint num_pixels;        //<! 像素數量
+    uint8_t rotation;       //<! 調色盤旋轉量，索引 i 實際使用 palette[(i + rotation) & 0xff]
+    //! 線上格式顏色，後半是前半的複本，讓旋轉不需要取餘數
+    uint32_t palette[PALETTE_SIZE * 2];
+} palette_fb_t;
+
+//! 設定 INTERP1，在使用 palette_expand() 的那個核心上呼叫一次
+void palette_interp_init(void);
+
+//! 設定一個調色盤項目 (線上格式)，會同時更新複本
+static inline void palette_set(palette_fb_t *fb, uint8_t i, uint32_t color)
+{
+    fb->palette[i] = color;
+    fb->palette[i + PALETTE_SIZE] = color;
+}
+
+/*! 用插補器把 n 個索引展開成線上格式
+  \param idx 索引，4 bytes 對齊
+  \param n 必須是 4 的倍數
+  \param palette 調色盤起點 (已含旋轉量)
+ */
+void palette_expand(const uint8_t *idx, uint32_t *out, uint n, const uint32_t *palette);
+
+//! 一般 C 版本，結果與 palette_expand() 相同，用來比對與量測
+void palette_expand_c(const uint8_t *idx, uint32_t *out, uint n, const uint32_t *palette);
+
+/*! 輸出整個畫面到 ws2812 狀態機
+  \param dma_chan 已取得的 DMA 通道
+  \note 兩個 PALETTE_CHUNK_PIXELS 大小的緩衝區輪流使用：DMA 送前一塊時，
+        CPU 展開下一塊。函式在最後一塊開始送出後返回。
+ */
+void palette_fb_output(const palette_fb_t *fb, PIO pio, uint sm, uint dma_chan);
@@ -0,0 +1,52 @@
+/*!
+  \brief 像素運算核心的陣列版本
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <math.h>
+
+#include "pixel_kernels.h"
+
+void pk_gamma_table(uint8_t lut[256], float gamma)
+{
+    for (int i = 0; i < 256; i++) {
+        lut[i] = (uint8_t) (255.0f * powf(i / 255.0f, gamma) + 0.5f);
+    }
+}
+
+void pk_scale_buffer(uint32_t *dst, const uint32_t *src, uint32_t words, uint32_t scale)
+{
+    for (uint32_t i = 0; i < words; i++) {
+        dst[i] = pk_scale(src[i], scale);
+    }
+}
+
+void pk_add_sat_buffer(uint32_t *dst, const uint32_t *src, uint32_t words)
+{
+    for (uint32_t i = 0; i < words; i++) {
+        dst[i] = pk_add_sat(dst[i], src[i]);
+    }
+}
+
+void pk_blend_buffer(uint32_t *dst, const uint32_t *from, const uint32_t *to, uint32_t words, uint32_t alpha)
+{
+    for (uint32_t i = 0; i < words; i++) {
+        dst[i] = pk_blend(from[i], to[i], alpha);
+    }
+}
+
+void pk_gamma_buffer(uint32_t *dst, const uint32_t *src, uint32_t words, const uint8_t lut[256])
+{
+    for (uint32_t i = 0; i < words; i++) {
+        dst[i] = pk_gamma(src[i], lut);
+    }
+}
+
+uint32_t pk_power_buffer(const uint32_t *src, uint32_t words, uint32_t w02, uint32_t w13)
+{
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < words; i++) {
+        acc = pk_power_acc(acc, src[i], w02, w13);
+    }
+    return acc;
+}
@@ -0,0 +1,190 @@
+/*!
+  \brief 像素運算核心：一次處理一個 word 裡的 4 個 8-bit 通道
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  pico2_w (RP2350) 的 Cortex-M33 有 DSP 擴充指令，編譯器有定義 __ARM_FEATURE_SIMD32 時使用：
+  - UQADD8：4 個 byte 飽和加法
+  - USUB8 + SEL：4 個 byte 取最大 / 最小
+  - UXTB16：把 byte 0/2 或 1/3 展開成兩個 16-bit 通道
+  - USAT16：兩個 16-bit 通道同時飽和到 0~255
+  - SMLAD：兩組 16-bit 乘加，用在功率估算
+
+  RP2040 (Cortex-M0+) 和 RP2350 的 Hazard3 RISC-V 核心沒有這些指令，
+  改用一般整數運算的 SWAR 寫法，結果逐 bit 相同 (host/pixel_bench 會比對)。
+  乘法類 (縮放、混色) 兩種寫法都是一次 32-bit 乘法算兩個通道：
+  M33 的 SMUAD 一次只能得到一個通道的結果，反而比較慢，所以沒用在混色上。
+
+  不依賴 Pico SDK，可以直接在電腦上編譯。
+ */
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#include <arm_acle.h>
+#define PIXEL_KERNELS_DSP 1     //<! 使用 M33 DSP 指令
+#else
+#define PIXEL_KERNELS_DSP 0     //<! 使用可攜的 SWAR 寫法
+#endif
+
+// -----------------------------------------------------------------------------
+// 展開 / 合併
+// -----------------------------------------------------------------------------
+
+//! byte 0 和 byte 2 放到兩個 16-bit 通道
+static inline uint32_t pk_even(uint32_t v)
+{
+#if PIXEL_KERNELS_DSP
+    return __uxtb16(v);
+#else
+    return v & 0x00ff00ffu;
+#endif
+}
+
+//! byte 1 和 byte 3 放到兩個 16-bit 通道
+static inline uint32_t pk_odd(uint32_t v)
+{
+#if PIXEL_KERNELS_DSP
+    return __uxtb16(__ror(v, 8));
+#else
+    return (v >> 8) & 0x00ff00ffu;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// 核心
+// -----------------------------------------------------------------------------
+
+/*! 亮度縮放：每個 byte 乘上 scale / 256
+  \param scale 0 ~ 256
+ */
+static inline uint32_t pk_scale(uint32_t v, uint32_t scale)
+{
+    uint32_t even = ((pk_even(v) * scale) >> 8) & 0x00ff00ffu;
+    uint32_t odd = (pk_odd(v) * scale) & 0xff00ff00u;
+    return even | odd;
+}
+
+/*! 增益 (可以大於 1)：每個 byte 乘上 gain / 64，超過 255 就飽和
+  \param gain 0 ~ 256 (0 ~ 4.0 倍)
+ */
+static inline uint32_t pk_gain(uint32_t v, uint32_t gain)
+{
+    uint32_t even = ((pk_even(v) * gain) >> 6) & 0x03ff03ffu;
+    uint32_t odd = ((pk_odd(v) * gain) >> 6) & 0x03ff03ffu;
+#if PIXEL_KERNELS_DSP
+    even = __usat16(even, 8);
+    odd = __usat16(odd, 8);
+#else
+    // 通道值最多 10 bits，bit 8/9 有任何一個是 1 就飽和到 0xff
+    uint32_t ov = ((even >> 8) | (even >> 9)) & 0x00010001u;
+    even = (even | (ov * 0xffu)) & 0x00ff00ffu;
+    ov = ((odd >> 8) | (odd >> 9)) & 0x00010001u;
+    odd = (odd | (ov * 0xffu)) & 0x00ff00ffu;
+#endif
+    return even | (odd << 8);
+}
+
+//! 飽和加法，每個 byte 超過 255 就停在 255
+static inline uint32_t pk_add_sat(uint32_t a, uint32_t b)
+{
+#if PIXEL_KERNELS_DSP
+    return __uqadd8(a, b);
+#else
+    // 先加低 7 bits，再用最高位元算出進位，有進位的 byte 填 0xff
+    uint32_t sum = (a & 0x7f7f7f7fu) + (b & 0x7f7f7f7fu);
+    uint32_t carry = ((a & b) | ((a | b) & sum)) & 0x80808080u;
+    sum ^= (a ^ b) & 0x80808080u;
+    return sum | ((carry >> 7) * 0xffu);
+#endif
+}
+
+//! 每個 byte 取最大值 (疊加閃光之類的效果)
+static inline uint32_t pk_max(uint32_t a, uint32_t b)
+{
+#if PIXEL_KERNELS_DSP
+    // USUB8 依 a >= b 設定 GE 旗標，SEL 依旗標逐 byte 挑選
+    (void) __usub8(a, b);
+    return __sel(a, b);
+#else
+    // a - b 的每個 byte 借位表示 a < b
+    uint32_t diff = ((a | 0x80808080u) - (b & 0x7f7f7f7fu));
+    uint32_t ge = (((a & ~b) | ((a | ~b) & diff)) & 0x80808080u) >> 7;
+    uint32_t mask = ge * 0xffu;
+    return (a & mask) | (b & ~mask);
+#endif
+}
+
+//! 每個 byte 取最小值 (RGB 轉 RGBW 時算白色通道)
+static inline uint32_t pk_min(uint32_t a, uint32_t b)
+{
+#if PIXEL_KERNELS_DSP
+    (void) __usub8(a, b);
+    return __sel(b, a);
+#else
+    uint32_t diff = ((a | 0x80808080u) - (b & 0x7f7f7f7fu));
+    uint32_t ge = (((a & ~b) | ((a | ~b) & diff)) & 0x80808080u) >> 7;
+    uint32_t mask = ge * 0xffu;
+    return (b & mask) | (a & ~mask);
+#endif
+}
+
+/*! 混色：from * (256 - alpha) / 256 + to * alpha / 256
+  \param alpha 0 ~ 256
+ */
+static inline uint32_t pk_blend(uint32_t from, uint32_t to, uint32_t alpha)
+{
+    uint32_t inv = 256 - alpha;
+    uint32_t even = ((pk_even(to) * alpha + pk_even(from) * inv) >> 8) & 0x00ff00ffu;
+    uint32_t odd = (pk_odd(to) * alpha + pk_odd(from) * inv) & 0xff00ff00u;
+    return even | odd;
+}
+
+/*! 功率估算：累加 4 個 byte 乘上各自的權重
+  \param w02 byte 0 和 byte 2 的權重 (各 16 bits，最大 32767)
+  \param w13 byte 1 和 byte 3 的權重
+ */
+static inline uint32_t pk_power_acc(uint32_t acc, uint32_t v, uint32_t w02, uint32_t w13)
+{
+#if PIXEL_KERNELS_DSP
+    acc = (uint32_t) __smlad(pk_even(v), w02, (int32_t) acc);
+    return (uint32_t) __smlad(pk_odd(v), w13, (int32_t) acc);
+#else
+    uint32_t e = pk_even(v);
+    uint32_t o = pk_odd(v);
+    return acc + (e & 0xffffu) * (w02 & 0xffffu) + (e >> 16) * (w02 >> 16)
+               + (o & 0xffffu) * (w13 & 0xffffu) + (o >> 16) * (w13 >> 16);
+#endif
+}
+
+//! gamma 校正：查表，沒有比查表更快的 SIMD 寫法
+static inline uint32_t pk_gamma(uint32_t v, const uint8_t lut[256])
+{
+    return (uint32_t) lut[v & 0xff] | ((uint32_t) lut[(v >> 8) & 0xff] << 8) |
+           ((uint32_t) lut[(v >> 16) & 0xff] << 16) | ((uint32_t) lut[v >> 24] << 24);
+}
+
+// -----------------------------------------------------------------------------
+// 陣列版本 (pixel_kernels.c)
+// -----------------------------------------------------------------------------
+
+//! 產生 gamma 表，out = 255 * (in / 255) ^ gamma，四捨五入
+void pk_gamma_table(uint8_t lut[256], float gamma);
+
+//! words 個 word 全部乘上 scale / 256
+void pk_scale_buffer(uint32_t *dst, const uint32_t *src, uint32_t words, uint32_t scale);
+
+//! dst = sat(dst + src)
+void pk_add_sat_buffer(uint32_t *dst, const uint32_t *src, uint32_t words);
+
+//! dst = blend(from, to, alpha)
+void pk_blend_buffer(uint32_t *dst, const uint32_t *from, const uint32_t *to, uint32_t words, uint32_t alpha);
+
+//! 逐 byte 查 gamma 表
+void pk_gamma_buffer(uint32_t *dst, const uint32_t *src, uint32_t words, const uint8_t lut[256]);
+
+/*! 整條燈的功率估算
+  \return 所有 byte 乘上權重的總和，單位由權重決定
+ */
+uint32_t pk_power_buffer(const uint32_t *src, uint32_t words, uint32_t w02, uint32_t w13);
@@ -0,0 +1,176 @@
+/*!
+  \brief 像素運算核心的逐 byte 參考實作與比對
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  bit plane 轉置也在這裡比對。
+  電腦上 (host/pixel_bench) 比對的是 SWAR 寫法，
+  板子上 (kernels_bench.c) 比對的是實際編進韌體的版本 (M33 上就是 DSP 指令)。
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "pixel_kernels.h"
+#include "pixel_kernels_ref.h"
+#include "ws2812_planes.h"
+
+static inline uint32_t byte_of(uint32_t v, int i)
+{
+    return (v >> (8 * i)) & 0xff;
+}
+
+uint32_t ref_scale(uint32_t v, uint32_t scale)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 4; i++) r |= ((byte_of(v, i) * scale) >> 8) << (8 * i);
+    return r;
+}
+
+uint32_t ref_gain(uint32_t v, uint32_t gain)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 4; i++) {
+        uint32_t x = (byte_of(v, i) * gain) >> 6;
+        r |= (x > 255 ? 255 : x) << (8 * i);
+    }
+    return r;
+}
+
+uint32_t ref_add_sat(uint32_t a, uint32_t b)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 4; i++) {
+        uint32_t x = byte_of(a, i) + byte_of(b, i);
+        r |= (x > 255 ? 255 : x) << (8 * i);
+    }
+    return r;
+}
+
+uint32_t ref_max(uint32_t a, uint32_t b)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 4; i++) {
+        uint32_t x = byte_of(a, i), y = byte_of(b, i);
+        r |= (x > y ? x : y) << (8 * i);
+    }
+    return r;
+}
+
+uint32_t ref_min(uint32_t a, uint32_t b)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 4; i++) {
+        uint32_t x = byte_of(a, i), y = byte_of(b, i);
+        r |= (x < y ? x : y) << (8 * i);
+    }
+    return r;
+}
+
+uint32_t ref_blend(uint32_t from, uint32_t to, uint32_t alpha)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 4; i++) {
+        r |= ((byte_of(to, i) * alpha + byte_of(from, i) * (256 - alpha)) >> 8) << (8 * i);
+    }
+    return r;
+}
+
+uint32_t ref_power_acc(uint32_t acc, uint32_t v, uint32_t w02, uint32_t w13)
+{
+    uint32_t w[4] = {w02 & 0xffff, w13 & 0xffff, w02 >> 16, w13 >> 16};
+    for (int i = 0; i < 4; i++) acc += byte_of(v, i) * w[i];
+    return acc;
+}
+
+//! xorshift32
+static uint32_t next_random(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+//! 一半是亂數，一半是 0x00 / 0x7f / 0x80 / 0xff 這類邊界值的組合
+static uint32_t test_value(uint32_t *state)
+{
+    static const uint8_t edges[] = {0x00, 0x01, 0x7f, 0x80, 0x81, 0xfe, 0xff};
+    uint32_t r = next_random(state);
+    if (r & 1) return next_random(state);
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t) edges[(r >> (4 + 3 * i)) % sizeof(edges)] << (8 * i);
+    return v;
+}
+
+#define CHECK(name, got, want) do { \
+        uint32_t g_ = (got), w_ = (want); \
+        if (g_ != w_) { \
+            if (!errors) printf("%s mismatch: a=%08x b=%08x k=%u got %08x want %08x\n", \
+                                name, (unsigned) a, (unsigned) b, (unsigned) k, (unsigned) g_, (unsigned) w_); \
+            errors++; \
+        } \
+    } while (0)
+
+uint32_t pk_verify(uint32_t iterations)
+{
+    uint32_t state = 0x12345678;
+    uint32_t errors = 0;
+
+    for (uint32_t n = 0; n < iterations; n++) {
+        uint32_t a = test_value(&state);
+        uint32_t b = test_value(&state);
+        uint32_t k = next_random(&state) % 257;   // 0 ~ 256
+        uint32_t w02 = next_random(&state) & 0x7fff7fffu;
+        uint32_t w13 = next_random(&state) & 0x7fff7fffu;
+
+        CHECK("scale", pk_scale(a, k), ref_scale(a, k));
+        CHECK("gain", pk_gain(a, k), ref_gain(a, k));
+        CHECK("add_sat", pk_add_sat(a, b), ref_add_sat(a, b));
+        CHECK("max", pk_max(a, b), ref_max(a, b));
+        CHECK("min", pk_min(a, b), ref_min(a, b));
+        CHECK("blend", pk_blend(a, b, k), ref_blend(a, b, k));
+        CHECK("power", pk_power_acc(b, a, w02, w13), ref_power_acc(b, a, w02, w13));
+    }
+    return errors;
+}
+
+//! ws2812_parallel.c 原本的轉置寫法
+static void ref_planes(value_bits_t *out, const uint32_t *values, uint32_t num_strips)
+{
+    memset(out, 0, sizeof(*out));
+    for (uint32_t i = 0; i < num_strips; i++) {
+        uint32_t value = values[i];
+        for (int j = 0; j < VALUE_PLANE_COUNT && value; j++, value >>= 1u) {
+            if (value & 1u) out->planes[VALUE_PLANE_COUNT - 1 - j] |= 1u << i;
+        }
+    }
+}
+
+uint32_t planes_verify(uint32_t iterations)
+{
+    uint32_t state = 0x9e3779b9;
+    uint32_t errors = 0;
+    uint32_t values[32];
+    value_bits_t want, got;
+
+    for (uint32_t n = 0; n < iterations; n++) {
+        uint32_t num_strips = 1 + next_random(&state) % 32;
+        for (uint32_t i = 0; i < 32; i++) values[i] = next_random(&state) & ((1u << VALUE_PLANE_COUNT) - 1);
+
+        ref_planes(&want, values, num_strips);
+        planes_from_values(&got, values, num_strips);
+        if (memcmp(&want, &got, sizeof(want))) {
+            if (!errors) printf("planes_from_values mismatch, %u strips\n", (unsigned) num_strips);
+            errors++;
+        }
+
+        ref_planes(&want, values, 2);
+        planes_from_values2(&got, values[0], values[1]);
+        if (memcmp(&want, &got, sizeof(want))) {
+            if (!errors) printf("planes_from_values2 mismatch: %03x %03x\n", (unsigned) values[0], (unsigned) values[1]);
+            errors++;
+        }
+    }
+    return errors;
+}
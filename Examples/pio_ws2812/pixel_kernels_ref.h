@@ -0,0 +1,28 @@
+/*!
+  \brief 像素運算核心的逐 byte 參考實作與比對
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#pragma once
+
+#include <stdint.h>
+
+//! @{ 逐 byte 的參考實作，跟 pixel_kernels.h 的同名核心結果必須逐 bit 相同
+uint32_t ref_scale(uint32_t v, uint32_t scale);
+uint32_t ref_gain(uint32_t v, uint32_t gain);
+uint32_t ref_add_sat(uint32_t a, uint32_t b);
+uint32_t ref_max(uint32_t a, uint32_t b);
+uint32_t ref_min(uint32_t a, uint32_t b);
+uint32_t ref_blend(uint32_t from, uint32_t to, uint32_t alpha);
+uint32_t ref_power_acc(uint32_t acc, uint32_t v, uint32_t w02, uint32_t w13);
+//! @}
+
+/*! 用亂數和邊界值比對所有核心
+  \return 不一致的次數，第一個不一致的會印出來
+ */
+uint32_t pk_verify(uint32_t iterations);
+
+/*! 比對 ws2812_planes.c 的轉置 (兩條燈的特化版本、一般版本) 與逐 bit 參考實作
+  \return 不一致的次數
+ */
+uint32_t planes_verify(uint32_t iterations);
@@ -0,0 +1,183 @@
+/*!
+  \brief 存在 AT24C256 的燈效場景 (scene) 庫
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <assert.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+
+#include "at24c256.h"
+#include "scene_bank.h"
+
+#define SCENE_MAGIC     0x5CE7  //<! 判斷場景庫是否已經格式化
+#define SCENE_VERSION   1
+
+#define SCENE_DIR_ADDR  (SCENE_BANK_ADDR + EEPROM_PAGE_SIZE)
+#define SCENE_DATA_ADDR (SCENE_DIR_ADDR + SCENE_MAX * sizeof(scene_dir_entry_t))
+
+static_assert(sizeof(scene_t) == EEPROM_PAGE_SIZE, "scene must fill exactly one page");
+static_assert(SCENE_DATA_ADDR % EEPROM_PAGE_SIZE == 0, "scenes must be page aligned");
+static_assert(SCENE_DATA_ADDR + SCENE_MAX * sizeof(scene_t) <= EEPROM_SIZE, "scene bank too large");
+
+//! 標頭
+typedef struct {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t max_scenes;
+    uint16_t scene_size;
+} scene_bank_header_t;
+
+//! 預讀狀態
+typedef enum {
+    PREFETCH_NONE,
+    PREFETCH_LOADING,
+    PREFETCH_READY,
+} prefetch_state_t;
+
+static scene_dir_entry_t directory[SCENE_MAX];  //<! RAM 裡的目錄
+static uint valid_count;
+
+static scene_t slots[2];        //<! 一個使用中，一個給預讀
+static uint active_slot;
+static prefetch_state_t prefetch_state = PREFETCH_NONE;
+static uint prefetch_index;
+
+static inline uint16_t scene_addr(uint index)
+{
+    return (uint16_t) (SCENE_DATA_ADDR + index * sizeof(scene_t));
+}
+
+//! CRC-16/CCITT
+static uint16_t scene_crc(const scene_t *scene)
+{
+    const uint8_t *p = (const uint8_t *) scene;
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < sizeof(scene_t); i++) {
+        crc ^= (uint16_t) p[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool scene_bank_init(void)
+{
+    scene_bank_header_t header;
+    valid_count = 0;
+    memset(directory, 0, sizeof(directory));
+
+    if (eeprom_read_buffer(SCENE_BANK_ADDR, (uint8_t *) &header, sizeof(header)) < 0) return false;
+    if (header.magic != SCENE_MAGIC || header.version != SCENE_VERSION ||
+        header.max_scenes != SCENE_MAX || header.scene_size != sizeof(scene_t)) {
+        return false;
+    }
+
+    if (eeprom_read_buffer(SCENE_DIR_ADDR, (uint8_t *) directory, sizeof(directory)) < 0) {
+        memset(directory, 0, sizeof(directory));
+        return false;
+    }
+    for (uint i = 0; i < SCENE_MAX; i++) {
+        if (scene_bank_valid(&directory[i])) valid_count++;
+    }
+    return true;
+}
+
+void scene_bank_format(void)
+{
+    scene_bank_header_t header = {
+        .magic = SCENE_MAGIC,
+        .version = SCENE_VERSION,
+        .max_scenes = SCENE_MAX,
+        .scene_size = sizeof(scene_t),
+    };
+    memset(directory, 0, sizeof(directory));
+    valid_count = 0;
+    eeprom_write_buffer(SCENE_DIR_ADDR, (const uint8_t *) directory, sizeof(directory));
+    // 標頭最後寫，中途斷電的話下次開機會再格式化一次
+    eeprom_write_buffer(SCENE_BANK_ADDR, (const uint8_t *) &header, sizeof(header));
+}
+
+bool scene_bank_store(uint index, const scene_t *scene)
+{
+    if (index >= SCENE_MAX) return false;
+
+    scene_dir_entry_t entry = {
+        .effect = scene->effect,
+        .flags = SCENE_VALID,
+        .crc = scene_crc(scene),
+    };
+    eeprom_write_buffer(scene_addr(index), (const uint8_t *) scene, sizeof(scene_t));
+    eeprom_write_buffer(SCENE_DIR_ADDR + index * sizeof(entry), (const uint8_t *) &entry, sizeof(entry));
+
+    if (!scene_bank_valid(&directory[index])) valid_count++;
+    directory[index] = entry;
+    return true;
+}
+
+uint scene_bank_count(void)
+{
+    return valid_count;
+}
+
+uint scene_bank_next_valid(uint index)
+{
+    if (!valid_count) return SCENE_MAX;
+    for (uint n = 0; n < SCENE_MAX; n++) {
+        uint i = (index + n) % SCENE_MAX;
+        if (scene_bank_valid(&directory[i])) return i;
+    }
+    return SCENE_MAX;
+}
+
+const scene_dir_entry_t *scene_bank_entry(uint index)
+{
+    return index < SCENE_MAX ? &directory[index] : NULL;
+}
+
+bool scene_bank_prefetch(uint index)
+{
+    if (index >= SCENE_MAX || !scene_bank_valid(&directory[index])) return false;
+    if (prefetch_state == PREFETCH_LOADING) return false;
+
+    if (!eeprom_read_async(scene_addr(index), (uint8_t *) &slots[active_slot ^ 1], sizeof(scene_t))) {
+        return false;
+    }
+    prefetch_index = index;
+    prefetch_state = PREFETCH_LOADING;
+    return true;
+}
+
+bool scene_bank_poll(void)
+{
+    if (prefetch_state != PREFETCH_LOADING) return prefetch_state == PREFETCH_READY;
+
+    switch (eeprom_async_poll()) {
+        case EEPROM_ASYNC_DONE:
+            // CRC 不符就當作沒讀到，呼叫端會繼續用目前的場景
+            if (scene_crc(&slots[active_slot ^ 1]) == directory[prefetch_index].crc) {
+                prefetch_state = PREFETCH_READY;
+            } else {
+                prefetch_state = PREFETCH_NONE;
+            }
+            break;
+        case EEPROM_ASYNC_ERROR:
+            prefetch_state = PREFETCH_NONE;
+            break;
+        default:
+            break;
+    }
+    return prefetch_state == PREFETCH_READY;
+}
+
+const scene_t *scene_bank_activate(void)
+{
+    if (!scene_bank_poll()) return NULL;
+
+    active_slot ^= 1;
+    prefetch_state = PREFETCH_NONE;
+    return &slots[active_slot];
+}
@@ -0,0 +1,84 @@
+/*!
+  \brief 存在 AT24C256 的燈效場景 (scene) 庫
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  EEPROM 配置 (0x0000 ~ 0x03FF 保留給 SystemSettings 等其他資料)：
+  - SCENE_BANK_ADDR：標頭 (1 頁)
+  - 接著是目錄：每個場景 4 bytes (燈效、旗標、CRC)，開機時一次讀進 RAM
+  - 接著是場景本體：每個場景剛好 1 頁 (64 bytes)，寫入時一次頁寫入就完成
+
+  切換場景分兩步：
+  - scene_bank_prefetch() 用 DMA 非同步把場景讀進備用的 RAM 槽，不會卡住 LED 輸出
+  - 讀完之後 scene_bank_activate() 只是交換指標，在一個 frame 內就能完成
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define SCENE_BANK_ADDR     0x0400  //<! 場景庫在 EEPROM 的起始位址
+#define SCENE_MAX           448     //<! 最多幾個場景
+#define SCENE_PALETTE_SIZE  12      //<! 每個場景的調色盤顏色數
+
+//! 一個場景，剛好 64 bytes (一頁)
+typedef struct {
+    uint8_t effect;             //<! 燈效編號
+    int8_t speed;               //<! 動畫速度，正負表示方向，0 表示靜止
+    uint8_t brightness;         //<! 亮度 (256 = 1.0 時的高 8 位元，0 表示預設)
+    uint8_t transition;         //<! 切換到這個場景時的轉場種類
+    uint16_t transition_ms;     //<! 轉場時間，0 表示預設
+    uint8_t reserved[2];
+    uint8_t params[8];          //<! 燈效自己的參數
+    uint32_t palette[SCENE_PALETTE_SIZE]; //<! 調色盤 (線上格式 GRB << 8)
+} scene_t;
+
+//! 目錄項目
+typedef struct {
+    uint8_t effect;
+    uint8_t flags;              //<! SCENE_VALID
+    uint16_t crc;               //<! 場景本體的 CRC-16
+} scene_dir_entry_t;
+
+#define SCENE_VALID 0x01
+
+/*! 讀取標頭和目錄 (阻塞式，開機時呼叫一次)
+  \note I2C 和 eeprom_init() 要先設定好
+  \return EEPROM 沒回應或場景庫還沒格式化時回傳 false
+ */
+bool scene_bank_init(void);
+
+//! 清空場景庫並寫入新的標頭 (阻塞式)
+void scene_bank_format(void);
+
+/*! 儲存一個場景 (阻塞式，會同時更新目錄)
+  \return index 超出範圍時回傳 false
+ */
+bool scene_bank_store(uint index, const scene_t *scene);
+
+//! 有效場景數量
+uint scene_bank_count(void);
+
+//! 從 index 開始往後找下一個有效場景 (會繞回開頭)，沒有時回傳 SCENE_MAX
+uint scene_bank_next_valid(uint index);
+
+//! 從目錄查詢場景的燈效編號，不需要讀 EEPROM
+static inline bool scene_bank_valid(const scene_dir_entry_t *entry)
+{
+    return entry->flags & SCENE_VALID;
+}
+
+//! 取得目錄項目
+const scene_dir_entry_t *scene_bank_entry(uint index);
+
+/*! 開始把場景預先讀進備用槽
+  \return EEPROM 忙碌中或場景無效時回傳 false
+ */
+bool scene_bank_prefetch(uint index);
+
+//! 推進預讀狀態，每個 frame 呼叫一次，預讀的場景已經可以使用時回傳 true
+bool scene_bank_poll(void);
+
+/*! 啟用預讀好的場景
+  \return 還沒讀完、讀取失敗或 CRC 錯誤時回傳 NULL，呼叫端繼續用目前的場景
+ */
+const scene_t *scene_bank_activate(void);
@@ -0,0 +1,156 @@
+/*!
+  \brief 區段 (span) 輸出範例
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  Snakes 與 Sparkles 用 span 描述，畫面內容太雜 (span 清單放不下) 時
+  退回一般的像素緩衝區，整個畫面變成一個像素 span。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "ws2812.pio.h"
+
+#include "ws2812_spans.h"
+
+#define NUM_PIXELS  300     //<! 燈珠數量
+#define WS2812_PIN  16      //<! 連接到 WS2812 的 GPIO 腳位
+
+static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b)
+{
+    return
+            ((uint32_t) (r) << 8) |
+            ((uint32_t) (g) << 16) |
+            (uint32_t) (b);
+}
+
+static ws2812_span_list_t spans;
+static uint32_t fallback[NUM_PIXELS];   //<! 內容太雜時使用的像素緩衝區
+
+//! pattern_snakes 的 span 版本：每 64 顆是一個週期，每個週期最多 7 個 span
+static bool pattern_snakes(ws2812_span_list_t *list, uint start, uint len, uint t)
+{
+    static const struct {
+        uint end;
+        uint8_t r, g, b;
+    } runs[] = {
+        {10, 0xff, 0, 0}, {15, 0, 0, 0}, {25, 0, 0xff, 0}, {30, 0, 0, 0},
+        {40, 0, 0, 0xff}, {64, 0, 0, 0},
+    };
+
+    uint i = 0;
+    while (i < len) {
+        uint x = (start + i + (t >> 1)) % 64;
+        uint r = 0;
+        while (x >= runs[r].end) r++;
+        uint n = MIN(runs[r].end - x, len - i);
+        if (!ws2812_spans_solid(list, urgb_u32(runs[r].r, runs[r].g, runs[r].b) << 8u, n)) return false;
+        i += n;
+    }
+    return true;
+}
+
+//! 偶爾才有亮點，span 數量和亮點數量成正比
+static bool pattern_sparkle(ws2812_span_list_t *list, uint start, uint len, uint t)
+{
+    (void) start;
+    (void) t;
+    for (uint i = 0; i < len; ++i) {
+        uint32_t c = rand() % 64 ? 0 : 0xffffff00u;
+        if (!ws2812_spans_solid(list, c, 1)) return false;
+    }
+    return true;
+}
+
+static bool pattern_random(ws2812_span_list_t *list, uint start, uint len, uint t)
+{
+    (void) start;
+    (void) t;
+    for (uint i = 0; i < len; ++i) {
+        if (!ws2812_spans_solid(list, (uint32_t) rand() << 8u, 1)) return false;
+    }
+    return true;
+}
+
+/*! 產生燈條上 start ~ start + len - 1 這一段的 span
+  \return span 清單放不下時回傳 false
+ */
+typedef bool (*span_pattern)(ws2812_span_list_t *list, uint start, uint len, uint t);
+const struct {
+    span_pattern pat;
+    const char *name;
+} pattern_table[] = {
+        {pattern_snakes,  "Snakes!"},
+        {pattern_sparkle, "Sparkles"},
+        {pattern_random,  "Random data"},
+};
+
+/*! 用備援緩衝區重畫：把 span 清單展開成像素
+  \return 分批產生仍然失敗 (或沒有產生任何像素) 時回傳 false，這個畫面不要輸出
+ */
+static bool render_fallback(span_pattern pat, uint len, uint t)
+{
+    static ws2812_span_list_t probe;
+    uint i = 0;
+
+    // 分批產生 span 再展開，直到整條都畫完
+    while (i < len) {
+        uint n = MIN(WS2812_MAX_SPANS, len - i);
+        uint start = i;
+        ws2812_spans_begin(&probe);
+        if (!pat(&probe, i, n, t)) return false;
+        for (uint s = 0; s < probe.count && i < len; s++) {
+            for (uint k = 0; k < probe.cb[s].trans_count && i < len; k++) {
+                fallback[i++] = probe.color[s];
+            }
+        }
+        if (i == start) return false;
+    }
+    ws2812_spans_begin(&spans);
+    return ws2812_spans_pixels(&spans, fallback, len);
+}
+
+int main()
+{
+    stdio_init_all();
+    printf("WS2812 spans, using pin %d\n", WS2812_PIN);
+
+    PIO pio;
+    uint sm;
+    uint offset;
+    bool success = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_program, &pio, &sm, &offset, WS2812_PIN, 1, true);
+    hard_assert(success);
+    ws2812_program_init(pio, sm, offset, WS2812_PIN, 800000, false);
+
+    ws2812_spans_init(pio, sm);
+
+    uint t = 0;
+    while (true) {
+        int pat = rand() % count_of(pattern_table);
+        uint fallbacks = 0, max_spans = 0;
+        puts(pattern_table[pat].name);
+
+        for (int i = 0; i < 500; ++i) {
+            // 上一個畫面可能還在用 spans
+            ws2812_spans_wait();
+            ws2812_spans_begin(&spans);
+            bool ok = pattern_table[pat].pat(&spans, 0, NUM_PIXELS, t);
+            if (!ok) {
+                ok = render_fallback(pattern_table[pat].pat, NUM_PIXELS, t);
+                fallbacks++;
+            }
+            // 備援也失敗就保留上一個畫面
+            if (ok) {
+                max_spans = MAX(max_spans, spans.count);
+                ws2812_spans_output(&spans);
+            }
+            sleep_ms(10);
+            t++;
+        }
+        printf("  max %u spans (%u bytes), %u frames used the %u byte fallback\n",
+               max_spans, max_spans * (uint) (sizeof(ws2812_span_cb_t) + sizeof(uint32_t)),
+               fallbacks, (uint) sizeof(fallback));
+    }
+}
@@ -0,0 +1,79 @@
+/*!
+  \brief 即時輸出範例：2000 顆燈，沒有畫面緩衝區
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  環狀緩衝區只有 WS2812_STREAM_CHUNKS * WS2812_STREAM_CHUNK_PIXELS * 4 bytes，
+  燈的數量再多也一樣，限制只剩下每個畫面的傳輸時間 (2000 顆約 60 ms)。
+ */
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "ws2812.pio.h"
+
+#include "ws2812_stream.h"
+
+#define NUM_PIXELS  2000    //<! 燈珠數量
+#define WS2812_PIN  16      //<! 連接到 WS2812 的 GPIO 腳位
+
+static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b)
+{
+    return
+            ((uint32_t) (r) << 8) |
+            ((uint32_t) (g) << 16) |
+            (uint32_t) (b);
+}
+
+//! 與 pattern_snakes 相同的圖案，但是直接算出某一段像素，不需要整條的緩衝區
+static void render_snakes(uint32_t *out, uint first, uint count, void *ctx)
+{
+    uint t = *(const uint *) ctx;
+    for (uint i = 0; i < count; ++i) {
+        uint x = (first + i + (t >> 1)) % 64;
+        uint32_t c;
+        if (x < 10)
+            c = urgb_u32(0x20, 0, 0);
+        else if (x >= 15 && x < 25)
+            c = urgb_u32(0, 0x20, 0);
+        else if (x >= 30 && x < 40)
+            c = urgb_u32(0, 0, 0x20);
+        else
+            c = 0;
+        out[i] = c << 8u;
+    }
+}
+
+int main()
+{
+    stdio_init_all();
+    printf("WS2812 just-in-time stream, %d pixels on pin %d\n", NUM_PIXELS, WS2812_PIN);
+
+    PIO pio;
+    uint sm;
+    uint offset;
+    bool success = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_program, &pio, &sm, &offset, WS2812_PIN, 1, true);
+    hard_assert(success);
+    ws2812_program_init(pio, sm, offset, WS2812_PIN, 800000, false);
+
+    ws2812_stream_init(pio, sm);
+
+    uint t = 0;
+    while (true) {
+        ws2812_stream_start(NUM_PIXELS, render_snakes, &t);
+        while (!ws2812_stream_poll()) {
+            tight_loop_contents();
+        }
+        while (!ws2812_stream_done()) {
+            tight_loop_contents();
+        }
+        sleep_us(400);  // reset
+
+        if (++t % 100 == 0) {
+            ws2812_stream_stats_t s;
+            ws2812_stream_get_stats(&s, true);
+            printf("frames %u chunks %u underruns %u min slack %d render max %u us\n",
+                   (uint) s.frames, (uint) s.chunks, (uint) s.underruns, (int) s.min_slack, (uint) s.render_us_max);
+        }
+    }
+}
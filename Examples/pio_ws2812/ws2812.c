@@ -6,11 +6,16 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "pico/stdlib.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "ws2812.pio.h"
+#include "anim_clock.h"
+#include "bench.h"
+#include "clock_notify.h"
+#include "shell.h"
 
 /** 確認你的 WS2812 是 RGB 還是 RGBW 版本
  * 
@@ -30,6 +35,9 @@
 #define IS_RGBW false   //<! 設定為 true 如果你的 WS2812 是 RGBW 版本
 #define NUM_PIXELS 4    //<! 你的 WS2812 燈珠數量
 #define WS2812_PIN 16   //<! 連接到 WS2812 的 GPIO 腳位
+#define ANIM_RATE 100           //<! 動畫速度，每秒幾個 t 單位 (原本 10ms 一個 frame)
+#define PATTERN_US 10000000     //<! 每個燈效播放 10 秒
+#define BENCH_ITERS 21
 
 static inline void put_pixel(PIO pio, uint sm, uint32_t pixel_grb) 
 {
@@ -68,20 +76,19 @@ void pattern_snakes(PIO pio, uint sm, uint len, uint t)
     }
 }
 
+// 每 8 個 t 單位換一次內容，同一段時間內畫出來的結果相同
 void pattern_random(PIO pio, uint sm, uint len, uint t) 
 {
-    if (t % 8)
-        return;
+    uint32_t seed = anim_hash(t >> 3);
     for (uint i = 0; i < len; ++i)
-        put_pixel(pio, sm, rand());
+        put_pixel(pio, sm, anim_hash(seed + i));
 }
 
 void pattern_sparkle(PIO pio, uint sm, uint len, uint t)
 {
-    if (t % 8)
-        return;
+    uint32_t seed = anim_hash(t >> 3);
     for (uint i = 0; i < len; ++i)
-        put_pixel(pio, sm, rand() % 16 ? 0 : 0xffffffff);
+        put_pixel(pio, sm, anim_hash(seed + i) % 16 ? 0 : 0xffffffff);
 }
 
 void pattern_greys(PIO pio, uint sm, uint len, uint t)
@@ -106,16 +113,98 @@ const struct {
         {pattern_greys,   "Greys"},
 };
 
+// ----------------------------------------------------------------------------
+// 指令列：上面的 #define 是開機的預設值，執行中可以用 set 調整
+
+static PIO pio;
+static uint sm;
+static uint offset;
+
+static uint num_pixels = NUM_PIXELS;
+static uint ws2812_pin = WS2812_PIN;
+static int anim_rate = ANIM_RATE;
+static int pattern_lock = -1;
+static uint pattern_s = PATTERN_US / 1000000;
+
+static anim_phase_t phase;
+static int dir = 1;
+
+//! 每個 frame 的統計 (stats 指令)
+static uint32_t frames;
+static uint32_t frame_us_last;
+static uint32_t frame_us_max;
+
+//! 把狀態機的輸出換到新的腳位，原本的腳位恢復成 GPIO 輸入
+static bool apply_pin(const shell_param_t *p)
+{
+    static uint current = WS2812_PIN;
+    // pico2_w 的 GPIO 23 ~ 25 接到 CYW43
+    if (ws2812_pin >= 23 && ws2812_pin <= 25) return false;
+    // 同一個腳位不用換 (gpio_init 會把正在用的腳位變回 GPIO 輸入)
+    if (ws2812_pin == current) return true;
+    pio_sm_set_enabled(pio, sm, false);
+    pio_gpio_init(pio, ws2812_pin);
+    pio_sm_set_consecutive_pindirs(pio, sm, ws2812_pin, 1, true);
+    pio_sm_set_sideset_pins(pio, sm, ws2812_pin);
+    pio_sm_set_enabled(pio, sm, true);
+    gpio_init(current);
+    current = ws2812_pin;
+    return true;
+}
+
+static bool apply_rate(const shell_param_t *p)
+{
+    anim_phase_set_rate(&phase, dir * anim_rate);
+    return true;
+}
+
+static const shell_param_t params[] = {
+        SHELL_PARAM("pixels",  num_pixels,   1, 1024, NULL,       "燈數 (NUM_PIXELS)"),
+        SHELL_PARAM("pin",     ws2812_pin,   0, 28,   apply_pin,  "輸出腳位 (WS2812_PIN)"),
+        SHELL_PARAM("rate",    anim_rate,    1, 1000, apply_rate, "動畫速度，每秒幾個 t (ANIM_RATE)"),
+        SHELL_PARAM("pattern", pattern_lock, -1, count_of(pattern_table) - 1, NULL, "固定燈效，-1 輪流"),
+        SHELL_PARAM("period",  pattern_s,    1, 3600, NULL,       "每個燈效播放幾秒 (PATTERN_US)"),
+};
+
+static int cmd_stats(int argc, char **argv)
+{
+    printf("clk_sys      %u MHz\n", (uint) (clock_get_hz(clk_sys) / 1000000));
+    printf("frames       %u\n", (uint) frames);
+    printf("frame        %u us (max %u us)\n", (uint) frame_us_last, (uint) frame_us_max);
+    if (argc > 1 && !strcmp(argv[1], "reset")) frame_us_max = 0;
+    return 0;
+}
+
+static void bench_frame(void *ctx)
+{
+    pattern_table[(uintptr_t) ctx].pat(pio, sm, num_pixels, frames);
+}
+
+/*! 目前的燈數下每個燈效畫一個 frame 要多久 (包含等 PIO FIFO)
+  1024 顆時一個 frame 要等 FIFO 約 30 ms，不能關中斷 (USB CDC 會斷線)，所以用 BENCH_CASE_IRQS_ON
+ */
+static int cmd_bench(int argc, char **argv)
+{
+    bench_case_t cases[count_of(pattern_table)];
+    for (uint i = 0; i < count_of(pattern_table); i++) {
+        cases[i] = (bench_case_t) BENCH_CASE_IRQS_ON(pattern_table[i].name, bench_frame, (void *) (uintptr_t) i,
+                                                     BENCH_ITERS);
+    }
+    bench_run_all("pio_ws2812", cases, count_of(cases), BENCH_ITERS);
+    return 0;
+}
+
+static const shell_cmd_t cmds[] = {
+        {"stats", cmd_stats, "[reset] 每個 frame 的時間"},
+        {"bench", cmd_bench, "量測每個燈效一個 frame 的週期數"},
+};
+
 int main() 
 {
     stdio_init_all();
 
     printf("WS2812 Smoke Test, using pin %d\n", WS2812_PIN);
 
-    PIO pio;
-    uint sm;
-    uint offset;
-
     // This will find a free pio and state machine for our program and load it for us
     // We use pio_claim_free_sm_and_add_program_for_gpio_range (for_gpio_range variant)
     // so we will get a PIO instance suitable for addressing gpios >= 32 if needed and supported by the hardware
@@ -123,18 +212,33 @@ int main()
     hard_assert(success);
 
     ws2812_program_init(pio, sm, offset, WS2812_PIN, 800000, IS_RGBW);
+    // 系統主頻改變時 (clock_notify_set_sys_khz) 自動重新計算分頻，維持 800 kHz
+    clock_notify_pio_sm(pio, sm, 800000.f * (ws2812_T1 + ws2812_T2 + ws2812_T3));
+
+    shell_init("WS2812 Smoke Test", params, count_of(params), cmds, count_of(cmds));
 
-    int t = 0;
+    anim_clock_t clock;
+    anim_clock_init(&clock, 0);
     while (1) 
     {
-        int pat = rand() % count_of(pattern_table);
-        int dir = (rand() >> 30) & 1 ? 1 : -1;
-        puts(pattern_table[pat].name);
-        puts(dir == 1 ? "(forward)" : "(backward)");
-        for (int i = 0; i < 1000; ++i) {
-            pattern_table[pat].pat(pio, sm, NUM_PIXELS, t);
+        int pat = pattern_lock >= 0 ? pattern_lock : (int) (rand() % count_of(pattern_table));
+        dir = (rand() >> 30) & 1 ? 1 : -1;
+        // 每個燈效只印一次，不在熱迴圈裡；USB 序列埠是 shell 的文字介面，不能送 DLOG 的二進位封包
+        printf("%s %s\n", pattern_table[pat].name, dir == 1 ? "(forward)" : "(backward)");
+        // t 跟著實際時間走，frame rate 或燈數改變都不影響動畫速度
+        anim_phase_set_rate(&phase, dir * anim_rate);
+        uint64_t start = clock.now_us;
+        while (clock.now_us - start < (uint64_t) pattern_s * 1000000) {
+            uint t = anim_phase_advance(&phase, anim_clock_tick(&clock));
+            uint32_t t0 = time_us_32();
+            pattern_table[pat].pat(pio, sm, num_pixels, t);
+            frame_us_last = time_us_32() - t0;
+            frame_us_max = MAX(frame_us_max, frame_us_last);
+            frames++;
+            shell_poll();
+            // 用 set pattern 換燈效時立即切換
+            if (pattern_lock >= 0 && pattern_lock != pat) break;
             sleep_ms(10);
-            t += dir;
         }
     }
 
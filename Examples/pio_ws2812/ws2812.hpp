@@ -0,0 +1,147 @@
+/*!
+  \brief ws2812.pio 的 C++ 包裝：腳位、速率、格式都是模板參數
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  跟 ws2812_program_init() 做一樣的事，差別是分頻在編譯時算好，
+  而且 T0H / T1H / 低電位時間超出 WS2812 的規格會直接編譯失敗：
+
+    ws2812<2> strip;                            // GPIO 2，800 kHz，GRB
+    strip.init(pio, sm, offset);
+    strip.put(strip.rgb(0xff, 0, 0));
+
+  成員只有 pio 與 sm，put() 展開後就是 pio_sm_put_blocking()，
+  跟 ws2812.c 的 put_pixel() 產生一樣的程式碼。
+
+  \note 系統主頻預設是 SYS_CLK_HZ；會用 clock_notify 改主頻的程式請改用 C 的版本
+ */
+#pragma once
+
+#include "pio_clkdiv.hpp"
+#include "hardware/pio.h"
+#include "ws2812.pio.h"
+
+// 規格的交集 (WS2812 / WS2812B / SK6812)，單位 ns
+#define WS2812_T0H_MIN_NS   200
+#define WS2812_T0H_MAX_NS   500
+#define WS2812_T1H_MIN_NS   550
+#define WS2812_T1H_MAX_NS   1000
+#define WS2812_TL_MIN_NS    450     //<! 0 與 1 的低電位時間都要超過
+
+enum class ws2812_format {
+    grb,        //<! 24 bits
+    grbw,       //<! 32 bits (SK6812 RGBW)
+};
+
+/*! 一個 bit 分成 T1 + T2 + T3 個狀態機週期：前 T1 一定是高電位，T2 依資料決定，T3 一定是低電位
+  實際時間用取整之後的分頻計算
+ */
+template <uint32_t SysHz, uint32_t BitHz, uint T1, uint T2, uint T3>
+struct ws2812_timing {
+    static constexpr uint cycles_per_bit = T1 + T2 + T3;
+    using div = pio_clkdiv<SysHz, (uint64_t) BitHz * cycles_per_bit>;
+
+    static constexpr double ns_per_cycle = 1e9 / div::actual_hz;
+    static constexpr double t0h_ns = T1 * ns_per_cycle;
+    static constexpr double t1h_ns = (T1 + T2) * ns_per_cycle;
+    static constexpr double t0l_ns = (T2 + T3) * ns_per_cycle;
+    static constexpr double t1l_ns = T3 * ns_per_cycle;
+
+    static_assert(t0h_ns >= WS2812_T0H_MIN_NS && t0h_ns <= WS2812_T0H_MAX_NS, "T0H out of WS2812 spec, check BitHz");
+    static_assert(t1h_ns >= WS2812_T1H_MIN_NS && t1h_ns <= WS2812_T1H_MAX_NS, "T1H out of WS2812 spec, check BitHz");
+    static_assert(t0l_ns >= WS2812_TL_MIN_NS && t1l_ns >= WS2812_TL_MIN_NS, "low time too short, check BitHz");
+};
+
+template <uint Pin, uint32_t BitHz = 800000, ws2812_format Format = ws2812_format::grb, uint32_t SysHz = SYS_CLK_HZ>
+class ws2812 {
+    static_assert(Pin < NUM_BANK0_GPIOS, "no such GPIO");
+
+public:
+    using timing = ws2812_timing<SysHz, BitHz, ws2812_T1, ws2812_T2, ws2812_T3>;
+    static constexpr uint bits = Format == ws2812_format::grbw ? 32 : 24;
+
+    //! 設定並啟動狀態機 (程式已經用 pio_add_program() 載入到 offset)
+    void init(PIO p, uint state_machine, uint offset)
+    {
+        pio_assert_sys_hz<SysHz>();
+        pio = p;
+        sm = state_machine;
+
+        pio_gpio_init(pio, Pin);
+        pio_sm_set_consecutive_pindirs(pio, sm, Pin, 1, true);
+
+        pio_sm_config c = ws2812_program_get_default_config(offset);
+        sm_config_set_sideset_pins(&c, Pin);
+        sm_config_set_out_shift(&c, false, true, bits);
+        sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+        sm_config_set_clkdiv_int_frac8(&c, timing::div::int_part, timing::div::frac_part);
+
+        pio_sm_init(pio, sm, offset, &c);
+        pio_sm_set_enabled(pio, sm, true);
+    }
+
+    //! 送出一個像素 (rgb() / rgbw() 的結果)，FIFO 滿的時候等待
+    void put(uint32_t pixel) const
+    {
+        // 左移輸出，24 bits 的資料要放在最高的 3 個 bytes
+        pio_sm_put_blocking(pio, sm, Format == ws2812_format::grbw ? pixel : pixel << 8u);
+    }
+
+    static constexpr uint32_t rgb(uint8_t r, uint8_t g, uint8_t b)
+    {
+        if constexpr (Format == ws2812_format::grbw) {
+            return ((uint32_t) g << 24) | ((uint32_t) r << 16) | ((uint32_t) b << 8);
+        } else {
+            return ((uint32_t) r << 8) | ((uint32_t) g << 16) | (uint32_t) b;
+        }
+    }
+
+    static constexpr uint32_t rgbw(uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+    {
+        static_assert(Format == ws2812_format::grbw, "rgbw() needs ws2812_format::grbw");
+        return ((uint32_t) g << 24) | ((uint32_t) r << 16) | ((uint32_t) b << 8) | w;
+    }
+
+private:
+    PIO pio = nullptr;
+    uint sm = 0;
+};
+
+//! ws2812_parallel 程式：PinBase 開始的 PinCount 條燈條同時輸出，每個字是每條燈條各一個 bit
+template <uint PinBase, uint PinCount, uint32_t BitHz = 800000, uint32_t SysHz = SYS_CLK_HZ>
+class ws2812_parallel {
+    static_assert(PinCount >= 1 && PinCount <= 32, "1 to 32 strips");
+    static_assert(PinBase + PinCount <= NUM_BANK0_GPIOS, "no such GPIO");
+
+public:
+    using timing = ws2812_timing<SysHz, BitHz, ws2812_parallel_T1, ws2812_parallel_T2, ws2812_parallel_T3>;
+
+    void init(PIO p, uint state_machine, uint offset)
+    {
+        pio_assert_sys_hz<SysHz>();
+        pio = p;
+        sm = state_machine;
+
+        for (uint i = PinBase; i < PinBase + PinCount; i++) pio_gpio_init(pio, i);
+        pio_sm_set_consecutive_pindirs(pio, sm, PinBase, PinCount, true);
+
+        pio_sm_config c = ws2812_parallel_program_get_default_config(offset);
+        sm_config_set_out_shift(&c, true, true, 32);
+        sm_config_set_out_pins(&c, PinBase, PinCount);
+        sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+        sm_config_set_clkdiv_int_frac8(&c, timing::div::int_part, timing::div::frac_part);
+
+        pio_sm_init(pio, sm, offset, &c);
+        pio_sm_set_enabled(pio, sm, true);
+    }
+
+    //! 送出一個 bit 平面 (bit n 是第 n 條燈條)
+    void put(uint32_t plane) const
+    {
+        pio_sm_put_blocking(pio, sm, plane);
+    }
+
+private:
+    PIO pio = nullptr;
+    uint sm = 0;
+};
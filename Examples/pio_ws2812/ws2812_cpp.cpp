@@ -0,0 +1,50 @@
+/*!
+  \brief ws2812.c 的 C++ 版本：用 ws2812.hpp 在編譯時決定腳位、速率與格式
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  把 BIT_HZ 改成 400000 試試看：T0H 變成 750 ns，超出 WS2812 的規格，編譯時就會失敗。
+ */
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "ws2812.hpp"
+
+#define NUM_PIXELS  4           //<! 你的 WS2812 燈珠數量
+#define WS2812_PIN  16          //<! 連接到 WS2812 的 GPIO 腳位
+#define BIT_HZ      800000      //<! 資料速率
+
+using strip_t = ws2812<WS2812_PIN, BIT_HZ, ws2812_format::grb>;
+static strip_t strip;
+
+//! 跑馬燈：每隔 3 顆亮一顆，t 決定顏色與位置
+static void pattern_chase(uint t)
+{
+    static constexpr uint32_t colors[] = {strip_t::rgb(0x20, 0, 0), strip_t::rgb(0, 0x20, 0), strip_t::rgb(0, 0, 0x20)};
+    for (uint i = 0; i < NUM_PIXELS; i++) {
+        strip.put((i + t) % 3 ? 0 : colors[(t / 32) % count_of(colors)]);
+    }
+}
+
+int main()
+{
+    stdio_init_all();
+
+    PIO pio;
+    uint sm;
+    uint offset;
+    bool rc = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_program, &pio, &sm, &offset, WS2812_PIN, 1, true);
+    hard_assert(rc);
+    strip.init(pio, sm, offset);
+
+    printf("WS2812 on pin %d: clkdiv %u + %u/256, T0H %.0f ns, T1H %.0f ns\n", WS2812_PIN,
+           (uint) strip_t::timing::div::int_part, (uint) strip_t::timing::div::frac_part,
+           strip_t::timing::t0h_ns, strip_t::timing::t1h_ns);
+
+    for (uint t = 0; ; t++) {
+        pattern_chase(t);
+        sleep_ms(20);
+    }
+}
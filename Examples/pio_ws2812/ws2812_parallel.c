@@ -13,182 +13,60 @@
 #include "hardware/pio.h"
 #include "hardware/dma.h"
 #include "hardware/irq.h"
+#include "hardware/i2c.h"
 #include "ws2812.pio.h"
+#include "led_transition.h"
+#include "anim_clock.h"
+#include "at24c256.h"
+#include "scene_bank.h"
+#include "ws2812_planes.h"
+#include "ws2812_patterns.h"
+#include "clock_notify.h"
+#include "clock_plan.h"
+#include "dlog.h"
+#include "idle.h"
 
-#define FRAC_BITS 4
-#define NUM_PIXELS 64
 #define WS2812_PIN_BASE 2
+// animation speed in t units per second (roughly the old speed of one unit per frame)
+#define ANIM_RATE 300
+// brightness ramp speed, one full ramp of 0x20 << FRAC_BITS every ~1.5s
+#define BRIGHTNESS_RATE 340
+// each pattern plays for PATTERN_MS, the last TRANSITION_MS of which blend into the next
+#define PATTERN_MS 3000
+#define TRANSITION_MS 400
+// cpu time available per frame, about the time it takes to clock out one frame
+#define FRAME_BUDGET_US 2500
+// scene speed that maps to ANIM_RATE
+#define SCENE_SPEED_UNITY 16
+// AT24C256 holding the scene bank, on the default I2C pins
+#define EEPROM_ADDRESS 0x50
+#define EEPROM_BAUDRATE 400000
+// clk_sys in kHz (e.g. 48000 to save power); the PIO, I2C and UART dividers are
+// recomputed by clock_notify so any achievable value is safe. 0 lets clock_plan pick
+// the fastest clock (up to the 150MHz nominal) where the PIO and I2C dividers are integers
+#ifndef SYS_CLOCK_KHZ
+#define SYS_CLOCK_KHZ 0
+#endif
 
 // Check the pin is compatible with the platform
 #if WS2812_PIN_BASE >= NUM_BANK0_GPIOS
 #error Attempting to use a pin>=32 on a platform that does not support it
 #endif
 
-// horrible temporary hack to avoid changing pattern code
-static uint8_t *current_strip_out;
-static bool current_strip_4color;
-
-static inline void put_pixel(uint32_t pixel_grb) {
-    *current_strip_out++ = (pixel_grb >> 16u) & 0xffu;
-    *current_strip_out++ = (pixel_grb >> 8u) & 0xffu;
-    *current_strip_out++ = pixel_grb & 0xffu;
-    if (current_strip_4color) {
-        *current_strip_out++ = 0;  // todo adjust?
-    }
-}
-
-static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b) {
-    return 
-            ((uint32_t) (r) << 8) |
-            ((uint32_t) (g) << 16) |
-            (uint32_t) (b);
-}
-
-void pattern_snakes(uint len, uint t) {
-    for (uint i = 0; i < len; ++i) {
-        uint x = (i + (t >> 1)) % 64;
-        if (x < 10)
-            put_pixel(urgb_u32(0xff, 0, 0));
-        else if (x >= 15 && x < 25)
-            put_pixel(urgb_u32(0, 0xff, 0));
-        else if (x >= 30 && x < 40)
-            put_pixel(urgb_u32(0, 0, 0xff));
-        else
-            put_pixel(0);
-    }
-}
-
-void pattern_random(uint len, uint t) {
-    if (t % 8)
-        return;
-    for (uint i = 0; i < len; ++i)
-        put_pixel(rand());
-}
-
-void pattern_sparkle(uint len, uint t) {
-    if (t % 8)
-        return;
-    for (uint i = 0; i < len; ++i)
-        put_pixel(rand() % 16 ? 0 : 0xffffffff);
-}
-
-void pattern_greys(uint len, uint t) {
-    uint max = 100; // let's not draw too much current!
-    t %= max;
-    for (uint i = 0; i < len; ++i) {
-        put_pixel(t * 0x10101);
-        if (++t >= max) t = 0;
-    }
-}
-
-void pattern_solid(uint len, uint t) {
-    t = 1;
-    for (uint i = 0; i < len; ++i) {
-        put_pixel(t * 0x10101);
-    }
-}
-
-int level = 8;
-
-void pattern_fade(uint len, uint t) {
-    uint shift = 4;
-
-    uint max = 16; // let's not draw too much current!
-    max <<= shift;
-
-    uint slow_t = t / 32;
-    slow_t = level;
-    slow_t %= max;
-
-    static int error = 0;
-    slow_t += error;
-    error = slow_t & ((1u << shift) - 1);
-    slow_t >>= shift;
-    slow_t *= 0x010101;
-
-    for (uint i = 0; i < len; ++i) {
-        put_pixel(slow_t);
-    }
-}
-
-typedef void (*pattern)(uint len, uint t);
-const struct {
-    pattern pat;
-    const char *name;
-} pattern_table[] = {
-        {pattern_snakes,  "Snakes!"},
-        {pattern_random,  "Random data"},
-        {pattern_sparkle, "Sparkles"},
-        {pattern_greys,   "Greys"},
-//        {pattern_solid,  "Solid!"},
-//        {pattern_fade, "Fade"},
-};
-
-#define VALUE_PLANE_COUNT (8 + FRAC_BITS)
-// we store value (8 bits + fractional bits of a single color (R/G/B/W) value) for multiple
-// strips of pixels, in bit planes. bit plane N has the Nth bit of each strip of pixels.
-typedef struct {
-    // stored MSB first
-    uint32_t planes[VALUE_PLANE_COUNT];
-} value_bits_t;
-
-// Add FRAC_BITS planes of e to s and store in d
-void add_error(value_bits_t *d, const value_bits_t *s, const value_bits_t *e) {
-    uint32_t carry_plane = 0;
-    // add the FRAC_BITS low planes
-    for (int p = VALUE_PLANE_COUNT - 1; p >= 8; p--) {
-        uint32_t e_plane = e->planes[p];
-        uint32_t s_plane = s->planes[p];
-        d->planes[p] = (e_plane ^ s_plane) ^ carry_plane;
-        carry_plane = (e_plane & s_plane) | (carry_plane & (s_plane ^ e_plane));
-    }
-    // then just ripple carry through the non fractional bits
-    for (int p = 7; p >= 0; p--) {
-        uint32_t s_plane = s->planes[p];
-        d->planes[p] = s_plane ^ carry_plane;
-        carry_plane &= s_plane;
-    }
-}
-
-typedef struct {
-    uint8_t *data;
-    uint data_len;
-    uint frac_brightness; // 256 = *1.0;
-} strip_t;
-
-// takes 8 bit color values, multiply by brightness and store in bit planes
-void transform_strips(strip_t **strips, uint num_strips, value_bits_t *values, uint value_length,
-                       uint frac_brightness) {
-    for (uint v = 0; v < value_length; v++) {
-        memset(&values[v], 0, sizeof(values[v]));
-        for (uint i = 0; i < num_strips; i++) {
-            if (v < strips[i]->data_len) {
-                // todo clamp?
-                uint32_t value = (strips[i]->data[v] * strips[i]->frac_brightness) >> 8u;
-                value = (value * frac_brightness) >> 8u;
-                for (int j = 0; j < VALUE_PLANE_COUNT && value; j++, value >>= 1u) {
-                    if (value & 1u) values[v].planes[VALUE_PLANE_COUNT - 1 - j] |= 1u << i;
-                }
-            }
-        }
-    }
-}
-
-void dither_values(const value_bits_t *colors, value_bits_t *state, const value_bits_t *old_state, uint value_length) {
-    for (uint i = 0; i < value_length; i++) {
-        add_error(state + i, colors + i, old_state + i);
-    }
-}
-
 // requested colors * 4 to allow for RGBW
 static value_bits_t colors[NUM_PIXELS * 4];
 // double buffer the state of the pixel strip, since we update next version in parallel with DMAing out old version
 static value_bits_t states[2][NUM_PIXELS * 4];
 
 // example - strip 0 is RGB only
-static uint8_t strip0_data[NUM_PIXELS * 3];
+static uint8_t strip0_data[NUM_PIXELS * 3] __attribute__((aligned(4)));
 // example - strip 1 is RGBW
-static uint8_t strip1_data[NUM_PIXELS * 4];
+static uint8_t strip1_data[NUM_PIXELS * 4] __attribute__((aligned(4)));
+
+// each pattern renders into its own layer; during a transition the two layers are
+// blended into stripN_data, otherwise the strips point straight at the current layer
+static uint8_t strip0_layers[2][NUM_PIXELS * 3] __attribute__((aligned(4)));
+static uint8_t strip1_layers[2][NUM_PIXELS * 4] __attribute__((aligned(4)));
 
 strip_t strip0 = {
         .data = strip0_data,
@@ -216,8 +94,12 @@ strip_t *strips[] = {
 #define DMA_CB_CHANNEL_MASK (1u << DMA_CB_CHANNEL)
 #define DMA_CHANNELS_MASK (DMA_CHANNEL_MASK | DMA_CB_CHANNEL_MASK)
 
-// start of each value fragment (+1 for NULL terminator)
-static uintptr_t fragment_start[NUM_PIXELS * 4 + 1];
+// start of each value fragment (+1 for NULL terminator), one list per state buffer.
+// the lists are built once by build_fragment_lists(), since states[0] and states[1]
+// never move; a frame is started by handing the chain channel one of the two lists
+static uintptr_t fragment_start[2][NUM_PIXELS * 4 + 1];
+// position of the NULL terminator in each list
+static uint fragment_length[2];
 
 // posted when it is safe to output a new set of values
 static struct semaphore reset_delay_complete_sem;
@@ -226,6 +108,7 @@ alarm_id_t reset_delay_alarm_id;
 
 int64_t reset_delay_complete(__unused alarm_id_t id, __unused void *user_data) {
     reset_delay_alarm_id = 0;
+    idle_notify();
     sem_release(&reset_delay_complete_sem);
     // no repeat
     return 0;
@@ -271,17 +154,135 @@ void dma_init(PIO pio, uint sm) {
     irq_set_enabled(DMA_IRQ_0, true);
 }
 
-void output_strips_dma(value_bits_t *bits, uint value_length) {
-    for (uint i = 0; i < value_length; i++) {
-        fragment_start[i] = (uintptr_t) bits[i].planes; // MSB first
+void build_fragment_lists(void) {
+    for (uint b = 0; b < 2; b++) {
+        for (uint i = 0; i < NUM_PIXELS * 4; i++) {
+            fragment_start[b][i] = (uintptr_t) states[b][i].planes; // MSB first
+        }
+        fragment_start[b][NUM_PIXELS * 4] = 0;
+        fragment_length[b] = NUM_PIXELS * 4;
+    }
+}
+
+// output states[buffer]; the per frame cost is O(1), a shorter value_length
+// (e.g. strips shorter than NUM_PIXELS) just moves the NULL terminator
+void output_strips_dma(uint buffer, uint value_length) {
+    uintptr_t *list = fragment_start[buffer];
+    uint old_length = fragment_length[buffer];
+    if (value_length > NUM_PIXELS * 4) value_length = NUM_PIXELS * 4;
+    if (value_length != old_length) {
+        if (old_length < NUM_PIXELS * 4) {
+            list[old_length] = (uintptr_t) states[buffer][old_length].planes;
+        }
+        list[value_length] = 0;
+        fragment_length[buffer] = value_length;
+    }
+    dma_channel_hw_addr(DMA_CB_CHANNEL)->al3_read_addr_trig = (uintptr_t) list;
+}
+
+
+// index of the scene being prefetched, SCENE_MAX when the bank is not in use
+static uint next_scene = SCENE_MAX;
+
+void scenes_init(void) {
+#if defined(i2c_default) && defined(PICO_DEFAULT_I2C_SDA_PIN) && defined(PICO_DEFAULT_I2C_SCL_PIN)
+    i2c_init(i2c_default, EEPROM_BAUDRATE);
+    gpio_set_function(PICO_DEFAULT_I2C_SDA_PIN, GPIO_FUNC_I2C);
+    gpio_set_function(PICO_DEFAULT_I2C_SCL_PIN, GPIO_FUNC_I2C);
+    gpio_pull_up(PICO_DEFAULT_I2C_SDA_PIN);
+    gpio_pull_up(PICO_DEFAULT_I2C_SCL_PIN);
+    clock_notify_i2c(i2c_default, EEPROM_BAUDRATE);
+    eeprom_init(i2c_default, EEPROM_ADDRESS);
+
+    if (!scene_bank_init()) {
+        uint8_t probe;
+        if (eeprom_read_buffer(SCENE_BANK_ADDR, &probe, 1) < 0) {
+            puts("No EEPROM, patterns are picked at random");
+            return;
+        }
+        // blank bank; store one scene per pattern and direction as a starting point
+        puts("Formatting scene bank");
+        scene_bank_format();
+        uint index = 0;
+        for (uint p = 0; p < count_of(pattern_table); p++) {
+            for (int dir = -1; dir <= 1; dir++) {
+                scene_t scene = {
+                    .effect = (uint8_t) p,
+                    .speed = (int8_t) (dir * SCENE_SPEED_UNITY),
+                    .transition = (uint8_t) (index % 3),
+                };
+                scene_bank_store(index++, &scene);
+            }
+        }
+    }
+    printf("%u scenes in bank\n", scene_bank_count());
+    next_scene = scene_bank_next_valid(0);
+    if (next_scene < SCENE_MAX) scene_bank_prefetch(next_scene);
+#endif
+}
+
+// pick the next pattern: the prefetched scene if it is ready, otherwise rand()
+int choose_pattern(anim_phase_t *phase, transition_kind_t *kind) {
+    int pat;
+    int speed;
+    const scene_t *scene = next_scene < SCENE_MAX ? scene_bank_activate() : NULL;
+    if (scene) {
+        DLOG("Scene %u:", next_scene);
+        pat = scene->effect % count_of(pattern_table);
+        speed = scene->speed * ANIM_RATE / SCENE_SPEED_UNITY;
+        *kind = (transition_kind_t) (scene->transition % 3);
+        // start reading the one after, it has a whole pattern period to arrive
+        next_scene = scene_bank_next_valid(next_scene + 1);
+        scene_bank_prefetch(next_scene);
+    } else {
+        int dir = (rand() >> 30) & 1 ? 1 : -1;
+        if (rand() & 1) dir = 0;
+        pat = rand() % count_of(pattern_table);
+        speed = dir * ANIM_RATE;
+        *kind = (transition_kind_t) (rand() % 3);
+        if (next_scene < SCENE_MAX) scene_bank_prefetch(next_scene); // retry after an error
+    }
+    DLOG("%s %s", pattern_table[pat].name, speed > 0 ? "(forward)" : speed ? "(backward)" : "(still)");
+    anim_phase_reset(phase);
+    anim_phase_set_rate(phase, speed);
+    return pat;
+}
+
+// render one pattern into both strips of the given layer
+void render_pattern(int pat, uint layer, uint t) {
+    pattern_render(pat, strip0_layers[layer], false, NUM_PIXELS, t);
+    pattern_render(pat, strip1_layers[layer], true, NUM_PIXELS, t);
+}
+
+void select_sys_clock(void) {
+    if (SYS_CLOCK_KHZ) {
+        if (!clock_notify_set_sys_khz(SYS_CLOCK_KHZ)) printf("clk_sys %u kHz is not achievable\n", (uint) SYS_CLOCK_KHZ);
+        return;
+    }
+    // a fractional divider makes the PIO stretch some cycles, i.e. one clk_sys of jitter per bit
+    clock_plan_req_t reqs[] = {
+            CLOCK_REQ_PIO("ws2812_parallel", 800000.0 * (ws2812_parallel_T1 + ws2812_parallel_T2 + ws2812_parallel_T3)),
+            CLOCK_REQ_I2C("eeprom", EEPROM_BAUDRATE),
+    };
+    clock_plan_limits_t limits = CLOCK_PLAN_LIMITS_DEFAULT;
+    clock_plan_t plan;
+    if (clock_plan_solve(reqs, count_of(reqs), &limits, &plan)) {
+        clock_notify_set_sys_pll(plan.vco_hz, plan.postdiv1, plan.postdiv2);
+        clock_plan_print(&plan, reqs, count_of(reqs));
     }
-    fragment_start[value_length] = 0;
-    dma_channel_hw_addr(DMA_CB_CHANNEL)->al3_read_addr_trig = (uintptr_t) fragment_start;
 }
 
+// time spent asleep waiting for the previous frame, and how long the alarm took to wake us
+void log_idle(void) {
+    idle_stats_t s;
+    idle_get_stats(&s);
+    uint idle_permille = s.run_us ? (uint) (s.idle_us[IDLE_WFE] * 1000 / s.run_us) : 0;
+    DLOG("idle %u/1000, wake avg %u us max %u us", idle_permille,
+         s.wakes ? (uint) (s.wake_us_sum / s.wakes) : 0u, (uint) s.wake_us_max);
+    idle_reset_stats();
+}
 
 int main() {
-    //set_sys_clock_48();
     stdio_init_all();
     printf("WS2812 parallel using pin %d\n", WS2812_PIN_BASE);
 
@@ -296,37 +297,93 @@ int main() {
     hard_assert(success);
 
     ws2812_parallel_program_init(pio, sm, offset, WS2812_PIN_BASE, count_of(strips), 800000);
+    clock_notify_pio_sm(pio, sm, 800000.f * (ws2812_parallel_T1 + ws2812_parallel_T2 + ws2812_parallel_T3));
+#if defined(uart_default)
+    clock_notify_uart(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+#endif
 
     sem_init(&reset_delay_complete_sem, 1, 1); // initially posted so we don't block first time
+    // the wait for the reset delay sleeps in WFE; the alarm callback wakes it
+    idle_init(IDLE_WFE);
     dma_init(pio, sm);
-    int t = 0;
+    build_fragment_lists();
+    // patterns and the brightness ramp follow real time, so they run at the same speed
+    // whatever the frame rate; under load the patterns are re-rendered less often instead
+    anim_clock_t clock;
+    anim_phase_t phase[2] = {0};
+    anim_phase_t brightness_phase = {0};
+    int pat[2];
+    uint layer = 0;
+    uint current = 0;
+    uint t[2] = {0, 0};
+    led_transition_t transition = {0};
+    bool transitioning = false;
+
+    anim_clock_init(&clock, FRAME_BUDGET_US);
+    anim_phase_set_rate(&brightness_phase, BRIGHTNESS_RATE);
+    transition_kind_t kind;
+    // change clk_sys first: scenes_init() starts a DMA read that a clock change would cut off mid-transfer
+    select_sys_clock();
+    scenes_init();
+    pat[layer] = choose_pattern(&phase[layer], &kind);
+    uint64_t pattern_start = clock.now_us;
     while (1) {
-        int pat = rand() % count_of(pattern_table);
-        int dir = (rand() >> 30) & 1 ? 1 : -1;
-        if (rand() & 1) dir = 0;
-        puts(pattern_table[pat].name);
-        puts(dir == 1 ? "(forward)" : dir ? "(backward)" : "(still)");
-        int brightness = 0;
-        uint current = 0;
-        for (int i = 0; i < 1000; ++i) {
-            current_strip_out = strip0.data;
-            current_strip_4color = false;
-            pattern_table[pat].pat(NUM_PIXELS, t);
-            current_strip_out = strip1.data;
-            current_strip_4color = true;
-            pattern_table[pat].pat(NUM_PIXELS, t);
-
-            transform_strips(strips, count_of(strips), colors, NUM_PIXELS * 4, brightness);
-            dither_values(colors, states[current], states[current ^ 1], NUM_PIXELS * 4);
-            sem_acquire_blocking(&reset_delay_complete_sem);
-            output_strips_dma(states[current], NUM_PIXELS * 4);
-
-            current ^= 1;
-            t += dir;
-            brightness++;
-            if (brightness == (0x20 << FRAC_BITS)) brightness = 0;
+        uint32_t dt = anim_clock_tick(&clock);
+        // keeps the background scene read moving; it is DMA driven so costs almost nothing
+        scene_bank_poll();
+        uint32_t work_start = time_us_32();
+        uint next = layer ^ 1;
+        uint elapsed_ms = (uint) ((clock.now_us - pattern_start) / 1000);
+
+        if (!transitioning && elapsed_ms >= PATTERN_MS - TRANSITION_MS) {
+            // start rendering the next pattern alongside the current one
+            pat[next] = choose_pattern(&phase[next], &kind);
+            transition_start(&transition, kind, TRANSITION_MS);
+            transitioning = true;
+        }
+        if (transitioning && elapsed_ms >= PATTERN_MS) {
+            // the next pattern becomes the current one
+            transitioning = false;
+            layer = next;
+            next = layer ^ 1;
+            pattern_start = clock.now_us;
+            log_idle();
+        }
+
+        // phases always advance, even on frames where nothing is re-rendered
+        t[layer] = anim_phase_advance(&phase[layer], dt);
+        if (transitioning) {
+            t[next] = anim_phase_advance(&phase[next], dt);
+            transition_seek(&transition, elapsed_ms - (PATTERN_MS - TRANSITION_MS));
         }
-        memset(&states, 0, sizeof(states)); // clear out errors
+
+        if (anim_clock_render_due(&clock)) {
+            render_pattern(pat[layer], layer, t[layer]);
+            if (transitioning) {
+                render_pattern(pat[next], next, t[next]);
+                transition_render(&transition, strip0_data, strip0_layers[layer], strip0_layers[next],
+                                  sizeof(strip0_data), 3);
+                transition_render(&transition, strip1_data, strip1_layers[layer], strip1_layers[next],
+                                  sizeof(strip1_data), 4);
+                strip0.data = strip0_data;
+                strip1.data = strip1_data;
+            } else {
+                strip0.data = strip0_layers[layer];
+                strip1.data = strip1_layers[layer];
+            }
+        }
+
+        uint brightness = anim_phase_advance(&brightness_phase, dt) % (0x20 << FRAC_BITS);
+        transform_strips(strips, count_of(strips), colors, NUM_PIXELS * 4, brightness);
+        // dither error carries over between patterns, so a switch doesn't jump
+        dither_values(colors, states[current], states[current ^ 1], NUM_PIXELS * 4);
+        anim_clock_report_load(&clock, time_us_32() - work_start);
+
+        // one record per frame: it fits in the UART FIFO, so the drain never blocks the frame
+        dlog_drain(1);
+        idle_wait_sem(&reset_delay_complete_sem);
+        output_strips_dma(current, NUM_PIXELS * 4);
+        current ^= 1;
     }
 
     // This will free resources and unload our program
@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2020 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ws2812_patterns.h"
+#include "anim_clock.h"
+#include "fixmath.h"
+#include "pixel_kernels.h"
+
+// set by pattern_render(), so the patterns keep the shape of the ws2812.c ones
+static uint8_t *current_strip_out;
+static bool current_strip_4color;
+
+static inline void put_pixel(uint32_t pixel_grb) {
+    *current_strip_out++ = (pixel_grb >> 16u) & 0xffu;
+    *current_strip_out++ = (pixel_grb >> 8u) & 0xffu;
+    *current_strip_out++ = pixel_grb & 0xffu;
+    if (current_strip_4color) {
+        *current_strip_out++ = 0;  // todo adjust?
+    }
+}
+
+static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b) {
+    return 
+            ((uint32_t) (r) << 8) |
+            ((uint32_t) (g) << 16) |
+            (uint32_t) (b);
+}
+
+void pattern_snakes(uint len, uint t) {
+    for (uint i = 0; i < len; ++i) {
+        uint x = (i + (t >> 1)) % 64;
+        if (x < 10)
+            put_pixel(urgb_u32(0xff, 0, 0));
+        else if (x >= 15 && x < 25)
+            put_pixel(urgb_u32(0, 0xff, 0));
+        else if (x >= 30 && x < 40)
+            put_pixel(urgb_u32(0, 0, 0xff));
+        else
+            put_pixel(0);
+    }
+}
+
+// new data every 8 t units; hashing t rather than calling rand() gives the same
+// result however many times (or strips) a step is rendered
+void pattern_random(uint len, uint t) {
+    uint32_t seed = anim_hash(t >> 3);
+    for (uint i = 0; i < len; ++i)
+        put_pixel(anim_hash(seed + i));
+}
+
+void pattern_sparkle(uint len, uint t) {
+    uint32_t seed = anim_hash(t >> 3);
+    for (uint i = 0; i < len; ++i)
+        put_pixel(anim_hash(seed + i) % 16 ? 0 : 0xffffffff);
+}
+
+void pattern_greys(uint len, uint t) {
+    uint max = 100; // let's not draw too much current!
+    t %= max;
+    for (uint i = 0; i < len; ++i) {
+        put_pixel(t * 0x10101);
+        if (++t >= max) t = 0;
+    }
+}
+
+// three sine waves with different spatial and temporal frequencies, one per colour;
+// the blue phase is modulated by the red wave. fixed point (fixmath.h), no sinf per pixel
+void pattern_plasma(uint len, uint t) {
+    for (uint i = 0; i < len; ++i) {
+        uint16_t a = (uint16_t) (i * 2048 + t * 97);
+        uint16_t b = (uint16_t) (i * 1280 - t * 151);
+        uint16_t c = (uint16_t) (i * 3072 + t * 61 + (fx_sin(a) >> 3));
+        put_pixel(urgb_u32(fx_wave8(a) >> 1, fx_wave8(b) >> 1, fx_wave8(c) >> 1));
+    }
+}
+
+// 2D noise with x along the strip (8 pixels per lattice cell) and y following t, so the
+// blobs drift and change shape; red/green and blue read rows 64 cells apart
+void pattern_noise(uint len, uint t) {
+    fx16_t rg[16], b[16];
+    uint32_t y = t << 9;
+    for (uint i = 0; i < len; i += count_of(rg)) {
+        uint n = MIN(len - i, count_of(rg));
+        fx_noise2_span(rg, n, i << 13, 1u << 13, y);
+        fx_noise2_span(b, n, i << 13, 1u << 13, y + (64u << 16));
+        for (uint j = 0; j < n; ++j) {
+            uint v = fx_noise_u8(rg[j]);
+            uint w = fx_noise_u8(b[j]);
+            // squaring darkens the middle of the range so the peaks stand out as blobs
+            v = v * v >> 9;
+            w = w * w >> 9;
+            put_pixel(urgb_u32(v, v >> 2, w));
+        }
+    }
+}
+
+void pattern_solid(uint len, uint t) {
+    t = 1;
+    for (uint i = 0; i < len; ++i) {
+        put_pixel(t * 0x10101);
+    }
+}
+
+void pattern_fade(uint len, uint t) {
+    uint shift = 4;
+
+    uint max = 16; // let's not draw too much current!
+    max <<= shift;
+
+    uint slow_t = t / 32;
+    slow_t %= max;
+
+    static int error = 0;
+    slow_t += error;
+    error = slow_t & ((1u << shift) - 1);
+    slow_t >>= shift;
+    slow_t *= 0x010101;
+
+    for (uint i = 0; i < len; ++i) {
+        put_pixel(slow_t);
+    }
+}
+
+const pattern_entry_t pattern_table[PATTERN_COUNT] = {
+        {pattern_snakes,  "Snakes!"},
+        {pattern_random,  "Random data"},
+        {pattern_sparkle, "Sparkles"},
+        {pattern_greys,   "Greys"},
+        {pattern_plasma,  "Plasma"},
+        {pattern_noise,   "Noise"},
+//        {pattern_solid,  "Solid!"},
+//        {pattern_fade, "Fade"},
+};
+
+void pattern_render(int pat, uint8_t *out, bool four_color, uint len, uint t) {
+    current_strip_out = out;
+    current_strip_4color = four_color;
+    pattern_table[pat].pat(len, t);
+}
+
+// per strip brightness applied 4 bytes at a time (strip data is word aligned)
+static uint32_t scaled_data[MAX_STRIPS][NUM_PIXELS];
+
+// takes 8 bit color values, multiply by brightness and store in bit planes
+void transform_strips(strip_t **strips, uint num_strips, value_bits_t *values, uint value_length,
+                       uint frac_brightness) {
+    hard_assert(num_strips <= MAX_STRIPS);
+    for (uint i = 0; i < num_strips; i++) {
+        const uint32_t *src = (const uint32_t *) strips[i]->data;
+        uint words = MIN((strips[i]->data_len + 3) / 4, NUM_PIXELS);
+        uint scale = strips[i]->frac_brightness;
+        if (scale <= 0x100) {
+            pk_scale_buffer(scaled_data[i], src, words, scale);
+        } else {
+            // brighter than 1.0 saturates at 255 (gain is 1/64 units)
+            for (uint w = 0; w < words; w++) scaled_data[i][w] = pk_gain(src[w], MIN(scale >> 2, 0x100));
+        }
+    }
+    for (uint v = 0; v < value_length; v++) {
+        uint32_t value[MAX_STRIPS];
+        for (uint i = 0; i < num_strips; i++) {
+            value[i] = 0;
+            if (v < strips[i]->data_len) {
+                value[i] = (((const uint8_t *) scaled_data[i])[v] * frac_brightness) >> 8u;
+            }
+        }
+        // bit plane transpose, see ws2812_planes.h (uses zip on the RISC-V cores)
+        if (num_strips == 2) {
+            planes_from_values2(&values[v], value[0], value[1]);
+        } else {
+            planes_from_values(&values[v], value, num_strips);
+        }
+    }
+}
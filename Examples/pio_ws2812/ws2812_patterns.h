@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2020 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// test patterns and the brightness / bit plane transform of ws2812_parallel, kept
+// apart from the DMA output so pio_ws2812_bench can time them on their own
+#pragma once
+
+#include "pico/stdlib.h"
+#include "ws2812_planes.h"
+
+#ifndef NUM_PIXELS
+#define NUM_PIXELS 64
+#endif
+#define MAX_STRIPS 2
+#define PATTERN_COUNT 6
+
+typedef void (*pattern)(uint len, uint t);
+
+typedef struct {
+    pattern pat;
+    const char *name;
+} pattern_entry_t;
+
+extern const pattern_entry_t pattern_table[PATTERN_COUNT];
+
+typedef struct {
+    uint8_t *data;
+    uint data_len;
+    uint frac_brightness; // 256 = *1.0;
+} strip_t;
+
+// render pattern pat as len pixels of 3 (or 4 if four_color) bytes into out
+void pattern_render(int pat, uint8_t *out, bool four_color, uint len, uint t);
+
+// takes 8 bit color values, multiply by brightness and store in bit planes
+void transform_strips(strip_t **strips, uint num_strips, value_bits_t *values, uint value_length,
+                       uint frac_brightness);
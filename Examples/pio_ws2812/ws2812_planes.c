@@ -0,0 +1,111 @@
+/*!
+  \brief ws2812_parallel 的 bit plane 運算
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <string.h>
+
+#include "ws2812_planes.h"
+
+#if WS2812_PLANES_RISCV_BITMANIP
+
+//! Zbkb zip：低 16 bits 放偶數位元，高 16 bits 放奇數位元
+static inline uint32_t bits_zip(uint32_t x)
+{
+    uint32_t r;
+    __asm__ ("zip %0, %1" : "=r" (r) : "r" (x));
+    return r;
+}
+
+//! Zbs bext：取出第 n 個 bit
+static inline uint32_t bit_extract(uint32_t x, uint32_t n)
+{
+    uint32_t r;
+    __asm__ ("bext %0, %1, %2" : "=r" (r) : "r" (x), "r" (n));
+    return r;
+}
+
+#else
+
+//! 跟 zip 相同的結果：每個 bit 之間插入一個 0，再把高半部的放到奇數位元
+static inline uint32_t bits_zip(uint32_t x)
+{
+    uint32_t lo = x & 0xffffu, hi = x >> 16;
+    lo = (lo | (lo << 8)) & 0x00ff00ffu;
+    lo = (lo | (lo << 4)) & 0x0f0f0f0fu;
+    lo = (lo | (lo << 2)) & 0x33333333u;
+    lo = (lo | (lo << 1)) & 0x55555555u;
+    hi = (hi | (hi << 8)) & 0x00ff00ffu;
+    hi = (hi | (hi << 4)) & 0x0f0f0f0fu;
+    hi = (hi | (hi << 2)) & 0x33333333u;
+    hi = (hi | (hi << 1)) & 0x55555555u;
+    return lo | (hi << 1);
+}
+
+static inline uint32_t bit_extract(uint32_t x, uint32_t n)
+{
+    return (x >> n) & 1u;
+}
+
+#endif
+
+const char *planes_arch_name(void)
+{
+#if WS2812_PLANES_RISCV_BITMANIP
+    return "RISC-V Zbkb/Zbs";
+#elif defined(__riscv)
+    return "RISC-V";
+#elif defined(__ARM_ARCH_8M_MAIN__)
+    return "Arm Cortex-M33";
+#elif defined(__ARM_ARCH_6M__)
+    return "Arm Cortex-M0+";
+#else
+    return "host";
+#endif
+}
+
+void add_error(value_bits_t *d, const value_bits_t *s, const value_bits_t *e)
+{
+    uint32_t carry_plane = 0;
+    // add the FRAC_BITS low planes
+    for (int p = VALUE_PLANE_COUNT - 1; p >= 8; p--) {
+        uint32_t e_plane = e->planes[p];
+        uint32_t s_plane = s->planes[p];
+        d->planes[p] = (e_plane ^ s_plane) ^ carry_plane;
+        carry_plane = (e_plane & s_plane) | (carry_plane & (s_plane ^ e_plane));
+    }
+    // then just ripple carry through the non fractional bits
+    for (int p = 7; p >= 0; p--) {
+        uint32_t s_plane = s->planes[p];
+        d->planes[p] = s_plane ^ carry_plane;
+        carry_plane &= s_plane;
+    }
+}
+
+void dither_values(const value_bits_t *colors, value_bits_t *state, const value_bits_t *old_state,
+                   uint32_t value_length)
+{
+    for (uint32_t i = 0; i < value_length; i++) {
+        add_error(state + i, colors + i, old_state + i);
+    }
+}
+
+void planes_from_values(value_bits_t *out, const uint32_t *values, uint32_t num_strips)
+{
+    memset(out, 0, sizeof(*out));
+    for (uint32_t i = 0; i < num_strips; i++) {
+        uint32_t value = values[i];
+        for (int j = 0; j < VALUE_PLANE_COUNT && value >> j; j++) {
+            out->planes[VALUE_PLANE_COUNT - 1 - j] |= bit_extract(value, j) << i;
+        }
+    }
+}
+
+void planes_from_values2(value_bits_t *out, uint32_t value0, uint32_t value1)
+{
+    // bit j of value0 -> bit 2j, bit j of value1 -> bit 2j + 1
+    uint32_t z = bits_zip((value0 & 0xffffu) | (value1 << 16));
+    for (int j = 0; j < VALUE_PLANE_COUNT; j++) {
+        out->planes[VALUE_PLANE_COUNT - 1 - j] = (z >> (2 * j)) & 3u;
+    }
+}
@@ -0,0 +1,53 @@
+/*!
+  \brief ws2812_parallel 的 bit plane 運算 (從 ws2812_parallel.c 抽出)
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  每個顏色值 (8 bits 整數 + FRAC_BITS bits 小數) 拆成 VALUE_PLANE_COUNT 個 bit plane，
+  plane N 的 bit i 是第 i 條燈的第 N 個 bit，PIO 一次送出一個 plane 就同時驅動所有燈。
+
+  RP2350 的 Hazard3 RISC-V 核心有 Zbb/Zbs/Zbkb 位元運算擴充，用在轉置 (值 -> plane)：
+  - 兩條燈：兩個值放進一個 word 的高低半部，一個 zip 指令就交錯成 2 bits 一組，
+    每個 plane 只要一次 shift + mask
+  - 任意條燈：bext 取出一個 bit，省掉 shift + and
+  其他平台 (RP2040、RP2350 Arm) 用一般 C 寫法，結果完全相同。
+
+  不依賴 Pico SDK，可以直接在電腦上編譯。
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define FRAC_BITS 4     //<! 小數位元數，只在這裡定義 (dither 與亮度都用這個值)
+#define VALUE_PLANE_COUNT (8 + FRAC_BITS)
+
+#if defined(__riscv_zbkb) && defined(__riscv_zbs)
+#define WS2812_PLANES_RISCV_BITMANIP 1
+#else
+#define WS2812_PLANES_RISCV_BITMANIP 0
+#endif
+
+// we store value (8 bits + fractional bits of a single color (R/G/B/W) value) for multiple
+// strips of pixels, in bit planes. bit plane N has the Nth bit of each strip of pixels.
+typedef struct {
+    // stored MSB first
+    uint32_t planes[VALUE_PLANE_COUNT];
+} value_bits_t;
+
+//! Add FRAC_BITS planes of e to s and store in d
+void add_error(value_bits_t *d, const value_bits_t *s, const value_bits_t *e);
+
+//! d[i] = s[i] + e[i] (fractional planes only), for value_length values
+void dither_values(const value_bits_t *colors, value_bits_t *state, const value_bits_t *old_state,
+                   uint32_t value_length);
+
+/*! 把 num_strips 個值 (每個最多 VALUE_PLANE_COUNT bits) 轉成 bit planes
+  \param values 第 i 個是第 i 條燈的值
+ */
+void planes_from_values(value_bits_t *out, const uint32_t *values, uint32_t num_strips);
+
+//! 兩條燈的特化版本 (RISC-V 上用 zip)
+void planes_from_values2(value_bits_t *out, uint32_t value0, uint32_t value1);
+
+//! 平台名稱，給效能測試印出來
+const char *planes_arch_name(void);
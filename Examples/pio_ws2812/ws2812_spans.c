@@ -0,0 +1,139 @@
+/*!
+  \brief WS2812 區段 (span) 輸出
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include "pico/stdlib.h"
+#include "pico/sem.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include "ws2812_spans.h"
+
+static PIO span_pio;
+static uint span_sm;
+static uint span_chan;      //<! 送像素到 PIO 的通道
+static uint span_cb_chan;   //<! 載入 control block 的通道
+static uint32_t ctrl_solid; //<! 讀取位址不遞增
+static uint32_t ctrl_pixels;//<! 讀取位址遞增
+
+// 畫面送完後要等 reset 時間才能送下一個，和 ws2812_parallel.c 相同的作法
+static struct semaphore reset_delay_complete_sem;
+static alarm_id_t reset_delay_alarm_id;
+
+static int64_t reset_delay_complete(__unused alarm_id_t id, __unused void *user_data)
+{
+    reset_delay_alarm_id = 0;
+    sem_release(&reset_delay_complete_sem);
+    return 0;
+}
+
+static void __isr span_dma_handler(void)
+{
+    uint mask = 1u << span_chan;
+    if (dma_hw->ints0 & mask) {
+        dma_hw->ints0 = mask;
+        // NULL 觸發表示整串 control block 都做完了
+        if (reset_delay_alarm_id) cancel_alarm(reset_delay_alarm_id);
+        reset_delay_alarm_id = add_alarm_in_us(400, reset_delay_complete, NULL, true);
+    }
+}
+
+void ws2812_spans_init(PIO pio, uint sm)
+{
+    span_pio = pio;
+    span_sm = sm;
+    span_chan = dma_claim_unused_channel(true);
+    span_cb_chan = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(span_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+    channel_config_set_chain_to(&c, span_cb_chan);
+    channel_config_set_irq_quiet(&c, true);
+    ctrl_pixels = channel_config_get_ctrl_value(&c);
+    channel_config_set_read_increment(&c, false);
+    ctrl_solid = channel_config_get_ctrl_value(&c);
+
+    // 每次搬一個 control block (4 words) 到 span_chan 的 alias 3
+    dma_channel_config cc = dma_channel_get_default_config(span_cb_chan);
+    channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+    channel_config_set_read_increment(&cc, true);
+    channel_config_set_write_increment(&cc, true);
+    channel_config_set_ring(&cc, true, 4);
+    dma_channel_configure(span_cb_chan, &cc,
+                          &dma_channel_hw_addr(span_chan)->al3_ctrl,
+                          NULL,
+                          4,
+                          false);
+
+    irq_add_shared_handler(DMA_IRQ_0, span_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    dma_channel_set_irq0_enabled(span_chan, true);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    sem_init(&reset_delay_complete_sem, 1, 1); // initially posted so we don't block first time
+}
+
+void ws2812_spans_begin(ws2812_span_list_t *list)
+{
+    list->count = 0;
+    list->pixels = 0;
+}
+
+bool ws2812_spans_solid(ws2812_span_list_t *list, uint32_t color, uint length)
+{
+    if (!length) return true;
+
+    uint n = list->count;
+    if (n && list->cb[n - 1].ctrl == ctrl_solid && list->color[n - 1] == color) {
+        list->cb[n - 1].trans_count += length;
+        list->pixels += length;
+        return true;
+    }
+    if (n >= WS2812_MAX_SPANS) return false;
+
+    list->color[n] = color;
+    list->cb[n] = (ws2812_span_cb_t) {
+        ctrl_solid, (uintptr_t) &span_pio->txf[span_sm], length, (uintptr_t) &list->color[n]
+    };
+    list->count = n + 1;
+    list->pixels += length;
+    return true;
+}
+
+bool ws2812_spans_pixels(ws2812_span_list_t *list, const uint32_t *pixels, uint length)
+{
+    if (!length) return true;
+
+    uint n = list->count;
+    if (n >= WS2812_MAX_SPANS) return false;
+
+    list->cb[n] = (ws2812_span_cb_t) {
+        ctrl_pixels, (uintptr_t) &span_pio->txf[span_sm], length, (uintptr_t) pixels
+    };
+    list->count = n + 1;
+    list->pixels += length;
+    return true;
+}
+
+void ws2812_spans_wait(void)
+{
+    sem_acquire_blocking(&reset_delay_complete_sem);
+    sem_release(&reset_delay_complete_sem);
+}
+
+void ws2812_spans_output(ws2812_span_list_t *list)
+{
+    sem_acquire_blocking(&reset_delay_complete_sem);
+
+    if (!list->count) {
+        sem_release(&reset_delay_complete_sem);
+        return;
+    }
+
+    // 結尾：ctrl 保留 IRQ_QUIET，READ_ADDR_TRIG 寫 0 就是 NULL 觸發
+    list->cb[list->count] = (ws2812_span_cb_t) {ctrl_pixels, 0, 0, 0};
+    dma_channel_set_read_addr(span_cb_chan, list->cb, true);
+}
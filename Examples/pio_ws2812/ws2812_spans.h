@@ -0,0 +1,63 @@
+/*!
+  \brief WS2812 區段 (span) 輸出：單色區段不展開成像素
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  一個畫面描述成一串 span：
+  - 單色 span (顏色, 長度)：一個 DMA control block，讀取位址不遞增，
+    同一個 word 重複送 length 次到 PIO FIFO
+  - 像素 span：內容不規則的部分，指向一般的像素陣列 (讀取位址遞增)
+
+  像 pattern_snakes 這種大部分是單色長條的畫面，記憶體和運算量都只跟 span 數有關，
+  跟燈的數量無關。control block 鏈和 ws2812_parallel.c 一樣由第二個 DMA 通道載入。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#define WS2812_MAX_SPANS 64 //<! 每個畫面最多幾個 span
+
+//! DMA control block，對應 alias 3 的 CTRL, WRITE_ADDR, TRANS_COUNT, READ_ADDR_TRIG
+typedef struct {
+    uint32_t ctrl;
+    uint32_t write_addr;
+    uint32_t trans_count;
+    uint32_t read_addr;
+} ws2812_span_cb_t;
+
+//! 一個畫面的 span 清單
+typedef struct {
+    //! +1 給結尾的 NULL 觸發；control 通道的 write ring 需要 16 bytes 對齊
+    ws2812_span_cb_t cb[WS2812_MAX_SPANS + 1] __attribute__((aligned(16)));
+    uint32_t color[WS2812_MAX_SPANS];   //<! 單色 span 的顏色 (線上格式)
+    uint count;                         //<! span 數量
+    uint pixels;                        //<! 總像素數
+} ws2812_span_list_t;
+
+/*! 取得兩個 DMA 通道並安裝中斷 (DMA_IRQ_0)
+  \param pio/sm 已經用 ws2812_program_init() 設定好的狀態機
+ */
+void ws2812_spans_init(PIO pio, uint sm);
+
+//! 清空 span 清單
+void ws2812_spans_begin(ws2812_span_list_t *list);
+
+/*! 加入單色 span，跟前一個 span 同色時直接合併
+  \param color 線上格式 (GRB << 8)
+  \return 清單已滿時回傳 false
+ */
+bool ws2812_spans_solid(ws2812_span_list_t *list, uint32_t color, uint length);
+
+/*! 加入像素 span (內容不規則時的備援)
+  \param pixels 線上格式，輸出完成前不能修改
+ */
+bool ws2812_spans_pixels(ws2812_span_list_t *list, const uint32_t *pixels, uint length);
+
+/*! 送出 span 清單
+  \note 會先等上一個畫面送完並經過 reset 時間，送出期間 list 不能修改
+ */
+void ws2812_spans_output(ws2812_span_list_t *list);
+
+//! 等待目前的畫面送完 (含 reset 時間)
+void ws2812_spans_wait(void);
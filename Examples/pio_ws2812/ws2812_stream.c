@@ -0,0 +1,158 @@
+/*!
+  \brief WS2812 即時 (just-in-time) 輸出
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+ */
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include "ws2812_stream.h"
+
+static uint32_t ring[WS2812_STREAM_CHUNKS][WS2812_STREAM_CHUNK_PIXELS];
+
+static PIO stream_pio;
+static uint stream_sm;
+static uint stream_chan[2];     //<! chunk i 由 stream_chan[i & 1] 負責
+
+static ws2812_render_fn stream_render;
+static void *stream_ctx;
+static uint stream_pixels;
+static uint stream_total;       //<! 這個畫面的 chunk 數
+
+static volatile uint stream_rendered;   //<! 已經 render 好的 chunk 數
+static volatile uint stream_consumed;   //<! DMA 已經送完的 chunk 數
+
+static ws2812_stream_stats_t stats;
+
+static inline uint chunk_pixels(uint chunk)
+{
+    uint first = chunk * WS2812_STREAM_CHUNK_PIXELS;
+    return MIN(WS2812_STREAM_CHUNK_PIXELS, stream_pixels - first);
+}
+
+/*! 把 chunk 指派給它的通道 (不觸發)
+  \note 最後一個 chunk 的通道 chain 到自己，也就是不再 chain
+ */
+static void setup_chunk(uint chunk)
+{
+    uint ch = stream_chan[chunk & 1];
+    bool last = chunk + 1 >= stream_total;
+
+    dma_channel_config c = dma_channel_get_default_config(ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(stream_pio, stream_sm, true));
+    channel_config_set_chain_to(&c, last ? ch : stream_chan[(chunk + 1) & 1]);
+    dma_channel_configure(ch, &c, &stream_pio->txf[stream_sm],
+                          ring[chunk % WS2812_STREAM_CHUNKS], chunk_pixels(chunk), false);
+}
+
+static void __isr stream_dma_handler(void)
+{
+    for (uint k = 0; k < 2; k++) {
+        uint mask = 1u << stream_chan[k];
+        if (!(dma_hw->ints0 & mask)) continue;
+        dma_hw->ints0 = mask;
+
+        // 剛送完的 chunk
+        uint done = stream_consumed;
+        stream_consumed = done + 1;
+        stats.chunks++;
+
+        // 下一個 chunk 已經被 chain 啟動了，看看它當時準備好了沒
+        uint running = done + 1;
+        if (running < stream_total) {
+            int32_t slack = (int32_t) stream_rendered - (int32_t) running - 1;
+            if (slack < 0) stats.underruns++;
+            if (slack < stats.min_slack) stats.min_slack = slack;
+        }
+
+        // 空出來的通道接手再下一個 chunk
+        if (done + 2 < stream_total) {
+            setup_chunk(done + 2);
+        }
+
+        if (stream_consumed == stream_total) {
+            stats.frames++;
+        }
+    }
+}
+
+void ws2812_stream_init(PIO pio, uint sm)
+{
+    stream_pio = pio;
+    stream_sm = sm;
+    stream_chan[0] = dma_claim_unused_channel(true);
+    stream_chan[1] = dma_claim_unused_channel(true);
+
+    irq_add_shared_handler(DMA_IRQ_0, stream_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    dma_channel_set_irq0_enabled(stream_chan[0], true);
+    dma_channel_set_irq0_enabled(stream_chan[1], true);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    ws2812_stream_get_stats(NULL, true);
+}
+
+static void render_chunk(uint chunk)
+{
+    uint64_t t0 = time_us_64();
+    stream_render(ring[chunk % WS2812_STREAM_CHUNKS], chunk * WS2812_STREAM_CHUNK_PIXELS,
+                  chunk_pixels(chunk), stream_ctx);
+    uint32_t us = (uint32_t) (time_us_64() - t0);
+    if (us > stats.render_us_max) stats.render_us_max = us;
+    stream_rendered++;
+}
+
+void ws2812_stream_start(uint num_pixels, ws2812_render_fn render, void *ctx)
+{
+    while (!ws2812_stream_done()) {
+        tight_loop_contents();
+    }
+
+    stream_render = render;
+    stream_ctx = ctx;
+    stream_pixels = num_pixels;
+    stream_total = (num_pixels + WS2812_STREAM_CHUNK_PIXELS - 1) / WS2812_STREAM_CHUNK_PIXELS;
+    stream_rendered = 0;
+    stream_consumed = 0;
+    if (stream_total == 0) return;
+
+    // 先把環狀緩衝區填滿
+    while (stream_rendered < stream_total && stream_rendered < WS2812_STREAM_CHUNKS) {
+        render_chunk(stream_rendered);
+    }
+
+    setup_chunk(0);
+    if (stream_total > 1) setup_chunk(1);
+    dma_channel_start(stream_chan[0]);
+}
+
+bool ws2812_stream_poll(void)
+{
+    // chunk r 的格子要等 chunk r - CHUNKS 送完才能覆寫
+    while (stream_rendered < stream_total &&
+           stream_rendered < stream_consumed + WS2812_STREAM_CHUNKS) {
+        render_chunk(stream_rendered);
+    }
+    return stream_rendered == stream_total;
+}
+
+bool ws2812_stream_done(void)
+{
+    return stream_consumed == stream_total;
+}
+
+void ws2812_stream_get_stats(ws2812_stream_stats_t *out, bool reset)
+{
+    uint32_t save = save_and_disable_interrupts();
+    if (out) *out = stats;
+    if (reset) {
+        memset(&stats, 0, sizeof(stats));
+        stats.min_slack = WS2812_STREAM_CHUNKS;
+    }
+    restore_interrupts(save);
+}
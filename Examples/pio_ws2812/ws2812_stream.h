@@ -0,0 +1,55 @@
+/*!
+  \brief WS2812 即時 (just-in-time) 輸出：不需要整個畫面的緩衝區
+  \author kalvinchiang@gmail.com
+  \date 2026-10-18
+
+  畫面被切成固定大小的 chunk，放在一個只有 WS2812_STREAM_CHUNKS 格的環狀緩衝區。
+  兩個 DMA 通道輪流送 chunk (互相 chain，硬體不用等 CPU)，每送完一個 chunk
+  就發出中斷，中斷裡把剛空出來的通道設定成「再下一個 chunk」。
+  主迴圈呼叫 ws2812_stream_poll()，只要環狀緩衝區有空位就呼叫 render 函式補上。
+
+  像素數量因此只受線上傳輸時間限制 (每顆 30 us)，不受 SRAM 限制。
+  如果 render 來不及，DMA 會送出舊資料，這時記錄一次 underrun。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#define WS2812_STREAM_CHUNK_PIXELS  32  //<! 每個 chunk 的像素數
+#define WS2812_STREAM_CHUNKS        4   //<! 環狀緩衝區的 chunk 數
+
+/*! 產生像素的函式
+  \param out 輸出位置，線上格式 (GRB << 8)
+  \param first 第一個像素在燈條上的位置
+  \param count 像素數量
+ */
+typedef void (*ws2812_render_fn)(uint32_t *out, uint first, uint count, void *ctx);
+
+//! 統計資料
+typedef struct {
+    uint32_t frames;        //<! 送完的畫面數
+    uint32_t chunks;        //<! 送完的 chunk 數
+    uint32_t underruns;     //<! 開始送出時還沒 render 好的 chunk 數
+    int32_t min_slack;      //<! 最少領先 DMA 幾個 chunk (負數表示曾經落後)
+    uint32_t render_us_max; //<! 單一 chunk 最長 render 時間
+} ws2812_stream_stats_t;
+
+/*! 取得兩個 DMA 通道並安裝中斷 (DMA_IRQ_0，shared handler)
+  \param pio/sm 已經用 ws2812_program_init() 設定好的狀態機 (RGB，24 bits)
+ */
+void ws2812_stream_init(PIO pio, uint sm);
+
+/*! 開始送出一個畫面
+  \note 會先把環狀緩衝區填滿才啟動 DMA，然後立即返回
+ */
+void ws2812_stream_start(uint num_pixels, ws2812_render_fn render, void *ctx);
+
+//! 有空位就 render，回傳 true 表示這個畫面的所有 chunk 都已經 render 完
+bool ws2812_stream_poll(void);
+
+//! 這個畫面是否已經全部送出
+bool ws2812_stream_done(void);
+
+//! 讀取統計資料，reset 為 true 時歸零
+void ws2812_stream_get_stats(ws2812_stream_stats_t *stats, bool reset);